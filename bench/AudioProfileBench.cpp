@@ -0,0 +1,227 @@
+// Encodes sentence-length clips with every audio encoder profile and reports time and size
+//
+// Usage: audio_profile_bench [--iterations N] [--clip video start end ...]
+// Without clips, synthetic speech-like signals of 3 and 8 seconds are used. Clips from a video go through
+// the extraction session with stream copy disabled, so their time includes seeking and decoding.
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/audio_fifo.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/frame.h>
+#include <libswresample/swresample.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "audio/AudioClipEncoder.h"
+#include "audio/AudioExtractionSession.h"
+
+using Video2Card::Audio::AudioClipEncoder;
+using Video2Card::Audio::AudioClipOptions;
+using Video2Card::Audio::AudioEncoderProfile;
+using Video2Card::Audio::AudioExtractionSession;
+
+namespace
+{
+  constexpr int SOURCE_RATE = 48000;
+  constexpr int SOURCE_CHANNELS = 2;
+
+  struct VideoClip
+  {
+    std::string path;
+    double start = 0.0;
+    double end = 0.0;
+  };
+
+  // Voiced syllables with a gliding pitch and harmonics, separated by short noise bursts and pauses
+  std::vector<float> MakeSyntheticSpeech(double seconds, unsigned int seed)
+  {
+    const size_t frames = (size_t) (seconds * SOURCE_RATE);
+    std::vector<float> samples(frames * SOURCE_CHANNELS);
+
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    double phase = 0.0;
+
+    for (size_t i = 0; i < frames; ++i) {
+      double t = (double) i / SOURCE_RATE;
+      double syllable = std::fmod(t * 4.0, 1.0);
+      double pitch = 140.0 + 40.0 * std::sin(t * 1.7) + 20.0 * syllable;
+      phase += 2.0 * std::numbers::pi * pitch / SOURCE_RATE;
+
+      float voiced = 0.0f;
+      for (int harmonic = 1; harmonic <= 12; ++harmonic) {
+        voiced += (float) (std::sin(phase * harmonic) / (harmonic * harmonic * 0.5 + 0.5));
+      }
+
+      float value = 0.0f;
+      if (syllable < 0.6) {
+        value = 0.25f * voiced * (float) std::sin(std::numbers::pi * syllable / 0.6);
+      } else if (syllable < 0.75) {
+        value = 0.05f * noise(rng);
+      }
+
+      samples[i * SOURCE_CHANNELS] = value;
+      samples[i * SOURCE_CHANNELS + 1] = value * 0.9f;
+    }
+    return samples;
+  }
+
+  // Resamples to the encoder's format and feeds it the way the extraction session does
+  size_t EncodeSamples(AudioClipEncoder& encoder, const AudioEncoderProfile& profile, const std::vector<float>& samples)
+  {
+    if (!encoder.Begin(profile))
+      return 0;
+
+    const AVCodecContext* context = encoder.GetCodecContext();
+    const int frameSize = encoder.GetFrameSize();
+
+    AVChannelLayout sourceLayout;
+    av_channel_layout_default(&sourceLayout, SOURCE_CHANNELS);
+    SwrContext* resampler = nullptr;
+    swr_alloc_set_opts2(&resampler,
+                        &context->ch_layout,
+                        context->sample_fmt,
+                        context->sample_rate,
+                        &sourceLayout,
+                        AV_SAMPLE_FMT_FLT,
+                        SOURCE_RATE,
+                        0,
+                        nullptr);
+    swr_init(resampler);
+
+    const int inputSamples = (int) (samples.size() / SOURCE_CHANNELS);
+    const int outputCapacity = swr_get_out_samples(resampler, inputSamples);
+
+    AVAudioFifo* fifo = av_audio_fifo_alloc(context->sample_fmt, context->ch_layout.nb_channels, outputCapacity);
+    AVFrame* converted = av_frame_alloc();
+    converted->format = context->sample_fmt;
+    converted->nb_samples = outputCapacity;
+    av_channel_layout_copy(&converted->ch_layout, &context->ch_layout);
+    av_frame_get_buffer(converted, 0);
+
+    const uint8_t* input[] = {reinterpret_cast<const uint8_t*>(samples.data())};
+    int count = swr_convert(resampler, converted->data, outputCapacity, input, inputSamples);
+    if (count > 0) {
+      av_audio_fifo_write(fifo, (void**) converted->data, count);
+    }
+    count = swr_convert(resampler, converted->data, outputCapacity, nullptr, 0);
+    if (count > 0) {
+      av_audio_fifo_write(fifo, (void**) converted->data, count);
+    }
+
+    AVFrame* frame = av_frame_alloc();
+    frame->format = context->sample_fmt;
+    frame->sample_rate = context->sample_rate;
+    frame->nb_samples = frameSize;
+    av_channel_layout_copy(&frame->ch_layout, &context->ch_layout);
+    av_frame_get_buffer(frame, 0);
+
+    bool ok = true;
+    while (ok && av_audio_fifo_size(fifo) > 0) {
+      av_frame_make_writable(frame);
+      frame->nb_samples = av_audio_fifo_read(fifo, (void**) frame->data, frameSize);
+      ok = encoder.Encode(frame);
+    }
+
+    av_frame_free(&frame);
+    av_frame_free(&converted);
+    av_audio_fifo_free(fifo);
+    swr_free(&resampler);
+    av_channel_layout_uninit(&sourceLayout);
+
+    return ok ? encoder.Finish().size() : 0;
+  }
+
+  void Report(const std::string& source,
+              const AudioEncoderProfile& profile,
+              double seconds,
+              int iterations,
+              const std::function<size_t()>& run)
+  {
+    double totalMs = 0.0;
+    double minMs = 1e9;
+    size_t bytes = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      bytes = run();
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+      totalMs += ms;
+      minMs = std::min(minMs, ms);
+    }
+
+    double kbps = seconds > 0.0 ? bytes * 8.0 / seconds / 1000.0 : 0.0;
+    std::printf("%-32s %-16.*s %10.2f %10.2f %10zu %8.1f\n",
+                source.c_str(),
+                (int) profile.id.size(),
+                profile.id.data(),
+                totalMs / iterations,
+                minMs,
+                bytes,
+                kbps);
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  int iterations = 10;
+  std::vector<VideoClip> clips;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--iterations" && i + 1 < argc) {
+      iterations = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--clip" && i + 3 < argc) {
+      VideoClip clip;
+      clip.path = argv[++i];
+      clip.start = std::atof(argv[++i]);
+      clip.end = std::atof(argv[++i]);
+      clips.push_back(clip);
+    } else {
+      std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  std::printf("%-32s %-16s %10s %10s %10s %8s\n", "source", "profile", "avg ms", "min ms", "bytes", "kbit/s");
+
+  if (clips.empty()) {
+    AudioClipEncoder encoder;
+    for (double seconds : {3.0, 8.0}) {
+      std::vector<float> samples = MakeSyntheticSpeech(seconds, (unsigned int) seconds);
+      std::string source = "synthetic " + std::to_string((int) seconds) + " s";
+      for (const auto& profile : AudioClipEncoder::GetProfiles()) {
+        Report(source, profile, seconds, iterations, [&]() { return EncodeSamples(encoder, profile, samples); });
+      }
+    }
+    return 0;
+  }
+
+  AudioExtractionSession session;
+  for (const auto& clip : clips) {
+    session.Open(clip.path);
+    std::string source = clip.path + " @" + std::to_string((int) clip.start);
+    for (const auto& profile : AudioClipEncoder::GetProfiles()) {
+      AudioClipOptions options;
+      options.streamCopy = false;
+      options.encoderProfile = std::string(profile.id);
+      Report(source, profile, clip.end - clip.start, iterations, [&]() {
+        return session.RequestClip(clip.start, clip.end, options).get().data.size();
+      });
+    }
+  }
+
+  return 0;
+}
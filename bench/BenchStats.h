@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <nlohmann/json.hpp>
+#include <vector>
+
+namespace Video2Card::Bench
+{
+
+  /**
+   * Summary of the timings of one benchmark, in milliseconds
+   */
+  struct Stats
+  {
+    size_t count = 0;
+    double mean = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+  };
+
+  /**
+   * Nearest-rank percentile of sorted samples
+   */
+  inline double Percentile(const std::vector<double>& sorted, double percent)
+  {
+    if (sorted.empty())
+      return 0.0;
+
+    size_t rank = (size_t) std::ceil(percent / 100.0 * sorted.size());
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+  }
+
+  inline Stats Summarize(std::vector<double> samples)
+  {
+    Stats stats;
+    if (samples.empty())
+      return stats;
+
+    std::sort(samples.begin(), samples.end());
+    stats.count = samples.size();
+    stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.p50 = Percentile(samples, 50.0);
+    stats.p95 = Percentile(samples, 95.0);
+    stats.p99 = Percentile(samples, 99.0);
+    return stats;
+  }
+
+  inline nlohmann::json ToJson(const Stats& stats)
+  {
+    return {{"count", stats.count},
+            {"mean_ms", stats.mean},
+            {"min_ms", stats.min},
+            {"max_ms", stats.max},
+            {"p50_ms", stats.p50},
+            {"p95_ms", stats.p95},
+            {"p99_ms", stats.p99}};
+  }
+
+} // namespace Video2Card::Bench
@@ -0,0 +1,426 @@
+// Microbenchmarks of the per-card hot paths of the core library
+//
+// Usage: video2card_bench [--iterations N] [--filter TEXT] [--fixtures DIR] [--assets DIR] [--json FILE]
+// Fixtures come from scripts/generate_bench_fixtures.py (bench/fixtures by default). The dictionary
+// benchmarks read assets/jmdict.db and assets/pitch_accent.db from the directory given with --assets, the
+// executable's by default. Benchmarks whose inputs are missing are skipped and listed as such.
+// --json also writes the results to a file as JSON.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "BenchStats.h"
+#include "audio/AudioExtractionSession.h"
+#include "core/ThreadPool.h"
+#include "language/dictionary/JMDictionary.h"
+#include "language/furigana/MecabBasedFuriganaGenerator.h"
+#include "language/morphology/MecabAnalyzer.h"
+#include "language/pitch_accent/PitchAccentDatabase.h"
+#include "language/translation/TranslationCache.h"
+#include "utils/Base64Utils.h"
+#include "utils/ImageProcessor.h"
+
+using namespace Video2Card;
+
+namespace
+{
+  // Subtitle-length sentences, the same kind of input every card goes through
+  const std::vector<std::string> SENTENCES = {
+      "今日はいい天気ですね。",
+      "駅の前で友達を待っています。",
+      "この本はとても面白かったです。",
+      "明日の朝、早く起きなければなりません。",
+      "彼女は毎日図書館で勉強している。",
+      "昨日の夜、雨が急に降り出した。",
+      "先生に宿題を出すのを忘れてしまった。",
+      "電車が遅れたので、会議に間に合わなかった。",
+      "彼の話を信じるかどうか、まだ決めていない。",
+      "疲れているなら、少し休んだほうがいい。",
+  };
+
+  // Target words with their katakana readings, as the analyzer hands them to the lookups
+  const std::vector<std::pair<std::string, std::string>> WORDS = {
+      {"天気", "テンキ"},
+      {"友達", "トモダチ"},
+      {"面白い", "オモシロイ"},
+      {"起きる", "オキル"},
+      {"図書館", "トショカン"},
+      {"勉強", "ベンキョウ"},
+      {"降り出す", "フリダス"},
+      {"宿題", "シュクダイ"},
+      {"会議", "カイギ"},
+      {"信じる", "シンジル"},
+  };
+
+  struct Options
+  {
+    int iterations = 20;
+    std::string filter;
+    std::filesystem::path fixtures = "bench/fixtures";
+    std::filesystem::path assets;
+    std::string jsonPath;
+  };
+
+  struct Result
+  {
+    std::string name;
+    size_t itemsPerIteration = 0;
+    Bench::Stats stats;
+  };
+
+  class Runner
+  {
+public:
+
+    explicit Runner(const Options& options)
+        : m_Options(options)
+    {}
+
+    /**
+     * Time a benchmark
+     * @param name Benchmark name, matched against --filter
+     * @param items Inputs processed by one iteration, for the time per item
+     * @param run One iteration
+     */
+    void Run(const std::string& name, size_t items, const std::function<void()>& run)
+    {
+      if (!Selected(name))
+        return;
+
+      // The first iteration warms up caches, the dictionary pages and lazily opened files
+      run();
+
+      std::vector<double> samples;
+      samples.reserve(m_Options.iterations);
+      for (int i = 0; i < m_Options.iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        samples.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+      }
+
+      m_Results.push_back({name, items, Bench::Summarize(std::move(samples))});
+    }
+
+    void Skip(const std::string& name, const std::string& reason)
+    {
+      if (Selected(name))
+        m_Skipped.emplace_back(name, reason);
+    }
+
+    bool Selected(const std::string& name) const
+    {
+      return m_Options.filter.empty() || name.find(m_Options.filter) != std::string::npos;
+    }
+
+    void PrintTable() const
+    {
+      std::printf("%-34s %6s %10s %10s %10s %10s %12s\n",
+                  "benchmark",
+                  "items",
+                  "mean ms",
+                  "p50 ms",
+                  "p95 ms",
+                  "max ms",
+                  "us/item");
+      for (const auto& result : m_Results) {
+        const auto& stats = result.stats;
+        std::printf("%-34s %6zu %10.3f %10.3f %10.3f %10.3f %12.2f\n",
+                    result.name.c_str(),
+                    result.itemsPerIteration,
+                    stats.mean,
+                    stats.p50,
+                    stats.p95,
+                    stats.max,
+                    stats.mean * 1000.0 / std::max<size_t>(1, result.itemsPerIteration));
+      }
+      for (const auto& [name, reason] : m_Skipped) {
+        std::printf("%-34s skipped: %s\n", name.c_str(), reason.c_str());
+      }
+    }
+
+    nlohmann::json ToJson() const
+    {
+      nlohmann::json results = nlohmann::json::array();
+      for (const auto& result : m_Results) {
+        nlohmann::json entry = Bench::ToJson(result.stats);
+        entry["name"] = result.name;
+        entry["items_per_iteration"] = result.itemsPerIteration;
+        entry["mean_us_per_item"] = result.stats.mean * 1000.0 / std::max<size_t>(1, result.itemsPerIteration);
+        results.push_back(std::move(entry));
+      }
+
+      nlohmann::json skipped = nlohmann::json::array();
+      for (const auto& [name, reason] : m_Skipped) {
+        skipped.push_back({{"name", name}, {"reason", reason}});
+      }
+
+      return {{"suite", "video2card_bench"},
+              {"iterations", m_Options.iterations},
+              {"timestamp", std::chrono::duration_cast<std::chrono::seconds>(
+                                std::chrono::system_clock::now().time_since_epoch())
+                                .count()},
+              {"results", std::move(results)},
+              {"skipped", std::move(skipped)}};
+    }
+
+private:
+
+    const Options& m_Options;
+    std::vector<Result> m_Results;
+    std::vector<std::pair<std::string, std::string>> m_Skipped;
+  };
+
+  std::vector<unsigned char> ReadFile(const std::filesystem::path& path)
+  {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  void RunLanguageBenchmarks(Runner& runner)
+  {
+    std::shared_ptr<Language::Morphology::MecabAnalyzer> analyzer;
+    try {
+      analyzer = std::make_shared<Language::Morphology::MecabAnalyzer>();
+    } catch (const std::exception& e) {
+      for (const char* name :
+           {"mecab_analyze", "mecab_tokenize", "mecab_analyze_many", "furigana_generate", "furigana_generate_for_word"})
+      {
+        runner.Skip(name, e.what());
+      }
+      return;
+    }
+
+    runner.Run("mecab_analyze", SENTENCES.size(), [&]() {
+      for (const auto& sentence : SENTENCES) {
+        auto tokens = analyzer->Analyze(sentence);
+        (void) tokens;
+      }
+    });
+
+    // The same buffer for every line, like a batch over an episode
+    Language::Morphology::TokenizedText tokens;
+    runner.Run("mecab_tokenize", SENTENCES.size(), [&]() {
+      for (const auto& sentence : SENTENCES) {
+        analyzer->Tokenize(sentence, tokens);
+      }
+    });
+
+    // An episode's worth of lines at once, spread over every core
+    std::vector<std::string_view> episode;
+    for (size_t i = 0; i < 300; ++i) {
+      episode.push_back(SENTENCES[i % SENTENCES.size()]);
+    }
+    Core::ThreadPool pool;
+    runner.Run("mecab_analyze_many", episode.size(), [&]() {
+      auto lines = analyzer->AnalyzeMany(episode, pool);
+      (void) lines;
+    });
+
+    Language::Furigana::MecabBasedFuriganaGenerator furigana(analyzer);
+    runner.Run("furigana_generate", SENTENCES.size(), [&]() {
+      for (const auto& sentence : SENTENCES) {
+        auto text = furigana.Generate(sentence);
+        (void) text;
+      }
+    });
+
+    runner.Run("furigana_generate_for_word", WORDS.size(), [&]() {
+      for (const auto& [word, reading] : WORDS) {
+        auto text = furigana.GenerateForWord(word);
+        (void) text;
+      }
+    });
+  }
+
+  void RunDictionaryBenchmarks(Runner& runner, const std::filesystem::path& assets)
+  {
+    // SQLite would create an empty database instead of failing
+    auto dictionaryPath = assets / "assets" / "jmdict.db";
+    if (std::filesystem::exists(dictionaryPath)) {
+      Language::Dictionary::JMDictionary dictionary(dictionaryPath.string());
+      runner.Run("jmdict_lookup_word", WORDS.size(), [&]() {
+        for (const auto& [word, reading] : WORDS) {
+          auto entry = dictionary.LookupWord(word, word);
+          (void) entry;
+        }
+      });
+    } else {
+      runner.Skip("jmdict_lookup_word", dictionaryPath.string() + " not found");
+    }
+
+    auto pitchPath = assets / "assets" / "pitch_accent.db";
+    if (std::filesystem::exists(pitchPath)) {
+      Language::PitchAccent::PitchAccentDatabase pitch(pitchPath.string());
+      runner.Run("pitch_accent_lookup_word", WORDS.size(), [&]() {
+        for (const auto& [word, reading] : WORDS) {
+          auto entries = pitch.LookupWord(word, reading);
+          (void) entries;
+        }
+      });
+
+      std::vector<std::vector<Language::PitchAccent::PitchAccentEntry>> entries;
+      for (const auto& [word, reading] : WORDS) {
+        entries.push_back(pitch.LookupWord(word, reading));
+      }
+      runner.Run("pitch_accent_format_as_html", entries.size(), [&]() {
+        for (const auto& wordEntries : entries) {
+          auto html = pitch.FormatAsHtml(wordEntries);
+          (void) html;
+        }
+      });
+    } else {
+      runner.Skip("pitch_accent_lookup_word", pitchPath.string() + " not found");
+      runner.Skip("pitch_accent_format_as_html", pitchPath.string() + " not found");
+    }
+  }
+
+  void RunTranslationCacheBenchmarks(Runner& runner)
+  {
+    // A throwaway database, so the user's cache is neither read nor evicted
+    auto cachePath = std::filesystem::temp_directory_path() / "video2card_bench_translations.db";
+    std::filesystem::remove(cachePath);
+
+    {
+      Language::Translation::TranslationCache cache(cachePath.string());
+      for (const auto& sentence : SENTENCES) {
+        cache.Store("bench:JA:EN-US", sentence, "Translation of " + sentence);
+      }
+      runner.Run("translation_cache_hit_memory", SENTENCES.size(), [&]() {
+        for (const auto& sentence : SENTENCES) {
+          auto translation = cache.Find("bench:JA:EN-US", sentence);
+          (void) translation;
+        }
+      });
+    }
+
+    {
+      // Nothing kept in memory, every lookup goes to SQLite like the first repeat of a line after a restart
+      Language::Translation::TranslationCache::Options options;
+      options.memoryEntries = 0;
+      Language::Translation::TranslationCache cache(cachePath.string(), options);
+      runner.Run("translation_cache_hit_disk", SENTENCES.size(), [&]() {
+        for (const auto& sentence : SENTENCES) {
+          auto translation = cache.Find("bench:JA:EN-US", sentence);
+          (void) translation;
+        }
+      });
+    }
+
+    std::error_code error;
+    std::filesystem::remove(cachePath, error);
+    std::filesystem::remove(cachePath.string() + "-wal", error);
+    std::filesystem::remove(cachePath.string() + "-shm", error);
+  }
+
+  void RunMediaBenchmarks(Runner& runner, const std::filesystem::path& fixtures)
+  {
+    // A 320x320 WebP card image is around 20 KB, a sentence clip 50 to 100 KB
+    std::vector<unsigned char> payload(64 * 1024);
+    std::mt19937 rng(1);
+    for (auto& byte : payload) {
+      byte = (unsigned char) rng();
+    }
+    runner.Run("base64_encode_64k", 1, [&]() {
+      auto encoded = Utils::Base64Utils::Encode(payload);
+      (void) encoded;
+    });
+
+    auto framePath = fixtures / "frame.png";
+    if (std::filesystem::exists(framePath)) {
+      std::vector<unsigned char> frame = ReadFile(framePath);
+      runner.Run("scale_and_compress_to_webp_720p", 1, [&]() {
+        auto webp = Utils::ImageProcessor::ScaleAndCompressToWebP(frame, 320, 320);
+        (void) webp;
+      });
+    } else {
+      runner.Skip("scale_and_compress_to_webp_720p", framePath.string() + " not found");
+    }
+
+    auto videoPath = fixtures / "episode.mkv";
+    if (!std::filesystem::exists(videoPath)) {
+      runner.Skip("audio_clip_stream_copy", videoPath.string() + " not found");
+      runner.Skip("audio_clip_transcode", videoPath.string() + " not found");
+      return;
+    }
+
+    // Clips spread over the file so every iteration seeks, like extracting lines of an episode in turn
+    Audio::AudioExtractionSession session;
+    session.Open(videoPath.string());
+    const std::vector<std::pair<double, double>> clips = {{4.5, 7.5}, {22.0, 25.0}, {41.5, 44.5}, {12.5, 15.5}};
+
+    auto extract = [&](const Audio::AudioClipOptions& options) {
+      for (const auto& [start, end] : clips) {
+        auto clip = session.RequestClip(start, end, options).get();
+        if (clip.IsEmpty())
+          std::fprintf(stderr, "Empty clip at %.1f s\n", start);
+      }
+    };
+
+    Audio::AudioClipOptions copy;
+    copy.streamCopy = true;
+    runner.Run("audio_clip_stream_copy", clips.size(), [&]() { extract(copy); });
+
+    Audio::AudioClipOptions transcode;
+    transcode.streamCopy = false;
+    runner.Run("audio_clip_transcode", clips.size(), [&]() { extract(transcode); });
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--iterations" && i + 1 < argc) {
+      options.iterations = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--filter" && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else if (arg == "--fixtures" && i + 1 < argc) {
+      options.fixtures = argv[++i];
+    } else if (arg == "--assets" && i + 1 < argc) {
+      options.assets = argv[++i];
+    } else if (arg == "--json" && i + 1 < argc) {
+      options.jsonPath = argv[++i];
+    } else {
+      std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if (options.assets.empty()) {
+    // The build copies assets/ next to the executables
+    std::error_code error;
+    options.assets = std::filesystem::weakly_canonical(argv[0], error).parent_path();
+  }
+
+  Runner runner(options);
+  RunLanguageBenchmarks(runner);
+  RunDictionaryBenchmarks(runner, options.assets);
+  RunTranslationCacheBenchmarks(runner);
+  RunMediaBenchmarks(runner, options.fixtures);
+
+  runner.PrintTable();
+  if (!options.jsonPath.empty()) {
+    std::ofstream file(options.jsonPath);
+    if (!file) {
+      std::fprintf(stderr, "Failed to write %s\n", options.jsonPath.c_str());
+      return 1;
+    }
+    file << runner.ToJson().dump(2) << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,287 @@
+// End-to-end latency of extracting a card, the time between pressing M and the fields being filled
+//
+// Usage: extraction_latency_bench [--iterations N] [--video FILE] [--assets DIR] [--translation-latency MS]
+//                                 [--json FILE]
+// Runs the sequence of Application::OnExtract and ProcessExtract without the UI: subtitle line, then snapshot,
+// sentence audio, translation and local analysis side by side, and filling the fields, including the WebP
+// encode and Base64 upload payloads. Every iteration takes the next line of the video's subtitle track, so
+// each one seeks like a real extraction. Nothing is prefetched: this is the cold path.
+// The translator and AnkiConnect are replaced by local stand-ins; --translation-latency adds a fixed delay to
+// the translator to model a network round trip. The video defaults to the one written by
+// scripts/generate_bench_fixtures.py, which has an embedded subtitle track.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "BenchStats.h"
+#include "audio/AudioExtractionSession.h"
+#include "language/analyzer/SentenceAnalyzer.h"
+#include "language/translation/ITranslator.h"
+#include "utils/Base64Utils.h"
+#include "utils/ImageProcessor.h"
+#include "video/SnapshotService.h"
+#include "video/SubtitleIndex.h"
+
+using namespace Video2Card;
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  // Stages in the order the extraction goes through them, the total is measured separately
+  const std::vector<std::string> STAGES = {"subtitle", "snapshot", "audio", "analysis", "translation", "fields"};
+
+  struct Options
+  {
+    int iterations = 50;
+    std::string videoPath = "bench/fixtures/episode.mkv";
+    std::filesystem::path assets;
+    int translationLatencyMs = 0;
+    std::string jsonPath;
+  };
+
+  double ElapsedMs(Clock::time_point since)
+  {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+  }
+
+  /**
+   * Stands in for DeepL and Google Translate, which would measure the network instead of the code
+   */
+  class LocalTranslator : public Language::Translation::ITranslator
+  {
+public:
+
+    explicit LocalTranslator(int latencyMs)
+        : m_Latency(latencyMs)
+    {}
+
+    std::string Translate(const std::string& text) override
+    {
+      if (m_Latency.count() > 0)
+        std::this_thread::sleep_for(m_Latency);
+      return "Translation of " + std::to_string(text.size()) + " bytes";
+    }
+
+    bool IsAvailable() const override { return true; }
+
+private:
+
+    std::chrono::milliseconds m_Latency;
+  };
+
+  /**
+   * Stands in for AnkiConnect: keeps the media payloads and the note fields instead of sending them
+   */
+  struct LocalAnkiStore
+  {
+    size_t mediaBytes = 0;
+    size_t notes = 0;
+
+    bool StoreMediaFile(const std::string& filename, const std::string& base64Data)
+    {
+      mediaBytes += filename.size() + base64Data.size();
+      return true;
+    }
+
+    void AddNote(const std::map<std::string, std::string>& fields) { notes += fields.empty() ? 0 : 1; }
+  };
+
+  /**
+   * One extraction, stage times in milliseconds
+   */
+  std::map<std::string, double> Extract(const Video::SubtitleCue& line,
+                                        Video::SnapshotService& snapshots,
+                                        Audio::AudioExtractionSession& audioSession,
+                                        Language::Analyzer::SentenceAnalyzer& analyzer,
+                                        LocalTranslator& translator,
+                                        const Video::SubtitleIndex& subtitles,
+                                        LocalAnkiStore& anki)
+  {
+    std::map<std::string, double> times;
+    const auto pressed = Clock::now();
+
+    // OnExtract: the current line, then the snapshot and audio are requested and decode in the background
+    auto stage = Clock::now();
+    double midpoint = (line.start + line.end) / 2.0;
+    const Video::SubtitleCue* current = subtitles.FindAt(midpoint);
+    std::string sentence = Video::ToSingleLine(current ? current->text : line.text);
+    times["subtitle"] = ElapsedMs(stage);
+
+    auto requested = Clock::now();
+    auto pendingImage = std::async(std::launch::async, [&snapshots, midpoint, requested]() {
+      auto image = snapshots.RequestSnapshot(midpoint).get();
+      return std::make_pair(std::move(image), ElapsedMs(requested));
+    });
+    auto pendingAudio = std::async(std::launch::async, [&audioSession, &line, requested]() {
+      auto clip = audioSession.RequestClip(line.start, line.end).get();
+      return std::make_pair(std::move(clip), ElapsedMs(requested));
+    });
+
+    // ProcessExtract: the translation starts right away and the local analysis runs meanwhile, then the media
+    // and the translation are joined
+    auto pendingTranslation = std::async(std::launch::async, [&translator, sentence]() {
+      auto started = Clock::now();
+      std::string translation = translator.Translate(sentence);
+      return std::make_pair(std::move(translation), ElapsedMs(started));
+    });
+
+    stage = Clock::now();
+    nlohmann::json analysis = analyzer.AnalyzeLocally(sentence, "");
+    times["analysis"] = ElapsedMs(stage);
+
+    auto [image, snapshotMs] = pendingImage.get();
+    auto [audio, audioMs] = pendingAudio.get();
+    times["snapshot"] = snapshotMs;
+    times["audio"] = audioMs;
+
+    auto [translation, translationMs] = pendingTranslation.get();
+    analysis["translation"] = std::move(translation);
+    times["translation"] = translationMs;
+
+    // PerformAdd: the image is encoded once, the media uploaded and the note added
+    stage = Clock::now();
+    std::map<std::string, std::string> fields;
+    for (const char* key : {"sentence", "furigana", "translation", "target_word", "target_word_furigana",
+                            "pitch_accent", "definition"})
+    {
+      fields[key] = analysis.value(key, "");
+    }
+
+    if (!image.IsEmpty()) {
+      auto webp = Utils::ImageProcessor::EncodeToWebP(image, 320, 320);
+      if (anki.StoreMediaFile("image.webp", Utils::Base64Utils::Encode(webp)))
+        fields["image"] = "<img src=\"image.webp\">";
+    }
+    if (!audio.IsEmpty()) {
+      std::string filename = "sentence." + audio.extension;
+      if (anki.StoreMediaFile(filename, Utils::Base64Utils::Encode(audio.data)))
+        fields["sentence_audio"] = "[sound:" + filename + "]";
+    }
+    anki.AddNote(fields);
+    times["fields"] = ElapsedMs(stage);
+
+    times["total"] = ElapsedMs(pressed);
+    return times;
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--iterations" && i + 1 < argc) {
+      options.iterations = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--video" && i + 1 < argc) {
+      options.videoPath = argv[++i];
+    } else if (arg == "--assets" && i + 1 < argc) {
+      options.assets = argv[++i];
+    } else if (arg == "--translation-latency" && i + 1 < argc) {
+      options.translationLatencyMs = std::max(0, std::atoi(argv[++i]));
+    } else if (arg == "--json" && i + 1 < argc) {
+      options.jsonPath = argv[++i];
+    } else {
+      std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if (options.assets.empty()) {
+    // The build copies assets/ next to the executables
+    std::error_code error;
+    options.assets = std::filesystem::weakly_canonical(argv[0], error).parent_path();
+  }
+
+  auto setup = Clock::now();
+  Video::SubtitleIndex subtitles = Video::SubtitleIndex::Load(options.videoPath);
+  double subtitleLoadMs = ElapsedMs(setup);
+  if (subtitles.IsEmpty()) {
+    std::fprintf(stderr,
+                 "No text subtitle track in %s, run scripts/generate_bench_fixtures.py first\n",
+                 options.videoPath.c_str());
+    return 1;
+  }
+
+  setup = Clock::now();
+  std::string basePath = options.assets.string();
+  if (!basePath.empty() && basePath.back() != '/' && basePath.back() != '\\')
+    basePath += '/';
+  Language::Analyzer::SentenceAnalyzer analyzer;
+  if (!analyzer.Initialize(basePath)) {
+    std::fprintf(stderr, "Failed to initialize the sentence analyzer\n");
+    return 1;
+  }
+  double analyzerInitMs = ElapsedMs(setup);
+
+  Video::SnapshotService snapshots;
+  snapshots.Open(options.videoPath);
+  Audio::AudioExtractionSession audioSession;
+  audioSession.Open(options.videoPath);
+
+  LocalTranslator translator(options.translationLatencyMs);
+  LocalAnkiStore anki;
+
+  // The first extraction also opens the file in both workers, which the app does when the video is loaded
+  const auto& cues = subtitles.GetCues();
+  Extract(cues.front(), snapshots, audioSession, analyzer, translator, subtitles, anki);
+
+  std::map<std::string, std::vector<double>> samples;
+  for (int i = 0; i < options.iterations; ++i) {
+    // Lines in a scattered order, so the snapshot and audio workers seek back and forth
+    const auto& line = cues[(size_t) i * 7 % cues.size()];
+    for (const auto& [stage, ms] : Extract(line, snapshots, audioSession, analyzer, translator, subtitles, anki)) {
+      samples[stage].push_back(ms);
+    }
+  }
+
+  std::printf("Setup: subtitle track %.1f ms, analyzer %.1f ms, %zu lines\n",
+              subtitleLoadMs,
+              analyzerInitMs,
+              cues.size());
+  std::printf("%-12s %10s %10s %10s %10s %10s\n", "stage", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms");
+
+  nlohmann::json stages = nlohmann::json::object();
+  std::vector<std::string> order = STAGES;
+  order.push_back("total");
+  for (const auto& stage : order) {
+    Bench::Stats stats = Bench::Summarize(samples[stage]);
+    std::printf("%-12s %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                stage.c_str(),
+                stats.mean,
+                stats.p50,
+                stats.p95,
+                stats.p99,
+                stats.max);
+    stages[stage] = Bench::ToJson(stats);
+  }
+  std::printf("Snapshot, audio, analysis and translation run in parallel, the total waits for the slowest.\n");
+
+  if (!options.jsonPath.empty()) {
+    nlohmann::json result = {{"suite", "extraction_latency_bench"},
+                             {"video", options.videoPath},
+                             {"iterations", options.iterations},
+                             {"translation_latency_ms", options.translationLatencyMs},
+                             {"setup", {{"subtitle_load_ms", subtitleLoadMs}, {"analyzer_init_ms", analyzerInitMs}}},
+                             {"stages", std::move(stages)}};
+
+    std::ofstream file(options.jsonPath);
+    if (!file) {
+      std::fprintf(stderr, "Failed to write %s\n", options.jsonPath.c_str());
+      return 1;
+    }
+    file << result.dump(2) << std::endl;
+  }
+
+  return 0;
+}
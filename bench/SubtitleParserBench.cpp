@@ -0,0 +1,224 @@
+// Parses subtitle files with SubtitleParser and reports time and throughput
+//
+// Usage: subtitle_parser_bench [--iterations N] [file-or-directory ...]
+// Directories are searched recursively for .srt, .ass, .ssa and .vtt files. Each pass maps, decodes and parses
+// every file ("parse") and then cleans up the text of every cue ("parse+text"). Without paths, a synthetic
+// season of 24 SRT and 24 ASS episodes is parsed from memory.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "video/SubtitleParser.h"
+
+using Video2Card::Video::SubtitleFile;
+using Video2Card::Video::SubtitleFormat;
+using Video2Card::Video::SubtitleParser;
+
+namespace
+{
+  constexpr int SYNTHETIC_EPISODES = 24;
+  constexpr int SYNTHETIC_CUES = 450;
+
+  struct MemoryFile
+  {
+    std::string name;
+    SubtitleFormat format;
+    std::string data;
+  };
+
+  std::string FormatSrtTime(double seconds)
+  {
+    int total = (int) seconds;
+    int milliseconds = (int) ((seconds - total) * 1000);
+    return std::format("{:02d}:{:02d}:{:02d},{:03d}", total / 3600, total / 60 % 60, total % 60, milliseconds);
+  }
+
+  std::string FormatAssTime(double seconds)
+  {
+    int total = (int) seconds;
+    int centiseconds = (int) ((seconds - total) * 100);
+    return std::format("{:d}:{:02d}:{:02d}.{:02d}", total / 3600, total / 60 % 60, total % 60, centiseconds);
+  }
+
+  // Lines of a typical length with a mix of Japanese text and markup
+  std::string MakeLine(int index)
+  {
+    static const char* PHRASES[] = {
+        "今日はいい天気ですね",
+        "それは本当ですか？",
+        "行こう！",
+        "ちょっと待って",
+        "分かった",
+    };
+    std::string line = PHRASES[index % 5];
+    if (index % 7 == 0)
+      line += " 「本気で言ってるの？」";
+    return line;
+  }
+
+  std::string MakeSrt()
+  {
+    std::string data = "\xEF\xBB\xBF";
+    for (int i = 0; i < SYNTHETIC_CUES; ++i) {
+      double start = 2.0 + i * 3.1;
+      data += std::format("{}\r\n{} --> {}\r\n", i + 1, FormatSrtTime(start), FormatSrtTime(start + 2.4));
+      data += (i % 4 == 0 ? "<i>" + MakeLine(i) + "</i>" : MakeLine(i)) + "\r\n";
+      if (i % 3 == 0)
+        data += MakeLine(i + 1) + "\r\n";
+      data += "\r\n";
+    }
+    return data;
+  }
+
+  std::string MakeAss()
+  {
+    std::string data = "[Script Info]\nScriptType: v4.00+\nPlayResX: 1920\nPlayResY: 1080\n\n"
+                       "[V4+ Styles]\nFormat: Name, Fontname, Fontsize\nStyle: Default,Arial,60\n\n"
+                       "[Events]\nFormat: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text\n";
+    for (int i = 0; i < SYNTHETIC_CUES; ++i) {
+      double start = 2.0 + i * 3.1;
+      std::string text = MakeLine(i);
+      if (i % 3 == 0)
+        text = "{\\fad(120,120)}" + text + "\\N" + MakeLine(i + 1);
+      data += std::format("Dialogue: 0,{},{},Default,,0,0,0,,{}\n",
+                          FormatAssTime(start),
+                          FormatAssTime(start + 2.4),
+                          text);
+    }
+    return data;
+  }
+
+  void CollectFiles(const std::filesystem::path& path, std::vector<std::string>& files)
+  {
+    std::error_code error;
+    if (std::filesystem::is_directory(path, error)) {
+      for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error)) {
+        if (entry.is_regular_file() && SubtitleFile::IsSupported(entry.path().string()))
+          files.push_back(entry.path().string());
+      }
+    } else if (std::filesystem::is_regular_file(path, error)) {
+      files.push_back(path.string());
+    }
+  }
+
+  struct PassResult
+  {
+    size_t cues = 0;
+    size_t textBytes = 0;
+  };
+
+  void Report(const char* name, int iterations, size_t bytes, size_t files, const std::function<PassResult()>& run)
+  {
+    double totalMs = 0.0;
+    double minMs = 1e9;
+    PassResult result;
+
+    for (int i = 0; i < iterations; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      result = run();
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+      totalMs += ms;
+      minMs = std::min(minMs, ms);
+    }
+
+    double megabytes = bytes / (1024.0 * 1024.0);
+    std::printf("%-12s %8zu %10.2f %10zu %10.3f %10.3f %10.1f\n",
+                name,
+                files,
+                megabytes,
+                result.cues,
+                totalMs / iterations,
+                minMs,
+                minMs > 0.0 ? megabytes / (minMs / 1000.0) : 0.0);
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  int iterations = 20;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--iterations" && i + 1 < argc) {
+      iterations = std::max(1, std::atoi(argv[++i]));
+    } else if (!arg.starts_with("--")) {
+      CollectFiles(arg, files);
+    } else {
+      std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  std::printf("%-12s %8s %10s %10s %10s %10s %10s\n", "pass", "files", "MB", "cues", "avg ms", "min ms", "MB/s");
+
+  if (files.empty()) {
+    std::vector<MemoryFile> season;
+    size_t bytes = 0;
+    for (int episode = 1; episode <= SYNTHETIC_EPISODES; ++episode) {
+      season.push_back({std::format("episode{:02d}.srt", episode), SubtitleFormat::SubRip, MakeSrt()});
+      season.push_back({std::format("episode{:02d}.ass", episode), SubtitleFormat::Ass, MakeAss()});
+      bytes += season[season.size() - 2].data.size() + season.back().data.size();
+    }
+
+    Report("parse", iterations, bytes, season.size(), [&]() {
+      PassResult result;
+      for (const auto& file : season) {
+        result.cues += SubtitleParser::Parse(file.data, file.format).size();
+      }
+      return result;
+    });
+    Report("parse+text", iterations, bytes, season.size(), [&]() {
+      PassResult result;
+      for (const auto& file : season) {
+        for (const auto& cue : SubtitleParser::Parse(file.data, file.format)) {
+          result.textBytes += SubtitleParser::CleanText(cue.text, file.format).size();
+          ++result.cues;
+        }
+      }
+      return result;
+    });
+    return 0;
+  }
+
+  size_t bytes = 0;
+  for (const auto& file : files) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(file, error);
+    if (!error)
+      bytes += size;
+  }
+
+  Report("parse", iterations, bytes, files.size(), [&]() {
+    PassResult result;
+    for (const auto& path : files) {
+      SubtitleFile file;
+      if (file.Open(path))
+        result.cues += file.GetCues().size();
+    }
+    return result;
+  });
+  Report("parse+text", iterations, bytes, files.size(), [&]() {
+    PassResult result;
+    for (const auto& path : files) {
+      SubtitleFile file;
+      if (!file.Open(path))
+        continue;
+      for (const auto& cue : file.GetCues()) {
+        result.textBytes += file.GetText(cue).size();
+        ++result.cues;
+      }
+    }
+    return result;
+  });
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+// Encodes sample frames with every WebP encoder profile and reports time and size
+//
+// Usage: webp_encoder_bench [--iterations N] [image ...]
+// Without images, synthetic 320x180 and 640x360 frames are used.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "utils/RawImage.h"
+#include "utils/WebPEncoder.h"
+
+using Video2Card::Utils::RawImage;
+using Video2Card::Utils::WebPEncoder;
+
+namespace
+{
+  struct SampleFrame
+  {
+    std::string name;
+    RawImage image;
+  };
+
+  // Smooth gradients with a few hard edges and some grain, roughly what a video frame looks like to the encoder
+  RawImage MakeSyntheticFrame(int width, int height, unsigned int seed)
+  {
+    RawImage image;
+    image.width = width;
+    image.height = height;
+    image.stride = width * 4;
+    image.pixels.resize(image.SizeInBytes());
+
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> grain(0.0f, 4.0f);
+
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        float u = (float) x / width;
+        float v = (float) y / height;
+        float r = 40.0f + 150.0f * u;
+        float g = 60.0f + 120.0f * v;
+        float b = 90.0f + 60.0f * std::sin(u * 6.0f + v * 3.0f);
+
+        // A bright disc and a dark bar as foreground objects
+        float dx = u - 0.35f, dy = v - 0.45f;
+        if (dx * dx + dy * dy < 0.03f) {
+          r = 230.0f, g = 200.0f, b = 170.0f;
+        }
+        if (v > 0.8f && u > 0.1f && u < 0.9f) {
+          r *= 0.2f, g *= 0.2f, b *= 0.2f;
+        }
+
+        unsigned char* pixel = &image.pixels[(size_t) y * image.stride + (size_t) x * 4];
+        pixel[0] = (unsigned char) std::clamp(r + grain(rng), 0.0f, 255.0f);
+        pixel[1] = (unsigned char) std::clamp(g + grain(rng), 0.0f, 255.0f);
+        pixel[2] = (unsigned char) std::clamp(b + grain(rng), 0.0f, 255.0f);
+        pixel[3] = 255;
+      }
+    }
+    return image;
+  }
+
+  bool LoadFrame(const char* path, SampleFrame& frame)
+  {
+    int width{}, height{}, channels{};
+    unsigned char* data = stbi_load(path, &width, &height, &channels, 4);
+    if (!data) {
+      std::fprintf(stderr, "Failed to load %s: %s\n", path, stbi_failure_reason());
+      return false;
+    }
+
+    frame.name = path;
+    frame.image.width = width;
+    frame.image.height = height;
+    frame.image.stride = width * 4;
+    frame.image.pixels.assign(data, data + frame.image.SizeInBytes());
+    stbi_image_free(data);
+    return true;
+  }
+} // namespace
+
+int main(int argc, char** argv)
+{
+  int iterations = 10;
+  std::vector<SampleFrame> frames;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--iterations" && i + 1 < argc) {
+      iterations = std::max(1, std::atoi(argv[++i]));
+    } else {
+      SampleFrame frame;
+      if (LoadFrame(argv[i], frame)) {
+        frames.push_back(std::move(frame));
+      }
+    }
+  }
+
+  if (frames.empty()) {
+    frames.push_back({"synthetic 320x180", MakeSyntheticFrame(320, 180, 1)});
+    frames.push_back({"synthetic 640x360", MakeSyntheticFrame(640, 360, 2)});
+  }
+
+  std::printf("%-28s %-20s %10s %10s %10s\n", "frame", "profile", "avg ms", "min ms", "bytes");
+
+  for (const auto& frame : frames) {
+    for (const auto& profile : WebPEncoder::GetProfiles()) {
+      double totalMs = 0.0;
+      double minMs = 1e9;
+      size_t bytes = 0;
+
+      for (int i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        auto encoded = WebPEncoder::Encode(
+            frame.image.pixels.data(), frame.image.width, frame.image.height, frame.image.stride, profile);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        totalMs += ms;
+        minMs = std::min(minMs, ms);
+        bytes = encoded.size();
+      }
+
+      std::printf("%-28s %-20.*s %10.2f %10.2f %10zu\n",
+                  frame.name.c_str(),
+                  (int) profile.id.size(),
+                  profile.id.data(),
+                  totalMs / iterations,
+                  minMs,
+                  bytes);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,434 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "api/AnkiConnectClient.h"
+#include "config/ConfigManager.h"
+#include "core/BatchMiner.h"
+#include "core/FieldTypes.h"
+#include "core/Logger.h"
+#include "core/ThreadPool.h"
+#include "language/analyzer/SentenceAnalyzer.h"
+#include "language/services/DeepLService.h"
+#include "language/services/GoogleTranslateService.h"
+#include "utils/Base64Utils.h"
+#include "utils/FileUtils.h"
+#include "utils/ImageProcessor.h"
+#include "utils/WebPEncoder.h"
+#include "video/SubtitleIndex.h"
+
+namespace
+{
+  using namespace Video2Card;
+
+  constexpr int IMAGE_MAX_SIZE = 320;
+
+  struct CliOptions
+  {
+    std::string videoPath;
+    std::string subtitlePath; // Empty for the subtitle track embedded in the video
+    std::string configPath;
+    std::string assetsPath; // Directory containing assets/
+    std::string ankiUrl;
+    std::string deck;
+    std::string noteType;
+    std::string translator;
+    std::vector<std::string> tags = {"video2card"};
+    double subtitleDelay = 0.0;
+    double from = 0.0;
+    std::optional<double> to;
+    size_t threads = 0;
+    bool dryRun = false;
+  };
+
+  void PrintUsage()
+  {
+    std::cout << "Usage: video2card-cli [options] <video> [subtitles]\n"
+                 "\n"
+                 "Adds a card for every subtitle line of a video to Anki. Without a subtitle file the text\n"
+                 "subtitle track of the video is used. Deck, note type, field mapping and media settings default\n"
+                 "to the ones saved by Anki Video2Card.\n"
+                 "\n"
+                 "Options:\n"
+                 "  --deck NAME           Deck to add the cards to\n"
+                 "  --note-type NAME      Note type of the cards\n"
+                 "  --tag TAG             Extra tag, may be repeated (video2card is always added)\n"
+                 "  --translator ID       google_translate or deepl\n"
+                 "  --sub-delay SECONDS   Shift the subtitles, positive values show them later\n"
+                 "  --from SECONDS        Skip lines starting before this time\n"
+                 "  --to SECONDS          Skip lines starting after this time\n"
+                 "  --anki-url URL        AnkiConnect address\n"
+                 "  --config FILE         Settings file, by default the one of the desktop app\n"
+                 "  --assets DIR          Directory containing assets/, by default the executable's\n"
+                 "  --threads N           Encoding and analysis threads\n"
+                 "  --dry-run             Mine and analyze the lines without adding anything\n"
+                 "  --help                Show this help\n";
+  }
+
+  std::optional<CliOptions> ParseArguments(int argc, char* argv[])
+  {
+    CliOptions options;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+
+      auto value = [&]() -> std::optional<std::string> {
+        if (i + 1 >= argc) {
+          std::cerr << "Missing value for " << arg << "\n";
+          return std::nullopt;
+        }
+        return std::string(argv[++i]);
+      };
+
+      auto seconds = [&](double& target) {
+        auto text = value();
+        if (!text)
+          return false;
+        try {
+          target = std::stod(*text);
+          return true;
+        } catch (const std::exception&) {
+          std::cerr << "Invalid time for " << arg << ": " << *text << "\n";
+          return false;
+        }
+      };
+
+      if (arg == "--help" || arg == "-h") {
+        PrintUsage();
+        std::exit(0);
+      } else if (arg == "--dry-run") {
+        options.dryRun = true;
+      } else if (arg == "--deck" || arg == "--note-type" || arg == "--tag" || arg == "--translator" ||
+                 arg == "--anki-url" || arg == "--config" || arg == "--assets" || arg == "--threads")
+      {
+        auto text = value();
+        if (!text)
+          return std::nullopt;
+
+        if (arg == "--deck")
+          options.deck = *text;
+        else if (arg == "--note-type")
+          options.noteType = *text;
+        else if (arg == "--tag")
+          options.tags.push_back(*text);
+        else if (arg == "--translator")
+          options.translator = *text;
+        else if (arg == "--anki-url")
+          options.ankiUrl = *text;
+        else if (arg == "--config")
+          options.configPath = *text;
+        else if (arg == "--assets")
+          options.assetsPath = *text;
+        else
+          options.threads = (size_t) std::max(0, std::atoi(text->c_str()));
+      } else if (arg == "--sub-delay") {
+        if (!seconds(options.subtitleDelay))
+          return std::nullopt;
+      } else if (arg == "--from") {
+        if (!seconds(options.from))
+          return std::nullopt;
+      } else if (arg == "--to") {
+        double to = 0.0;
+        if (!seconds(to))
+          return std::nullopt;
+        options.to = to;
+      } else if (arg.starts_with("--")) {
+        std::cerr << "Unknown option " << arg << "\n";
+        return std::nullopt;
+      } else {
+        positional.push_back(arg);
+      }
+    }
+
+    if (positional.empty() || positional.size() > 2) {
+      PrintUsage();
+      return std::nullopt;
+    }
+
+    options.videoPath = positional[0];
+    if (positional.size() == 2)
+      options.subtitlePath = positional[1];
+
+    if (options.assetsPath.empty()) {
+      // Assets are copied next to the executable by the build
+      std::error_code error;
+      std::filesystem::path executable = std::filesystem::weakly_canonical(argv[0], error);
+      options.assetsPath = error ? "" : executable.parent_path().string();
+    }
+    if (!options.assetsPath.empty() && !options.assetsPath.ends_with('/') && !options.assetsPath.ends_with('\\'))
+      options.assetsPath += '/';
+
+    return options;
+  }
+
+  /**
+   * Upload a media file and return the field value referencing it, empty on failure
+   */
+  std::string StoreMedia(API::AnkiConnectClient& anki,
+                         const std::vector<unsigned char>& data,
+                         const std::string& filename,
+                         Core::FieldTool tool)
+  {
+    if (!anki.StoreMediaFile(filename, Utils::Base64Utils::Encode(data))) {
+      AF_ERROR("Failed to upload media file: {}", filename);
+      return "";
+    }
+    return tool == Core::FieldTool::Image ? "<img src=\"" + filename + "\">" : "[sound:" + filename + "]";
+  }
+
+  /**
+   * Fill the note fields of one line as the desktop app does, following the field mapping of the note type
+   */
+  std::map<std::string, std::string> BuildFields(API::AnkiConnectClient& anki,
+                                                 const Config::AppConfig& config,
+                                                 const std::string& noteType,
+                                                 const std::vector<std::string>& fieldNames,
+                                                 const nlohmann::json& analysis,
+                                                 const Utils::RawImage& image,
+                                                 const Audio::AudioClip& audio,
+                                                 size_t lineIndex)
+  {
+    std::map<std::string, std::string> fields;
+    auto mapping = config.FieldMappings.find(noteType);
+    if (mapping == config.FieldMappings.end())
+      return fields;
+
+    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    const auto& imageProfile = Utils::WebPEncoder::GetProfile(config.ImageEncoderProfile);
+
+    for (const auto& name : fieldNames) {
+      auto entry = mapping->second.find(name);
+      if (entry == mapping->second.end() || !entry->second.first)
+        continue;
+
+      auto tool = (Core::FieldTool) entry->second.second;
+      std::string value;
+      switch (tool) {
+        case Core::FieldTool::SentenceText:
+          value = analysis.value("sentence", "");
+          break;
+        case Core::FieldTool::SentenceFurigana:
+          value = analysis.value("furigana", "");
+          break;
+        case Core::FieldTool::SentenceTranslation:
+          value = analysis.value("translation", "");
+          break;
+        case Core::FieldTool::VocabWord:
+          value = analysis.value("target_word", "");
+          break;
+        case Core::FieldTool::VocabFurigana:
+          value = analysis.value("target_word_furigana", "");
+          break;
+        case Core::FieldTool::PitchAccent:
+          value = analysis.value("pitch_accent", "");
+          break;
+        case Core::FieldTool::VocabDefinition:
+          value = analysis.value("definition", "");
+          break;
+        case Core::FieldTool::Image:
+          if (!image.IsEmpty()) {
+            auto webp = Utils::ImageProcessor::EncodeToWebP(image, IMAGE_MAX_SIZE, IMAGE_MAX_SIZE, imageProfile);
+            if (!webp.empty())
+              value = StoreMedia(anki, webp, std::format("{}_{}_image.webp", timestamp, lineIndex), tool);
+          }
+          break;
+        case Core::FieldTool::SentenceAudio:
+          if (!audio.IsEmpty()) {
+            std::string filename = std::format("{}_{}_sentence.{}", timestamp, lineIndex, audio.extension);
+            value = StoreMedia(anki, audio.data, filename, tool);
+          }
+          break;
+        default:
+          // Vocab audio is looked up on Forvo by the desktop app only
+          break;
+      }
+
+      if (!value.empty())
+        fields[name] = value;
+    }
+
+    return fields;
+  }
+
+  int Run(const CliOptions& options)
+  {
+    Config::ConfigManager configManager(options.configPath.empty() ? Utils::FileUtils::GetConfigPath()
+                                                                   : options.configPath);
+    const auto& config = configManager.GetConfig();
+
+    std::string deck = options.deck.empty() ? config.LastDeck : options.deck;
+    std::string noteType = options.noteType.empty() ? config.LastNoteType : options.noteType;
+    if (!options.dryRun && (deck.empty() || noteType.empty())) {
+      std::cerr << "No deck or note type given and none saved by the desktop app, use --deck and --note-type\n";
+      return 1;
+    }
+
+    // Subtitles first, there is nothing to do without them
+    const std::string& subtitleSource = options.subtitlePath.empty() ? options.videoPath : options.subtitlePath;
+    Video::SubtitleIndex subtitles = Video::SubtitleIndex::Load(subtitleSource);
+    if (subtitles.IsEmpty()) {
+      std::cerr << "No text subtitles found in " << subtitleSource << "\n";
+      return 1;
+    }
+
+    std::vector<Video::SubtitleCue> cues;
+    for (const auto& cue : subtitles.GetCues()) {
+      double start = cue.start + options.subtitleDelay;
+      if (start < options.from || (options.to && start > *options.to))
+        continue;
+
+      std::string text = Video::ToSingleLine(cue.text);
+      if (!text.empty())
+        cues.push_back({start, cue.end + options.subtitleDelay, std::move(text)});
+    }
+
+    if (cues.empty()) {
+      std::cerr << "No subtitle lines in the selected range\n";
+      return 1;
+    }
+
+    std::string ankiUrl = options.ankiUrl.empty() ? config.AnkiConnectUrl : options.ankiUrl;
+    if (ankiUrl.empty())
+      ankiUrl = "http://localhost:8765";
+    API::AnkiConnectClient anki(ankiUrl);
+
+    std::vector<std::string> fieldNames;
+    if (!options.dryRun) {
+      if (!anki.Ping()) {
+        std::cerr << "AnkiConnect is not reachable at " << ankiUrl << "\n";
+        return 1;
+      }
+
+      fieldNames = anki.GetModelFieldNames(noteType);
+      if (fieldNames.empty()) {
+        std::cerr << "Note type '" << noteType << "' has no fields or does not exist\n";
+        return 1;
+      }
+      if (!config.FieldMappings.contains(noteType)) {
+        std::cerr << "No field mapping saved for note type '" << noteType
+                  << "', set it up once in the desktop app\n";
+        return 1;
+      }
+    }
+
+    // Same services and analyzer setup as the desktop app
+    std::vector<std::unique_ptr<Language::Services::ILanguageService>> services;
+    auto googleTranslateService = std::make_unique<Language::Services::GoogleTranslateService>();
+    googleTranslateService->LoadConfig({{"source_lang", "ja"}, {"target_lang", "en"}});
+    services.push_back(std::move(googleTranslateService));
+
+    auto deeplService = std::make_unique<Language::Services::DeepLService>();
+    deeplService->LoadConfig({{"api_key", config.DeepLApiKey},
+                              {"use_free_api", config.DeepLUseFreeAPI},
+                              {"source_lang", config.DeepLSourceLang},
+                              {"target_lang", config.DeepLTargetLang}});
+    services.push_back(std::move(deeplService));
+
+    Language::Analyzer::SentenceAnalyzer analyzer;
+    analyzer.SetLanguageServices(&services);
+    if (!options.translator.empty())
+      analyzer.SetPreferredTranslator(options.translator);
+    if (!analyzer.Initialize(options.assetsPath)) {
+      std::cerr << "Failed to initialize the sentence analyzer\n";
+      return 1;
+    }
+
+    Core::ThreadPool pool(options.threads);
+    Core::BatchMiner miner(pool, [&analyzer](const std::string& sentence) {
+      return analyzer.AnalyzeLocally(sentence, "");
+    });
+
+    Core::MiningOptions miningOptions;
+    miningOptions.audio.streamCopy = config.AudioStreamCopy;
+    miningOptions.audio.sampleAccurate = config.AudioSampleAccurate;
+    miningOptions.audio.encoderProfile = config.AudioEncoderProfile;
+    miningOptions.imageMaxWidth = IMAGE_MAX_SIZE;
+    miningOptions.imageMaxHeight = IMAGE_MAX_SIZE;
+
+    AF_INFO("Mining {} lines of {}", cues.size(), options.videoPath);
+    auto candidates = miner.Start(options.videoPath, cues, miningOptions);
+
+    // The whole episode is translated in a few batched requests while the pass reads the file
+    std::vector<std::string_view> sentences;
+    sentences.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+      sentences.push_back(candidate.sentence);
+    }
+    auto pendingTranslations =
+        std::async(std::launch::async, [&analyzer, &sentences]() { return analyzer.TranslateSentences(sentences); });
+    std::vector<std::string> translations;
+
+    // Lines come out of the pass in order, adding one overlaps with mining the next ones
+    size_t added = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      auto& candidate = candidates[i];
+      nlohmann::json analysis = candidate.analysis.get();
+      if (analysis.is_null() || analysis.contains("error")) {
+        AF_WARN("Skipping line {}: analysis failed", i + 1);
+        ++failed;
+        continue;
+      }
+
+      if (pendingTranslations.valid()) {
+        translations = pendingTranslations.get();
+      }
+      analysis["translation"] = translations[i];
+      Utils::RawImage image = candidate.image.get();
+      Audio::AudioClip audio = candidate.audio.get();
+
+      if (options.dryRun) {
+        AF_INFO("[{}/{}] {} | {} | {} | image {}x{}, audio {} bytes",
+                i + 1,
+                candidates.size(),
+                candidate.sentence,
+                analysis.value("target_word", ""),
+                analysis.value("translation", ""),
+                image.width,
+                image.height,
+                audio.data.size());
+        ++added;
+        continue;
+      }
+
+      auto fields = BuildFields(anki, config, noteType, fieldNames, analysis, image, audio, i);
+      int64_t noteId = fields.empty() ? 0 : anki.AddNote(deck, noteType, fields, options.tags);
+      if (noteId > 0) {
+        AF_INFO("[{}/{}] Added note {}: {}", i + 1, candidates.size(), noteId, candidate.sentence);
+        ++added;
+      } else {
+        AF_ERROR("[{}/{}] Failed to add note: {}", i + 1, candidates.size(), candidate.sentence);
+        ++failed;
+      }
+    }
+
+    AF_INFO("Done: {} of {} lines {}, {} failed",
+            added,
+            candidates.size(),
+            options.dryRun ? "processed" : "added",
+            failed);
+    return failed == 0 ? 0 : 2;
+  }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  auto options = ParseArguments(argc, argv);
+  if (!options)
+    return 1;
+
+  return Run(*options);
+}
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+
+import shutil
+import subprocess
+import sys
+from pathlib import Path
+
+DURATION = 60
+LINE_SECONDS = 3.0
+LINE_GAP = 0.5
+
+SENTENCES = [
+    "今日はいい天気ですね。",
+    "駅の前で友達を待っています。",
+    "この本はとても面白かったです。",
+    "明日の朝、早く起きなければなりません。",
+    "彼女は毎日図書館で勉強している。",
+    "すみません、トイレはどこですか？",
+    "昨日の夜、雨が急に降り出した。",
+    "先生に宿題を出すのを忘れてしまった。",
+    "日本の夏は暑くて湿気が多い。",
+    "新しい仕事にはもう慣れましたか？",
+    "窓を開けてもいいですか？",
+    "子供の頃、よくこの公園で遊んだ。",
+    "電車が遅れたので、会議に間に合わなかった。",
+    "お腹が空いたから、何か食べに行こう。",
+    "それは本当に大切な約束だったんだ。",
+    "週末は家族と一緒に海へ行く予定です。",
+    "この道をまっすぐ行くと、病院があります。",
+    "彼の話を信じるかどうか、まだ決めていない。",
+    "疲れているなら、少し休んだほうがいい。",
+]
+
+
+def format_srt_time(seconds):
+    millis = int(round(seconds * 1000))
+    hours, millis = divmod(millis, 3600000)
+    minutes, millis = divmod(millis, 60000)
+    secs, millis = divmod(millis, 1000)
+    return f"{hours:02d}:{minutes:02d}:{secs:02d},{millis:03d}"
+
+
+def write_subtitles(srt_path):
+    lines = []
+    start = 1.0
+    index = 0
+    while start + LINE_SECONDS < DURATION:
+        sentence = SENTENCES[index % len(SENTENCES)]
+        end = start + LINE_SECONDS
+        lines.append(f"{index + 1}\n{format_srt_time(start)} --> {format_srt_time(end)}\n{sentence}\n")
+        start = end + LINE_GAP
+        index += 1
+
+    srt_path.write_text("\n".join(lines), encoding="utf-8")
+    print(f"Wrote {index} subtitle lines to {srt_path}")
+
+
+def has_encoder(ffmpeg, name):
+    result = subprocess.run([ffmpeg, "-hide_banner", "-encoders"], capture_output=True, text=True)
+    return any(line.split()[1:2] == [name] for line in result.stdout.splitlines() if line.strip())
+
+
+def run(command):
+    print(" ".join(str(part) for part in command))
+    subprocess.run(command, check=True)
+
+
+def main():
+    script_dir = Path(__file__).parent
+    project_root = script_dir.parent
+    output_dir = Path(sys.argv[1]) if len(sys.argv) > 1 else project_root / "bench" / "fixtures"
+
+    ffmpeg = shutil.which("ffmpeg")
+    if not ffmpeg:
+        print("Error: ffmpeg not found in PATH")
+        sys.exit(1)
+
+    output_dir.mkdir(parents=True, exist_ok=True)
+    srt_path = output_dir / "episode.ja.srt"
+    video_path = output_dir / "episode.mkv"
+    frame_path = output_dir / "frame.png"
+
+    write_subtitles(srt_path)
+
+    # A 720p test pattern with a keyframe every two seconds, like a typical episode, and a voiced tone that
+    # pauses between syllables instead of a flat sine so the audio encoders have something to work on
+    video_codec = ["-c:v", "libx264", "-preset", "veryfast", "-crf", "23"]
+    if not has_encoder(ffmpeg, "libx264"):
+        video_codec = ["-c:v", "mpeg4", "-q:v", "5"]
+
+    speech = (
+        "0.3*sin(2*PI*(160+30*sin(2*PI*0.4*t))*t)*lt(mod(t*4\\,1)\\,0.6)"
+        "|0.27*sin(2*PI*(160+30*sin(2*PI*0.4*t))*t)*lt(mod(t*4\\,1)\\,0.6)"
+    )
+
+    run([
+        ffmpeg, "-hide_banner", "-y",
+        "-f", "lavfi", "-i", f"testsrc2=size=1280x720:rate=24000/1001:duration={DURATION}",
+        "-f", "lavfi", "-i", f"aevalsrc={speech}:sample_rate=48000:duration={DURATION}",
+        "-i", str(srt_path),
+        "-map", "0:v", "-map", "1:a", "-map", "2:s",
+        *video_codec, "-g", "48", "-pix_fmt", "yuv420p",
+        "-c:a", "aac", "-b:a", "128k",
+        "-c:s", "srt", "-metadata:s:s:0", "language=jpn",
+        str(video_path),
+    ])
+
+    run([
+        ffmpeg, "-hide_banner", "-y",
+        "-f", "lavfi", "-i", "testsrc2=size=1280x720",
+        "-frames:v", "1",
+        str(frame_path),
+    ])
+
+    print(f"\nFixtures written to {output_dir}")
+    print("The dictionary benchmarks also need assets/jmdict.db and assets/pitch_accent.db,")
+    print("see scripts/convert_jmdict.py and scripts/convert_pitch_accent.py")
+
+
+if __name__ == "__main__":
+    main()
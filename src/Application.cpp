@@ -8,14 +8,21 @@
 #include <imgui_internal.h>
 #include <imgui_stdlib.h>
 
+#include <algorithm>
 #include <chrono>
+#include <format>
 #include <httplib.h>
 #include <iostream>
+#include <optional>
 #include <thread>
 
 #include "api/AnkiConnectClient.h"
 #include "config/ConfigManager.h"
+#include "core/BatchMiner.h"
+#include "core/ExtractionPrefetcher.h"
+#include "core/FrameScheduler.h"
 #include "core/Logger.h"
+#include "core/ThreadPool.h"
 #include "core/sdl/SDLWrappers.h"
 #include "language/ILanguage.h"
 #include "language/JapaneseLanguage.h"
@@ -24,19 +31,106 @@
 #include "language/services/DeepLService.h"
 #include "language/services/GoogleTranslateService.h"
 #include "ui/AnkiCardSettingsSection.h"
+#include "ui/BatchMiningSection.h"
 #include "ui/ConfigurationSection.h"
 #include "ui/StatusSection.h"
 #include "ui/VideoSection.h"
 #include "utils/FileUtils.h"
 #include "utils/LastVideoPath.h"
+#include "video/SubtitleIndex.h"
 
-#define STB_IMAGE_IMPLEMENTATION
 #include "IconsFontAwesome6.h"
 #include "stb_image.h"
 
 namespace Video2Card
 {
 
+  namespace
+  {
+    // Longest each network stage of an extraction may hold up the card, on top of the clients' own timeouts
+    constexpr auto TRANSLATION_TIMEOUT = std::chrono::seconds(15);
+    constexpr auto VOCAB_AUDIO_TIMEOUT = std::chrono::seconds(25);
+
+    // Threads for the network stages of extractions, they mostly wait on sockets
+    constexpr size_t NETWORK_THREADS = 4;
+
+    // Lines per batched translation when a mined episode is translated ahead of its Extracts
+    constexpr size_t PRETRANSLATION_CHUNK = 50;
+
+    struct VocabAudio
+    {
+      std::vector<unsigned char> data;
+      std::string filename;
+    };
+
+    /**
+     * Search Forvo for a word and download the first pronunciation
+     * @return The audio, empty if there is none or the download failed
+     */
+    VocabAudio DownloadVocabAudio(Language::Audio::ForvoClient& forvo, const std::string& word)
+    {
+      AF_INFO("Searching Forvo for vocab audio: {}", word);
+      auto audioResults = forvo.SearchAudio(word, word, "");
+
+      if (audioResults.empty()) {
+        AF_INFO("No vocab audio found on Forvo for: {}", word);
+        return {};
+      }
+
+      try {
+        std::string audioUrl = audioResults[0].url;
+        if (audioUrl.find("https://") == 0) {
+          audioUrl = audioUrl.substr(8);
+        }
+
+        size_t slashPos = audioUrl.find('/');
+        if (slashPos == std::string::npos)
+          return {};
+
+        std::string host = audioUrl.substr(0, slashPos);
+        std::string path = audioUrl.substr(slashPos);
+
+        httplib::SSLClient audioClient(host.c_str());
+        audioClient.set_connection_timeout(10, 0);
+        audioClient.set_read_timeout(10, 0);
+
+        auto res = audioClient.Get(path.c_str());
+        if (res && res->status == 200) {
+          VocabAudio audio{std::vector<unsigned char>(res->body.begin(), res->body.end()), audioResults[0].filename};
+          AF_INFO("Downloaded vocab audio: {} ({} bytes)", audio.filename, audio.data.size());
+          return audio;
+        }
+        AF_WARN("Failed to download vocab audio from: {}", audioUrl);
+      } catch (const std::exception& e) {
+        AF_ERROR("Failed to download vocab audio: {}", e.what());
+      }
+      return {};
+    }
+
+    /**
+     * Wait for a stage of an extraction, giving up after a timeout
+     * @return The stage's result, a default value if it failed or timed out
+     */
+    template <typename Result, typename Duration>
+    Result JoinStage(std::future<Result>& stage, Duration timeout, const char* name)
+    {
+      if (!stage.valid())
+        return Result{};
+
+      if (stage.wait_for(timeout) != std::future_status::ready) {
+        AF_WARN("{} took too long, the card is filled without it", name);
+        return Result{};
+      }
+
+      try {
+        return stage.get();
+      } catch (const std::exception& e) {
+        AF_WARN("{} failed: {}", name, e.what());
+        return Result{};
+      }
+    }
+  } // namespace
+
   void SDLWindowDeleter::operator()(SDL_Window* window) const
   {
     if (window) {
@@ -71,9 +165,14 @@ namespace Video2Card
     }
 
     while (m_IsRunning) {
+      m_FrameScheduler->WaitForNextFrame();
+      m_FrameScheduler->BeginFrame();
+
       HandleEvents();
       Update();
       Render();
+
+      m_FrameScheduler->EndFrame();
     }
   }
 
@@ -105,6 +204,15 @@ namespace Video2Card
       return false;
     }
 
+    // Present at display refresh, the frame scheduler takes care of not rendering at all when nothing changes
+    if (!SDL_SetRenderVSync(m_Renderer.get(), 1)) {
+      AF_WARN("Failed to enable vsync: {}", SDL_GetError());
+    }
+
+    m_FrameScheduler = std::make_unique<Core::FrameScheduler>();
+    m_FrameScheduler->Initialize();
+    UpdateDisplayRefreshRate();
+
     SDL_SetWindowPosition(m_Window.get(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED);
 
     {
@@ -282,7 +390,29 @@ namespace Video2Card
       }
     });
 
+    m_Prefetcher = std::make_unique<Core::ExtractionPrefetcher>(
+        [this](double timestamp, std::stop_token cancel) {
+          return m_VideoSection->RequestFrameImage(timestamp, std::move(cancel));
+        },
+        [this](double start, double end, std::stop_token cancel) {
+          return m_VideoSection->RequestAudioClip(start, end, std::move(cancel));
+        },
+        [this](const std::string& sentence) { return m_SentenceAnalyzer->AnalyzeLocally(sentence, ""); });
+
+    m_ThreadPool = std::make_unique<Core::ThreadPool>();
+    m_NetworkPool = std::make_unique<Core::ThreadPool>(NETWORK_THREADS);
+    m_BatchMiner = std::make_unique<Core::BatchMiner>(*m_ThreadPool, [this](const std::string& sentence) {
+      return m_SentenceAnalyzer->AnalyzeLocally(sentence, "");
+    });
+    m_BatchMiningSection = std::make_unique<UI::BatchMiningSection>(m_BatchMiner.get());
+    m_BatchMiningSection->SetOnMineCallback([this]() { OnMineEpisode(); });
+    m_BatchMiningSection->SetOnExtractCallback(
+        [this](const Core::PreparedCue& candidate) { OnExtractCandidate(candidate); });
+    m_BatchMiningSection->SetOnSeekCallback([this](double timestamp) { m_VideoSection->SeekAbsolute(timestamp); });
+
     m_VideoSection->SetOnExtractCallback([this]() { OnExtract(); });
+    m_VideoSection->SetOnSeekCallback([this]() { m_Prefetcher->Cancel(); });
+    m_VideoSection->SetOnFrameReadyCallback([this]() { m_FrameScheduler->RequestWake(); });
 
     LoadWindowState();
 
@@ -314,6 +444,19 @@ namespace Video2Card
     SaveWindowState();
     CancelAsyncTasks();
 
+    // Its worker may still be analyzing, and it requests from the video section
+    m_Prefetcher.reset();
+
+    // The miner's thread reads the file and the pool drains the jobs it queued, which still use the analyzer
+    m_BatchMiningSection.reset();
+    m_BatchMiner.reset();
+    m_ThreadPool.reset();
+
+    // Translations and Forvo downloads that outlived their extraction still use the analyzer and the client
+    if (m_BatchTranslationCancelled)
+      m_BatchTranslationCancelled->store(true);
+    m_NetworkPool.reset();
+
     m_VideoSection.reset();
     m_ConfigurationSection.reset();
     m_AnkiCardSettingsSection.reset();
@@ -333,12 +476,20 @@ namespace Video2Card
   {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
+      // Wake events only end the scheduler's wait, there is nothing to handle
+      if (m_FrameScheduler->IsWakeEvent(event))
+        continue;
+
+      m_FrameScheduler->NotifyInput();
       ImGui_ImplSDL3_ProcessEvent(&event);
       if (event.type == SDL_EVENT_QUIT)
         m_IsRunning = false;
       if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED && event.window.windowID == SDL_GetWindowID(m_Window.get()))
         m_IsRunning = false;
 
+      if (event.type == SDL_EVENT_WINDOW_DISPLAY_CHANGED)
+        UpdateDisplayRefreshRate();
+
       // Handle file drop
       if (event.type == SDL_EVENT_DROP_FILE) {
         if (m_VideoSection && event.drop.data) {
@@ -348,9 +499,33 @@ namespace Video2Card
     }
   }
 
+  void Application::UpdateDisplayRefreshRate()
+  {
+    SDL_DisplayID display = SDL_GetDisplayForWindow(m_Window.get());
+    const SDL_DisplayMode* mode = display ? SDL_GetCurrentDisplayMode(display) : nullptr;
+    m_FrameScheduler->SetDisplayRefreshRate(mode ? mode->refresh_rate : 0.0f);
+  }
+
   void Application::Update()
   {
     UpdateAsyncTasks();
+    UpdatePendingSnapshot();
+
+    bool hasTasks = false;
+    {
+      std::lock_guard<std::mutex> lock(m_TaskMutex);
+      hasTasks = !m_ActiveTasks.empty();
+    }
+    bool batchBusy = m_BatchMiningSection && m_BatchMiningSection->IsBusy();
+    m_FrameScheduler->SetBusy(hasTasks || m_PendingImage.valid() || m_IsExtracting.load() || m_IsProcessing.load() ||
+                              batchBusy);
+    if (m_VideoSection) {
+      m_FrameScheduler->SetPlayback(m_VideoSection->IsPlaying(), m_VideoSection->GetFrameRate());
+    }
+    if (m_StatusSection) {
+      m_StatusSection->SetFrameStats(Core::FrameScheduler::ModeToString(m_FrameScheduler->GetMode()),
+                                     m_FrameScheduler->GetStats());
+    }
 
     ImGui_ImplSDLRenderer3_NewFrame();
     ImGui_ImplSDL3_NewFrame();
@@ -358,6 +533,8 @@ namespace Video2Card
 
     if (m_VideoSection)
       m_VideoSection->Update();
+    UpdatePrefetch();
+    UpdateBatchMining();
   }
 
   void Application::Render()
@@ -395,6 +572,7 @@ namespace Video2Card
       ImGui::DockBuilderDockWindow("Card", dock_right_id);
       ImGui::DockBuilderDockWindow("AnkiConnect", dock_right_id);
       ImGui::DockBuilderDockWindow("Translation", dock_right_id);
+      ImGui::DockBuilderDockWindow("Batch Mining", dock_right_id);
       ImGui::DockBuilderDockWindow("Status", dock_bottom_id);
 
       ImGuiDockNode* node = ImGui::DockBuilderGetNode(dock_main_id);
@@ -431,15 +609,18 @@ namespace Video2Card
       ImGui::End();
     }
 
+    if (m_BatchMiningSection)
+      m_BatchMiningSection->Render();
+
     if (m_StatusSection)
       m_StatusSection->Render();
   }
 
-  void Application::OnExtract()
+  bool Application::CanExtract()
   {
     if (m_IsExtracting.load()) {
       AF_WARN("Extraction already in progress, ignoring request.");
-      return;
+      return false;
     }
 
     AF_INFO("Starting Extraction...");
@@ -450,47 +631,89 @@ namespace Video2Card
       if (m_StatusSection)
         m_StatusSection->SetStatus("Error: Anki is not connected.");
       AF_ERROR("Anki is not connected.");
-      return;
+      return false;
     }
+    return true;
+  }
 
-    // 1. Get current timestamp (implicitly used for audio/image)
-    // 2. Take current frame as image
-    m_ExtractedImage = m_VideoSection->GetCurrentFrameImage();
-    if (m_ExtractedImage.empty()) {
-      AF_ERROR("Failed to extract image from video.");
-      if (m_StatusSection)
-        m_StatusSection->SetStatus("Error: Failed to extract image.");
+  void Application::OnExtract()
+  {
+    if (!CanExtract())
       return;
-    }
 
-    // 3. Extract sentence from current sub
+    // 1. Extract sentence from current sub
     auto subtitle = m_VideoSection->GetCurrentSubtitle();
-    m_ExtractSentence = subtitle.text;
-    for (auto& c : m_ExtractSentence) {
-      if (c == '\n' || c == '\r')
-        c = ' ';
+    m_ExtractSentence = Video::ToSingleLine(subtitle.text);
+    m_ExtractedImage = {};
+
+    // A prefetched line already has its snapshot, audio and local analysis on the way (or done)
+    std::optional<Core::PreparedCue> prefetched;
+    if (m_Prefetcher && subtitle.timed) {
+      prefetched = m_Prefetcher->Find(m_ExtractSentence, subtitle.start, subtitle.end);
     }
 
-    // 4. Extract audio from specific sub
-    if (subtitle.end > subtitle.start) {
-      m_ExtractedAudio = m_VideoSection->GetAudioClip(subtitle.start, subtitle.end);
+    if (prefetched) {
+      AF_INFO("Using the prefetched snapshot, audio and analysis");
+      UsePreparedCue(*prefetched);
     } else {
-      // Fallback if no subtitle timing, grab 5 seconds around current time?
-      // Or just don't grab audio.
-      double current = m_VideoSection->GetCurrentTimestamp();
-      m_ExtractedAudio = m_VideoSection->GetAudioClip(current, current + 5.0);
+      m_PrefetchedSentence.clear();
+      m_PrefetchedAnalysis = {};
+
+      // 2. Decode the frame in the middle of the line in the background, it lands in the card when ready
+      double snapshotTime = m_VideoSection->GetCurrentTimestamp();
+      if (subtitle.end > subtitle.start) {
+        snapshotTime = (subtitle.start + subtitle.end) / 2.0;
+      }
+      m_PendingImage = m_VideoSection->RequestFrameImage(snapshotTime).share();
+
+      // 3. Extract audio from specific sub, also in the background
+      if (subtitle.end > subtitle.start) {
+        m_PendingAudio = m_VideoSection->RequestAudioClip(subtitle.start, subtitle.end).share();
+      } else {
+        // Fallback if no subtitle timing, grab 5 seconds around current time?
+        // Or just don't grab audio.
+        double current = m_VideoSection->GetCurrentTimestamp();
+        m_PendingAudio = m_VideoSection->RequestAudioClip(current, current + 5.0).share();
+      }
     }
 
-    // 5. Show the modal
+    // 4. Show the modal
+    OpenExtractModal();
+  }
+
+  void Application::OnExtractCandidate(const Core::PreparedCue& candidate)
+  {
+    if (!CanExtract())
+      return;
+
+    m_ExtractSentence = candidate.sentence;
+    m_ExtractedImage = {};
+    UsePreparedCue(candidate);
+
+    // A line whose stream copy failed during the run gets its audio the regular way
+    bool audioReady =
+        m_PendingAudio.valid() && m_PendingAudio.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    if (audioReady && m_PendingAudio.get().IsEmpty() && m_VideoSection->GetCurrentVideoPath() == m_BatchVideoPath) {
+      m_PendingAudio = m_VideoSection->RequestAudioClip(candidate.start, candidate.end).share();
+    }
+
+    OpenExtractModal();
+  }
+
+  void Application::UsePreparedCue(const Core::PreparedCue& cue)
+  {
+    m_PendingImage = cue.image;
+    m_PendingAudio = cue.audio;
+    m_PrefetchedSentence = cue.sentence;
+    m_PrefetchedAnalysis = cue.analysis;
+  }
+
+  void Application::OpenExtractModal()
+  {
     m_ExtractTargetWord = "";
     m_ShowExtractModal = true;
     m_OpenExtractModal = true;
 
-    // Auto-fill Image field immediately
-    if (m_AnkiCardSettingsSection) {
-      m_AnkiCardSettingsSection->SetFieldByTool(7, m_ExtractedImage, "image.webp");
-    }
-
     if (m_StatusSection)
       m_StatusSection->SetStatus("Extraction complete. Please verify data.");
   }
@@ -598,8 +821,20 @@ namespace Video2Card
 
     std::string sentence = m_ExtractSentence;
     std::string targetWord = m_ExtractTargetWord;
-    std::vector<unsigned char> audioData = m_ExtractedAudio;
-    std::vector<unsigned char> imageData = m_ExtractedImage;
+    std::shared_future<Audio::AudioClip> pendingAudio = m_PendingAudio;
+    std::shared_future<Utils::RawImage> pendingImage = m_PendingImage;
+    if (!pendingImage.valid()) {
+      // Already decoded, hand it over the same way
+      std::promise<Utils::RawImage> decoded;
+      decoded.set_value(m_ExtractedImage);
+      pendingImage = decoded.get_future().share();
+    }
+
+    // The local analysis of a prefetched line assumed the unedited sentence and an automatically chosen target word
+    std::shared_future<nlohmann::json> cached;
+    if (targetWord.empty() && sentence == m_PrefetchedSentence) {
+      cached = m_PrefetchedAnalysis;
+    }
 
     m_IsProcessing.store(true);
 
@@ -614,19 +849,26 @@ namespace Video2Card
 
     AsyncTask task;
     task.description = "Extract Processing";
-    task.future = std::async(std::launch::async, [this, sentence, targetWord, audioData, imageData]() {
+    task.future = std::async(std::launch::async, [this, sentence, targetWord, pendingAudio, pendingImage, cached]() {
       try {
         if (m_CancelRequested.load()) {
           AF_INFO("Processing task cancelled before starting.");
           return;
         }
+
+        // The stages run side by side, so the card takes as long as the slowest of them instead of their sum:
+        // the translation starts right away, the local analysis runs meanwhile on this thread, the snapshot and
+        // audio keep decoding in the background and Forvo starts as soon as the target word is known
+        std::future<std::string> pendingTranslation =
+            m_NetworkPool->Submit([this, sentence]() { return m_SentenceAnalyzer->TranslateSentence(sentence); });
+
         AF_INFO("Analyzing sentence...");
         AF_DEBUG("Sentence: '{}', Target Word: '{}'", sentence, targetWord);
-        nlohmann::json analysis = m_SentenceAnalyzer->AnalyzeSentence(sentence, targetWord, m_ActiveLanguage);
-
-        if (m_CancelRequested.load()) {
-          AF_INFO("Processing task cancelled after analysis.");
-          return;
+        nlohmann::json analysis = cached.valid() ? cached.get() : nlohmann::json();
+        if (!analysis.is_null() && !analysis.contains("error")) {
+          AF_INFO("Using the prefetched analysis, translating only");
+        } else {
+          analysis = m_SentenceAnalyzer->AnalyzeLocally(sentence, targetWord, m_ActiveLanguage);
         }
 
         AF_DEBUG("Analysis Response: {}", analysis.dump());
@@ -635,14 +877,33 @@ namespace Video2Card
           throw std::runtime_error("Text analysis failed.");
         }
 
+        std::string analyzedTargetWord = analysis.value("target_word", "");
+        std::future<VocabAudio> pendingVocabAudio;
+        if (m_ForvoClient && !analyzedTargetWord.empty()) {
+          pendingVocabAudio = m_NetworkPool->Submit(
+              [this, analyzedTargetWord]() { return DownloadVocabAudio(*m_ForvoClient, analyzedTargetWord); });
+        }
+
+        Utils::RawImage image = pendingImage.get();
+        Audio::AudioClip audioClip = pendingAudio.valid() ? pendingAudio.get() : Audio::AudioClip{};
+
         if (m_StatusSection)
           m_StatusSection->SetProgress(0.5f);
 
+        if (!analysis.contains("error")) {
+          analysis["translation"] = JoinStage(pendingTranslation, TRANSLATION_TIMEOUT, "Translation");
+        }
+        VocabAudio vocabAudio = JoinStage(pendingVocabAudio, VOCAB_AUDIO_TIMEOUT, "Vocab audio");
+
+        if (m_CancelRequested.load()) {
+          AF_INFO("Processing task cancelled after analysis.");
+          return;
+        }
+
         AF_INFO("Analysis Result: {}", analysis.dump());
 
         std::string analyzedSentence = analysis.value("sentence", "");
         std::string translation = analysis.value("translation", "");
-        std::string analyzedTargetWord = analysis.value("target_word", "");
         std::string targetWordFurigana = analysis.value("target_word_furigana", "");
         std::string furigana = analysis.value("furigana", "");
         std::string definition = analysis.value("definition", "");
@@ -656,8 +917,9 @@ namespace Video2Card
                              furigana,
                              definition,
                              pitch,
-                             imageData,
-                             audioData,
+                             image,
+                             audioClip,
+                             vocabAudio,
                              targetWord]() {
           if (m_AnkiCardSettingsSection) {
             AF_INFO("Setting fields in Anki Card Settings...");
@@ -671,54 +933,18 @@ namespace Video2Card
             m_AnkiCardSettingsSection->SetFieldByTool(5, pitch);
             m_AnkiCardSettingsSection->SetFieldByTool(6, definition);
 
-            if (!imageData.empty()) {
-              m_AnkiCardSettingsSection->SetFieldByTool(7, imageData, "image.webp");
+            if (!image.IsEmpty()) {
+              m_AnkiCardSettingsSection->SetFieldByTool(7, image, "image.webp");
             }
 
-            if (m_ForvoClient && !analyzedTargetWord.empty()) {
-              AF_INFO("Searching Forvo for vocab audio: {}", analyzedTargetWord);
-              auto audioResults = m_ForvoClient->SearchAudio(analyzedTargetWord, analyzedTargetWord, "");
-
-              if (!audioResults.empty()) {
-                try {
-                  httplib::SSLClient cli("forvo.com");
-                  cli.set_connection_timeout(10, 0);
-                  cli.set_read_timeout(10, 0);
-
-                  std::string audioUrl = audioResults[0].url;
-                  if (audioUrl.find("https://") == 0) {
-                    audioUrl = audioUrl.substr(8);
-                  }
-
-                  size_t slashPos = audioUrl.find('/');
-                  if (slashPos != std::string::npos) {
-                    std::string host = audioUrl.substr(0, slashPos);
-                    std::string path = audioUrl.substr(slashPos);
-
-                    httplib::SSLClient audioClient(host.c_str());
-                    audioClient.set_connection_timeout(10, 0);
-                    audioClient.set_read_timeout(10, 0);
-
-                    auto res = audioClient.Get(path.c_str());
-                    if (res && res->status == 200) {
-                      std::vector<unsigned char> vocabAudioData(res->body.begin(), res->body.end());
-                      m_AnkiCardSettingsSection->SetFieldByTool(8, vocabAudioData, audioResults[0].filename);
-                      AF_INFO("Downloaded vocab audio: {} ({} bytes)", audioResults[0].filename, vocabAudioData.size());
-                    } else {
-                      AF_WARN("Failed to download vocab audio from: {}", audioUrl);
-                    }
-                  }
-                } catch (const std::exception& e) {
-                  AF_ERROR("Failed to download vocab audio: {}", e.what());
-                }
-              } else {
-                AF_INFO("No vocab audio found on Forvo for: {}", analyzedTargetWord);
-              }
+            if (!vocabAudio.data.empty()) {
+              // 8: Vocab Audio
+              m_AnkiCardSettingsSection->SetFieldByTool(8, vocabAudio.data, vocabAudio.filename);
             }
 
-            if (!audioData.empty()) {
+            if (!audioClip.IsEmpty()) {
               // 9: Sentence Audio
-              m_AnkiCardSettingsSection->SetFieldByTool(9, audioData, "sentence.ogg");
+              m_AnkiCardSettingsSection->SetFieldByTool(9, audioClip.data, "sentence." + audioClip.extension);
             }
           } else {
             AF_WARN("AnkiCardSettingsSection is null, cannot set fields.");
@@ -739,6 +965,9 @@ namespace Video2Card
         std::lock_guard<std::mutex> lock(m_ResultMutex);
         m_LastError = "Processing failed with unknown error.";
       }
+
+      // Let the main loop pick up the result right away instead of on its next idle timeout
+      m_FrameScheduler->RequestWake();
     });
 
     task.onComplete = [this]() {
@@ -920,6 +1149,119 @@ namespace Video2Card
     }
   }
 
+  void Application::UpdatePrefetch()
+  {
+    if (!m_Prefetcher || !m_VideoSection)
+      return;
+
+    const std::string& videoPath = m_VideoSection->GetCurrentVideoPath();
+    if (videoPath != m_PrefetchVideoPath) {
+      m_Prefetcher->Clear();
+      m_PrefetchVideoPath = videoPath;
+    }
+
+    if (videoPath.empty() || !m_ConfigManager->GetConfig().PrefetchExtraction)
+      return;
+
+    // The prefetcher works on the newest line first, so the one on screen goes in last
+    UI::SubtitleData next = m_VideoSection->GetNextSubtitle();
+    if (next.timed) {
+      m_Prefetcher->Prefetch(Video::ToSingleLine(next.text), next.start, next.end);
+    }
+
+    UI::SubtitleData subtitle = m_VideoSection->GetCurrentSubtitle();
+    if (subtitle.timed) {
+      m_Prefetcher->Prefetch(Video::ToSingleLine(subtitle.text), subtitle.start, subtitle.end);
+    }
+  }
+
+  void Application::OnMineEpisode()
+  {
+    const std::string& videoPath = m_VideoSection->GetCurrentVideoPath();
+    if (videoPath.empty()) {
+      if (m_StatusSection)
+        m_StatusSection->SetStatus("Load a video to mine first.");
+      return;
+    }
+
+    std::vector<Video::SubtitleCue> cues;
+    for (const auto& subtitle : m_VideoSection->GetAllSubtitles()) {
+      cues.push_back({subtitle.start, subtitle.end, Video::ToSingleLine(subtitle.text)});
+    }
+
+    if (cues.empty()) {
+      // Lines come from the subtitle index, which only text subtitle tracks have
+      if (m_StatusSection)
+        m_StatusSection->SetStatus("No subtitle lines to mine, select a text subtitle track.");
+      return;
+    }
+
+    Core::MiningOptions options;
+    options.audio = m_VideoSection->GetAudioClipOptions();
+    m_BatchMiningSection->SetCandidates(m_BatchMiner->Start(videoPath, cues, options));
+    m_BatchVideoPath = videoPath;
+
+    // With prefetching on, the episode is also translated in batched requests, so the Extract of any of its
+    // lines finds the translation in the cache. A single job, the Extracts still get the other network threads.
+    if (m_BatchTranslationCancelled)
+      m_BatchTranslationCancelled->store(true);
+    m_BatchTranslationCancelled = std::make_shared<std::atomic<bool>>(false);
+    if (m_ConfigManager->GetConfig().PrefetchExtraction) {
+      std::vector<std::string> sentences;
+      for (const auto& cue : cues) {
+        sentences.push_back(cue.text);
+      }
+
+      m_NetworkPool->Submit(
+          [this, sentences = std::move(sentences), cancelled = m_BatchTranslationCancelled]() {
+            for (size_t begin = 0; begin < sentences.size() && !cancelled->load(); begin += PRETRANSLATION_CHUNK) {
+              size_t end = std::min(sentences.size(), begin + PRETRANSLATION_CHUNK);
+              std::vector<std::string_view> chunk(sentences.begin() + begin, sentences.begin() + end);
+              auto translations = m_SentenceAnalyzer->TranslateSentences(chunk);
+              (void) translations;
+            }
+          });
+    }
+
+    if (m_StatusSection)
+      m_StatusSection->SetStatus(std::format("Mining {} subtitle lines...", cues.size()));
+  }
+
+  void Application::UpdateBatchMining()
+  {
+    if (!m_BatchMiner || m_BatchVideoPath.empty())
+      return;
+
+    // The review list belongs to one video
+    if (m_VideoSection->GetCurrentVideoPath() != m_BatchVideoPath) {
+      m_BatchMiner->Cancel();
+      if (m_BatchTranslationCancelled)
+        m_BatchTranslationCancelled->store(true);
+      m_BatchMiningSection->Clear();
+      m_BatchVideoPath.clear();
+    }
+  }
+
+  void Application::UpdatePendingSnapshot()
+  {
+    if (!m_PendingImage.valid() || m_PendingImage.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      return;
+
+    m_ExtractedImage = m_PendingImage.get();
+    m_PendingImage = {};
+
+    if (m_ExtractedImage.IsEmpty()) {
+      AF_ERROR("Failed to extract image from video.");
+      if (m_StatusSection)
+        m_StatusSection->SetStatus("Warning: Failed to extract image.");
+      return;
+    }
+
+    if (m_AnkiCardSettingsSection) {
+      m_AnkiCardSettingsSection->SetFieldByTool(7, m_ExtractedImage, "image.webp");
+    }
+  }
+
   void Application::CancelAsyncTasks()
   {
     m_CancelRequested.store(true);
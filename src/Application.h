@@ -5,10 +5,14 @@
 #include <future>
 #include <memory>
 #include <mutex>
+#include <nlohmann/json.hpp>
 #include <queue>
 #include <string>
 #include <vector>
 
+#include "audio/AudioClip.h"
+#include "utils/RawImage.h"
+
 struct SDL_Window;
 struct SDL_Renderer;
 
@@ -31,6 +35,7 @@ namespace Video2Card::UI
   class ConfigurationSection;
   class AnkiCardSettingsSection;
   class StatusSection;
+  class BatchMiningSection;
 } // namespace Video2Card::UI
 
 namespace Video2Card::API
@@ -63,6 +68,15 @@ namespace Video2Card::Config
   class ConfigManager;
 }
 
+namespace Video2Card::Core
+{
+  class FrameScheduler;
+  class ExtractionPrefetcher;
+  class ThreadPool;
+  class BatchMiner;
+  struct PreparedCue;
+} // namespace Video2Card::Core
+
 namespace Video2Card
 {
 
@@ -84,11 +98,16 @@ private:
     void Shutdown();
 
     void HandleEvents();
+    void UpdateDisplayRefreshRate();
     void Update();
     void Render();
     void RenderUI();
 
     void OnExtract();
+    void OnExtractCandidate(const Core::PreparedCue& candidate);
+    bool CanExtract();
+    void UsePreparedCue(const Core::PreparedCue& cue);
+    void OpenExtractModal();
     void RenderExtractModal();
     void ProcessExtract();
 
@@ -98,6 +117,10 @@ private:
     void LoadWindowState();
 
     void UpdateAsyncTasks();
+    void UpdatePendingSnapshot();
+    void UpdatePrefetch();
+    void OnMineEpisode();
+    void UpdateBatchMining();
     void CancelAsyncTasks();
 
     std::string m_Title;
@@ -107,6 +130,7 @@ private:
 
     std::unique_ptr<SDL_Window, SDLWindowDeleter> m_Window;
     std::unique_ptr<SDL_Renderer, SDLRendererDeleter> m_Renderer;
+    std::unique_ptr<Core::FrameScheduler> m_FrameScheduler;
 
     std::string m_BasePath;
 
@@ -114,6 +138,7 @@ private:
     std::unique_ptr<UI::ConfigurationSection> m_ConfigurationSection;
     std::unique_ptr<UI::AnkiCardSettingsSection> m_AnkiCardSettingsSection;
     std::unique_ptr<UI::StatusSection> m_StatusSection;
+    std::unique_ptr<UI::BatchMiningSection> m_BatchMiningSection;
 
     std::unique_ptr<API::AnkiConnectClient> m_AnkiConnectClient;
     std::unique_ptr<Config::ConfigManager> m_ConfigManager;
@@ -131,8 +156,25 @@ private:
     std::string m_ExtractTargetWord;
 
     // Data extracted from video for the card
-    std::vector<unsigned char> m_ExtractedImage;
-    std::vector<unsigned char> m_ExtractedAudio;
+    Utils::RawImage m_ExtractedImage;
+
+    // Snapshot and sentence audio still being decoded for the current extraction
+    std::shared_future<Utils::RawImage> m_PendingImage;
+    std::shared_future<Audio::AudioClip> m_PendingAudio;
+
+    // Local analysis of the extracted line if it was prefetched, reused unless the sentence or target word change
+    std::unique_ptr<Core::ExtractionPrefetcher> m_Prefetcher;
+    std::string m_PrefetchVideoPath;
+    std::string m_PrefetchedSentence;
+    std::shared_future<nlohmann::json> m_PrefetchedAnalysis;
+
+    // Encoding and analysis jobs of the batch miner
+    std::unique_ptr<Core::ThreadPool> m_ThreadPool;
+    // Translation and Forvo stages of extractions, separate so a slow server never holds up encoding
+    std::unique_ptr<Core::ThreadPool> m_NetworkPool;
+    std::unique_ptr<Core::BatchMiner> m_BatchMiner;
+    std::string m_BatchVideoPath; // Video the review list belongs to
+    std::shared_ptr<std::atomic<bool>> m_BatchTranslationCancelled;
 
     struct AsyncTask
     {
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Video2Card::Audio
+{
+
+  /**
+   * How a sentence clip is cut from the video
+   */
+  struct AudioClipOptions
+  {
+    // Copy the source packets into a new container when Anki can play the codec as it is
+    bool streamCopy = true;
+    // Trim to the exact sample at both ends. Stream copy can only cut on packet boundaries, so this forces a
+    // transcode.
+    bool sampleAccurate = false;
+    // Id of the encoder profile used when the clip is transcoded, see AudioClipEncoder::GetProfiles()
+    std::string encoderProfile;
+  };
+
+  /**
+   * An encoded audio clip and the file extension matching its container
+   */
+  struct AudioClip
+  {
+    std::vector<unsigned char> data;
+    std::string extension = "ogg";
+
+    bool IsEmpty() const { return data.empty(); }
+  };
+
+} // namespace Video2Card::Audio
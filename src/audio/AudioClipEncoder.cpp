@@ -0,0 +1,244 @@
+#include "audio/AudioClipEncoder.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+}
+
+#include <array>
+#include <cstdlib>
+#include <string>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Audio
+{
+
+  static constexpr int IO_BUFFER_SIZE = 4096;
+
+  namespace
+  {
+    // Speech survives far lower rates than music, the Opus speech profile is about a tenth of the Vorbis one
+    constexpr std::array<AudioEncoderProfile, 4> PROFILES = {{
+        {"compat-vorbis", "Compatible (Vorbis 128 kbit/s stereo)", "vorbis", "ogg", "ogg", 44100, 2, 128000},
+        {"speech-opus", "Speech (Opus 32 kbit/s mono)", "opus", "opus", "opus", 24000, 1, 32000},
+        {"stereo-opus", "Stereo (Opus 96 kbit/s)", "opus", "opus", "opus", 48000, 2, 96000},
+        {"speech-mp3", "Legacy speech (MP3 64 kbit/s mono)", "mp3", "mp3", "mp3", 22050, 1, 64000},
+    }};
+
+    constexpr size_t DEFAULT_PROFILE = 0;
+
+    // Encoders list what they accept, terminated by a sentinel. A null list means anything goes.
+    const AVSampleFormat* GetSampleFormats(const AVCodecContext* context, const AVCodec* codec)
+    {
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(61, 13, 100)
+      const void* formats = nullptr;
+      if (avcodec_get_supported_config(context, codec, AV_CODEC_CONFIG_SAMPLE_FORMAT, 0, &formats, nullptr) < 0)
+        return nullptr;
+      return static_cast<const AVSampleFormat*>(formats);
+#else
+      (void) context;
+      return codec->sample_fmts;
+#endif
+    }
+
+    const int* GetSampleRates(const AVCodecContext* context, const AVCodec* codec)
+    {
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(61, 13, 100)
+      const void* rates = nullptr;
+      if (avcodec_get_supported_config(context, codec, AV_CODEC_CONFIG_SAMPLE_RATE, 0, &rates, nullptr) < 0)
+        return nullptr;
+      return static_cast<const int*>(rates);
+#else
+      (void) context;
+      return codec->supported_samplerates;
+#endif
+    }
+
+    AVSampleFormat PickSampleFormat(const AVCodecContext* context, const AVCodec* codec)
+    {
+      // Planar float is what the resampler and most encoders prefer, otherwise take the encoder's first choice
+      const AVSampleFormat* formats = GetSampleFormats(context, codec);
+      if (!formats || *formats == AV_SAMPLE_FMT_NONE)
+        return AV_SAMPLE_FMT_FLTP;
+
+      for (const auto* format = formats; *format != AV_SAMPLE_FMT_NONE; ++format) {
+        if (*format == AV_SAMPLE_FMT_FLTP)
+          return AV_SAMPLE_FMT_FLTP;
+      }
+      return formats[0];
+    }
+
+    int PickSampleRate(const AVCodecContext* context, const AVCodec* codec, int wanted)
+    {
+      const int* rates = GetSampleRates(context, codec);
+      if (!rates || *rates == 0)
+        return wanted;
+
+      int best = rates[0];
+      for (const auto* rate = rates; *rate != 0; ++rate) {
+        if (std::abs(*rate - wanted) < std::abs(best - wanted)) {
+          best = *rate;
+        }
+      }
+      return best;
+    }
+  } // namespace
+
+  AudioClipEncoder::AudioClipEncoder()
+  {
+    m_Packet = av_packet_alloc();
+  }
+
+  AudioClipEncoder::~AudioClipEncoder()
+  {
+    Release();
+    av_packet_free(&m_Packet);
+  }
+
+  int AudioClipEncoder::WritePacket(void* opaque, const uint8_t* buffer, int size)
+  {
+    auto* output = static_cast<std::vector<unsigned char>*>(opaque);
+    output->insert(output->end(), buffer, buffer + size);
+    return size;
+  }
+
+  std::span<const AudioEncoderProfile> AudioClipEncoder::GetProfiles()
+  {
+    return PROFILES;
+  }
+
+  const AudioEncoderProfile& AudioClipEncoder::GetProfile(std::string_view id)
+  {
+    for (const auto& profile : PROFILES) {
+      if (profile.id == id)
+        return profile;
+    }
+    return GetDefaultProfile();
+  }
+
+  const AudioEncoderProfile& AudioClipEncoder::GetDefaultProfile()
+  {
+    return PROFILES[DEFAULT_PROFILE];
+  }
+
+  bool AudioClipEncoder::Begin(const AudioEncoderProfile& profile)
+  {
+    Release();
+    m_Output.clear();
+    m_NextPts = 0;
+
+    // The descriptor maps the name to a codec id, FFmpeg then picks the preferred encoder (libopus over the
+    // experimental native Opus encoder, for instance)
+    const AVCodecDescriptor* descriptor = avcodec_descriptor_get_by_name(std::string(profile.codec).c_str());
+    const AVCodec* codec = descriptor ? avcodec_find_encoder(descriptor->id) : nullptr;
+    if (!codec) {
+      AF_ERROR("No {} encoder available for audio profile '{}'", profile.codec, profile.id);
+      return false;
+    }
+
+    m_Encoder = avcodec_alloc_context3(codec);
+    m_Encoder->sample_rate = PickSampleRate(m_Encoder, codec, profile.sampleRate);
+    av_channel_layout_default(&m_Encoder->ch_layout, profile.channels);
+    m_Encoder->sample_fmt = PickSampleFormat(m_Encoder, codec);
+    m_Encoder->time_base = (AVRational) {1, m_Encoder->sample_rate};
+    m_Encoder->bit_rate = profile.bitRate;
+
+    if (avcodec_open2(m_Encoder, codec, nullptr) < 0) {
+      AF_ERROR("Failed to open {} encoder for audio profile '{}'", codec->name, profile.id);
+      Release();
+      return false;
+    }
+
+    auto* ioBuffer = static_cast<unsigned char*>(av_malloc(IO_BUFFER_SIZE));
+    m_IOContext = avio_alloc_context(ioBuffer, IO_BUFFER_SIZE, 1, &m_Output, nullptr, WritePacket, nullptr);
+
+    avformat_alloc_output_context2(&m_OutputContext, nullptr, std::string(profile.muxer).c_str(), nullptr);
+    if (!m_IOContext || !m_OutputContext) {
+      AF_ERROR("Failed to create output context");
+      Release();
+      return false;
+    }
+    m_OutputContext->pb = m_IOContext;
+    m_OutputContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    m_Stream = avformat_new_stream(m_OutputContext, nullptr);
+    avcodec_parameters_from_context(m_Stream->codecpar, m_Encoder);
+    m_Stream->time_base = m_Encoder->time_base;
+
+    if (avformat_write_header(m_OutputContext, nullptr) < 0) {
+      AF_ERROR("Failed to write header");
+      Release();
+      return false;
+    }
+
+    return true;
+  }
+
+  int AudioClipEncoder::GetFrameSize() const
+  {
+    // Encoders that accept any frame size report 0
+    return (m_Encoder && m_Encoder->frame_size > 0) ? m_Encoder->frame_size : 1024;
+  }
+
+  bool AudioClipEncoder::Encode(AVFrame* frame)
+  {
+    if (!m_Encoder)
+      return false;
+
+    frame->pts = m_NextPts;
+    m_NextPts += frame->nb_samples;
+
+    if (avcodec_send_frame(m_Encoder, frame) < 0) {
+      AF_ERROR("Failed to send frame to audio encoder");
+      return false;
+    }
+    return Drain();
+  }
+
+  bool AudioClipEncoder::Drain()
+  {
+    while (avcodec_receive_packet(m_Encoder, m_Packet) == 0) {
+      m_Packet->stream_index = m_Stream->index;
+      av_packet_rescale_ts(m_Packet, m_Encoder->time_base, m_Stream->time_base);
+      // Takes ownership of the packet's data and leaves it blank for the next one
+      if (av_interleaved_write_frame(m_OutputContext, m_Packet) < 0) {
+        AF_ERROR("Failed to write audio packet");
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<unsigned char> AudioClipEncoder::Finish()
+  {
+    if (!m_Encoder)
+      return {};
+
+    avcodec_send_frame(m_Encoder, nullptr);
+    bool ok = Drain() && av_write_trailer(m_OutputContext) == 0;
+    Release();
+
+    if (!ok) {
+      AF_ERROR("Failed to finish audio clip");
+      return {};
+    }
+    return std::move(m_Output);
+  }
+
+  void AudioClipEncoder::Release()
+  {
+    avcodec_free_context(&m_Encoder);
+    if (m_OutputContext) {
+      avformat_free_context(m_OutputContext);
+      m_OutputContext = nullptr;
+    }
+    if (m_IOContext) {
+      av_freep(&m_IOContext->buffer);
+      avio_context_free(&m_IOContext);
+    }
+    m_Stream = nullptr;
+  }
+
+} // namespace Video2Card::Audio
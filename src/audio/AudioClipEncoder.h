@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct AVIOContext;
+struct AVPacket;
+struct AVStream;
+
+namespace Video2Card::Audio
+{
+
+  /**
+   * Named encoder settings for sentence clips
+   */
+  struct AudioEncoderProfile
+  {
+    std::string_view id;        // Stored in the config, e.g. "speech-opus"
+    std::string_view name;      // Shown in the UI
+    std::string_view codec;     // FFmpeg codec name, the preferred encoder for it is used
+    std::string_view muxer;     // FFmpeg output format
+    std::string_view extension; // File extension of the clip
+    int sampleRate = 44100;
+    int channels = 2;
+    int bitRate = 128000;
+  };
+
+  /**
+   * Encodes one audio clip at a time into an in-memory file, with the codec, rate, channels and bitrate of a
+   * profile. The packet is kept between clips, the encoder and muxer are recreated for each one since their
+   * headers are per file.
+   */
+  class AudioClipEncoder
+  {
+public:
+
+    AudioClipEncoder();
+    ~AudioClipEncoder();
+
+    AudioClipEncoder(const AudioClipEncoder&) = delete;
+    AudioClipEncoder& operator=(const AudioClipEncoder&) = delete;
+
+    /**
+     * All profiles, in the order they are offered in the UI
+     */
+    static std::span<const AudioEncoderProfile> GetProfiles();
+
+    /**
+     * Look up a profile by id, falling back to the default profile for unknown ids
+     */
+    static const AudioEncoderProfile& GetProfile(std::string_view id);
+    static const AudioEncoderProfile& GetDefaultProfile();
+
+    /**
+     * Start a new clip, discarding any unfinished one
+     * @param profile Encoder settings
+     * @return true if the encoder and muxer are ready
+     */
+    bool Begin(const AudioEncoderProfile& profile);
+
+    /**
+     * Encoder settings for the current clip. Frames passed to Encode() must match its sample format, rate and
+     * channel layout, and hold GetFrameSize() samples (only the last frame may be shorter)
+     */
+    const AVCodecContext* GetCodecContext() const { return m_Encoder; }
+    int GetFrameSize() const;
+
+    /**
+     * Encode a frame, timestamps are assigned here
+     */
+    bool Encode(AVFrame* frame);
+
+    /**
+     * Flush the encoder and finish the file
+     * @return The encoded clip, empty on failure
+     */
+    std::vector<unsigned char> Finish();
+
+private:
+
+    static int WritePacket(void* opaque, const uint8_t* buffer, int size);
+
+    bool Drain();
+    void Release();
+
+    AVCodecContext* m_Encoder = nullptr;
+    AVFormatContext* m_OutputContext = nullptr;
+    AVIOContext* m_IOContext = nullptr;
+    AVStream* m_Stream = nullptr;
+    AVPacket* m_Packet = nullptr;
+
+    std::vector<unsigned char> m_Output;
+    int64_t m_NextPts = 0;
+  };
+
+} // namespace Video2Card::Audio
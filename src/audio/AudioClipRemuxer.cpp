@@ -0,0 +1,204 @@
+#include "audio/AudioClipRemuxer.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+}
+
+#include <cstdio>
+#include <cstring>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Audio
+{
+
+  static constexpr int IO_BUFFER_SIZE = 4096;
+
+  namespace
+  {
+    struct RemuxTarget
+    {
+      AVCodecID codec;
+      const char* muxer;
+      const char* extension;
+    };
+
+    // Codecs Anki plays directly on desktop and mobile, with the container each one is stored in
+    constexpr RemuxTarget REMUX_TARGETS[] = {
+        {AV_CODEC_ID_AAC, "ipod", "m4a"},
+        {AV_CODEC_ID_OPUS, "opus", "opus"},
+        {AV_CODEC_ID_VORBIS, "ogg", "ogg"},
+        {AV_CODEC_ID_MP3, "mp3", "mp3"},
+    };
+
+    const RemuxTarget* FindTarget(const AVCodecParameters* parameters)
+    {
+      if (!parameters)
+        return nullptr;
+
+      for (const auto& target : REMUX_TARGETS) {
+        if (target.codec == parameters->codec_id)
+          return &target;
+      }
+      return nullptr;
+    }
+  } // namespace
+
+  AudioClipRemuxer::~AudioClipRemuxer()
+  {
+    Release();
+  }
+
+  std::string AudioClipRemuxer::GetExtension(const AVCodecParameters* parameters)
+  {
+    const RemuxTarget* target = FindTarget(parameters);
+    return target ? target->extension : "";
+  }
+
+  int AudioClipRemuxer::WritePacket(void* opaque, const uint8_t* buffer, int size)
+  {
+    auto* self = static_cast<AudioClipRemuxer*>(opaque);
+    if (self->m_Position + size > self->m_Output.size()) {
+      self->m_Output.resize(self->m_Position + size);
+    }
+    std::memcpy(self->m_Output.data() + self->m_Position, buffer, size);
+    self->m_Position += size;
+    return size;
+  }
+
+  int64_t AudioClipRemuxer::Seek(void* opaque, int64_t offset, int whence)
+  {
+    auto* self = static_cast<AudioClipRemuxer*>(opaque);
+    const auto size = static_cast<int64_t>(self->m_Output.size());
+
+    int64_t position = 0;
+    switch (whence & ~AVSEEK_FORCE) {
+      case AVSEEK_SIZE:
+        return size;
+      case SEEK_SET:
+        position = offset;
+        break;
+      case SEEK_CUR:
+        position = static_cast<int64_t>(self->m_Position) + offset;
+        break;
+      case SEEK_END:
+        position = size + offset;
+        break;
+      default:
+        return AVERROR(EINVAL);
+    }
+
+    if (position < 0)
+      return AVERROR(EINVAL);
+
+    self->m_Position = static_cast<size_t>(position);
+    return position;
+  }
+
+  bool AudioClipRemuxer::Begin(const AVStream* source)
+  {
+    Release();
+    m_Output.clear();
+    m_Position = 0;
+    m_FirstTimestamp = 0;
+    m_HasFirstTimestamp = false;
+    m_WrotePacket = false;
+
+    const RemuxTarget* target = FindTarget(source ? source->codecpar : nullptr);
+    if (!target)
+      return false;
+
+    auto* ioBuffer = static_cast<unsigned char*>(av_malloc(IO_BUFFER_SIZE));
+    m_IOContext = avio_alloc_context(ioBuffer, IO_BUFFER_SIZE, 1, this, nullptr, WritePacket, Seek);
+
+    avformat_alloc_output_context2(&m_OutputContext, nullptr, target->muxer, nullptr);
+    if (!m_IOContext || !m_OutputContext) {
+      AF_ERROR("Failed to create remux output context");
+      Release();
+      return false;
+    }
+    m_OutputContext->pb = m_IOContext;
+    m_OutputContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+
+    m_Stream = avformat_new_stream(m_OutputContext, nullptr);
+    if (!m_Stream || avcodec_parameters_copy(m_Stream->codecpar, source->codecpar) < 0) {
+      AF_ERROR("Failed to create remux output stream");
+      Release();
+      return false;
+    }
+    // The source container's tag means nothing to the new one
+    m_Stream->codecpar->codec_tag = 0;
+    m_Stream->time_base = source->time_base;
+    m_Source = source;
+
+    // Fails for streams the muxer cannot describe, e.g. Opus without its header, the caller transcodes then
+    if (avformat_write_header(m_OutputContext, nullptr) < 0) {
+      AF_WARN("Failed to write remux header for {}", target->muxer);
+      Release();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool AudioClipRemuxer::Write(AVPacket* packet)
+  {
+    if (!m_OutputContext)
+      return false;
+
+    int64_t timestamp = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+    if (!m_HasFirstTimestamp && timestamp != AV_NOPTS_VALUE) {
+      m_FirstTimestamp = timestamp;
+      m_HasFirstTimestamp = true;
+    }
+
+    if (packet->pts != AV_NOPTS_VALUE)
+      packet->pts -= m_FirstTimestamp;
+    if (packet->dts != AV_NOPTS_VALUE)
+      packet->dts -= m_FirstTimestamp;
+    packet->stream_index = m_Stream->index;
+    packet->pos = -1;
+    av_packet_rescale_ts(packet, m_Source->time_base, m_Stream->time_base);
+
+    // Takes ownership of the packet's data and leaves it blank for the next one
+    if (av_interleaved_write_frame(m_OutputContext, packet) < 0) {
+      AF_ERROR("Failed to write remuxed audio packet");
+      return false;
+    }
+
+    m_WrotePacket = true;
+    return true;
+  }
+
+  std::vector<unsigned char> AudioClipRemuxer::Finish()
+  {
+    if (!m_OutputContext)
+      return {};
+
+    bool ok = av_write_trailer(m_OutputContext) == 0;
+    Release();
+
+    if (!ok || !m_WrotePacket) {
+      AF_ERROR("Failed to finish remuxed audio clip");
+      return {};
+    }
+    return std::move(m_Output);
+  }
+
+  void AudioClipRemuxer::Release()
+  {
+    if (m_OutputContext) {
+      avformat_free_context(m_OutputContext);
+      m_OutputContext = nullptr;
+    }
+    if (m_IOContext) {
+      av_freep(&m_IOContext->buffer);
+      avio_context_free(&m_IOContext);
+    }
+    m_Stream = nullptr;
+    m_Source = nullptr;
+  }
+
+} // namespace Video2Card::Audio
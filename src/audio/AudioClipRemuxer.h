@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct AVCodecParameters;
+struct AVFormatContext;
+struct AVIOContext;
+struct AVPacket;
+struct AVStream;
+
+namespace Video2Card::Audio
+{
+
+  /**
+   * Copies compressed audio packets into an in-memory file without decoding them
+   * The container follows the codec: AAC goes into M4A, Opus and Vorbis into Ogg and MP3 stays MP3. The output
+   * is seekable so that the MP4 muxer can go back and finish its index.
+   */
+  class AudioClipRemuxer
+  {
+public:
+
+    AudioClipRemuxer() = default;
+    ~AudioClipRemuxer();
+
+    AudioClipRemuxer(const AudioClipRemuxer&) = delete;
+    AudioClipRemuxer& operator=(const AudioClipRemuxer&) = delete;
+
+    /**
+     * Check whether a stream can be copied as it is
+     * @param parameters Codec parameters of the source stream
+     * @return File extension of the output, empty if the codec has to be transcoded
+     */
+    static std::string GetExtension(const AVCodecParameters* parameters);
+
+    /**
+     * Start a new clip from a source stream, discarding any unfinished one
+     * @return true if the muxer is ready
+     */
+    bool Begin(const AVStream* source);
+
+    /**
+     * Write a packet of the source stream. Timestamps are shifted so the clip starts at zero.
+     * The packet is left blank afterwards.
+     */
+    bool Write(AVPacket* packet);
+
+    /**
+     * Finish the file
+     * @return The clip, empty on failure or when no packet was written
+     */
+    std::vector<unsigned char> Finish();
+
+private:
+
+    static int WritePacket(void* opaque, const uint8_t* buffer, int size);
+    static int64_t Seek(void* opaque, int64_t offset, int whence);
+
+    void Release();
+
+    AVFormatContext* m_OutputContext = nullptr;
+    AVIOContext* m_IOContext = nullptr;
+    AVStream* m_Stream = nullptr;
+    const AVStream* m_Source = nullptr;
+
+    std::vector<unsigned char> m_Output;
+    size_t m_Position = 0;
+    int64_t m_FirstTimestamp = 0;
+    bool m_HasFirstTimestamp = false;
+    bool m_WrotePacket = false;
+  };
+
+} // namespace Video2Card::Audio
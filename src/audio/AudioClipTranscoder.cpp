@@ -0,0 +1,247 @@
+#include "audio/AudioClipTranscoder.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/audio_fifo.h>
+#include <libavutil/avutil.h>
+#include <libavutil/samplefmt.h>
+#include <libswresample/swresample.h>
+}
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Audio
+{
+
+  AudioClipTranscoder::AudioClipTranscoder()
+  {
+    m_ResampledFrame = av_frame_alloc();
+    m_EncoderFrame = av_frame_alloc();
+  }
+
+  AudioClipTranscoder::~AudioClipTranscoder()
+  {
+    av_frame_free(&m_ResampledFrame);
+    av_frame_free(&m_EncoderFrame);
+    swr_free(&m_Resampler);
+    if (m_Fifo) {
+      av_audio_fifo_free(m_Fifo);
+      m_Fifo = nullptr;
+    }
+  }
+
+  bool AudioClipTranscoder::Begin(std::string_view profileId)
+  {
+    m_Profile = nullptr;
+
+    const AudioEncoderProfile& profile = AudioClipEncoder::GetProfile(profileId);
+    if (m_Encoder.Begin(profile)) {
+      m_Profile = &profile;
+    } else {
+      // The encoder for the profile may be missing from this FFmpeg build
+      const AudioEncoderProfile& fallback = AudioClipEncoder::GetDefaultProfile();
+      if (&profile == &fallback || !m_Encoder.Begin(fallback))
+        return false;
+
+      AF_WARN("Audio profile '{}' is unavailable, using '{}'", profile.id, fallback.id);
+      m_Profile = &fallback;
+    }
+
+    const AVCodecContext* encoder = m_Encoder.GetCodecContext();
+    const int frameSize = m_Encoder.GetFrameSize();
+
+    // The resampler output, FIFO and encoder frame all follow the encoder settings and are reused as long as
+    // those don't change
+    if (m_ResampledFrame->format != encoder->sample_fmt || m_ResampledFrame->sample_rate != encoder->sample_rate ||
+        av_channel_layout_compare(&m_ResampledFrame->ch_layout, &encoder->ch_layout) != 0)
+    {
+      av_frame_unref(m_ResampledFrame);
+      m_ResampledFrame->format = encoder->sample_fmt;
+      m_ResampledFrame->sample_rate = encoder->sample_rate;
+      av_channel_layout_copy(&m_ResampledFrame->ch_layout, &encoder->ch_layout);
+      if (m_Fifo) {
+        av_audio_fifo_free(m_Fifo);
+        m_Fifo = nullptr;
+      }
+    }
+
+    if (m_EncoderFrame->nb_samples != frameSize || m_EncoderFrame->format != encoder->sample_fmt ||
+        av_channel_layout_compare(&m_EncoderFrame->ch_layout, &encoder->ch_layout) != 0)
+    {
+      av_frame_unref(m_EncoderFrame);
+      m_EncoderFrame->nb_samples = frameSize;
+      m_EncoderFrame->format = encoder->sample_fmt;
+      av_channel_layout_copy(&m_EncoderFrame->ch_layout, &encoder->ch_layout);
+      if (av_frame_get_buffer(m_EncoderFrame, 0) < 0) {
+        AF_ERROR("Failed to allocate encoder frame");
+        return false;
+      }
+    }
+    // The rate is not part of the buffer, a profile can change it alone
+    m_EncoderFrame->sample_rate = encoder->sample_rate;
+
+    if (!m_Fifo) {
+      m_Fifo = av_audio_fifo_alloc(encoder->sample_fmt, encoder->ch_layout.nb_channels, frameSize * 4);
+      if (!m_Fifo) {
+        AF_ERROR("Failed to allocate audio FIFO");
+        return false;
+      }
+    }
+
+    // Drop everything left over from the previous clip. Closing the resampler also makes it pick up the input
+    // format again, which can differ between files.
+    av_audio_fifo_reset(m_Fifo);
+    if (m_Resampler) {
+      swr_close(m_Resampler);
+    }
+    return true;
+  }
+
+  bool AudioClipTranscoder::AddFrame(
+      const AVFrame* frame, double frameStart, double start, double end, bool sampleAccurate, bool& finished)
+  {
+    if (frameStart > end) {
+      finished = true;
+      return true;
+    }
+
+    double frameEnd = frameStart + (double) frame->nb_samples / frame->sample_rate;
+    if (frameEnd < start)
+      return true;
+
+    // Frames overlapping either end are kept whole unless an exact cut was asked for
+    const int frameSamples = frame->nb_samples;
+    int first = 0;
+    int last = frameSamples;
+    if (sampleAccurate) {
+      if (frameStart < start) {
+        first = std::clamp((int) std::llround((start - frameStart) * frame->sample_rate), 0, frameSamples);
+      }
+      if (frameEnd > end) {
+        last = std::clamp((int) std::llround((end - frameStart) * frame->sample_rate), first, frameSamples);
+      }
+    }
+
+    const int count = last - first;
+    if (count <= 0)
+      return true;
+
+    if (!EnsureResampler(frame))
+      return false;
+
+    const auto format = (enum AVSampleFormat) frame->format;
+    const bool planar = av_sample_fmt_is_planar(format);
+    const int channels = frame->ch_layout.nb_channels;
+    const int offset = first * av_get_bytes_per_sample(format) * (planar ? 1 : channels);
+    m_InputPlanes.resize(planar ? channels : 1);
+    for (size_t i = 0; i < m_InputPlanes.size(); ++i) {
+      m_InputPlanes[i] = frame->extended_data[i] + offset;
+    }
+
+    // Grow the output frame when needed, it is kept at the largest size seen so far. Its nb_samples is the
+    // capacity, swr_convert reports how much of it was filled.
+    int needed = swr_get_out_samples(m_Resampler, count);
+    if (needed > m_ResampledFrame->nb_samples || !m_ResampledFrame->data[0]) {
+      const AVCodecContext* encoder = m_Encoder.GetCodecContext();
+      av_frame_unref(m_ResampledFrame);
+      m_ResampledFrame->nb_samples = needed;
+      m_ResampledFrame->format = encoder->sample_fmt;
+      m_ResampledFrame->sample_rate = encoder->sample_rate;
+      av_channel_layout_copy(&m_ResampledFrame->ch_layout, &encoder->ch_layout);
+      if (av_frame_get_buffer(m_ResampledFrame, 0) < 0) {
+        AF_ERROR("Failed to allocate resampler output");
+        return false;
+      }
+    }
+
+    int converted = swr_convert(m_Resampler, m_ResampledFrame->data, needed, m_InputPlanes.data(), count);
+    if (converted < 0) {
+      AF_ERROR("Failed to resample audio");
+      return false;
+    }
+
+    if (converted > 0 && av_audio_fifo_write(m_Fifo, (void**) m_ResampledFrame->data, converted) < converted) {
+      AF_ERROR("Failed to write to audio FIFO");
+      return false;
+    }
+
+    return EncodeFifo(false);
+  }
+
+  AudioClip AudioClipTranscoder::Finish()
+  {
+    if (!m_Profile)
+      return {};
+
+    // Samples still buffered in the resampler belong to the clip as well
+    if (m_Resampler && swr_is_initialized(m_Resampler) && m_ResampledFrame->data[0]) {
+      int drained = swr_convert(m_Resampler, m_ResampledFrame->data, m_ResampledFrame->nb_samples, nullptr, 0);
+      if (drained > 0) {
+        av_audio_fifo_write(m_Fifo, (void**) m_ResampledFrame->data, drained);
+      }
+    }
+
+    if (!EncodeFifo(true))
+      return {};
+
+    AudioClip clip;
+    clip.data = m_Encoder.Finish();
+    clip.extension = m_Profile->extension;
+    return clip;
+  }
+
+  bool AudioClipTranscoder::EnsureResampler(const AVFrame* frame)
+  {
+    if (m_Resampler && swr_is_initialized(m_Resampler))
+      return true;
+
+    // Configured from the first frame of each clip: the resampler was closed in Begin(), which also drops its
+    // delay. An existing context is reused.
+    const AVCodecContext* encoder = m_Encoder.GetCodecContext();
+    int result = swr_alloc_set_opts2(&m_Resampler,
+                                     &encoder->ch_layout,
+                                     encoder->sample_fmt,
+                                     encoder->sample_rate,
+                                     &frame->ch_layout,
+                                     (enum AVSampleFormat) frame->format,
+                                     frame->sample_rate,
+                                     0,
+                                     nullptr);
+    if (result < 0 || swr_init(m_Resampler) < 0) {
+      AF_ERROR("Failed to initialize resampler");
+      return false;
+    }
+    return true;
+  }
+
+  bool AudioClipTranscoder::EncodeFifo(bool flush)
+  {
+    const int frameSize = m_Encoder.GetFrameSize();
+
+    while (av_audio_fifo_size(m_Fifo) >= frameSize || (flush && av_audio_fifo_size(m_Fifo) > 0)) {
+      // The encoder may still reference the previous frame's buffers
+      m_EncoderFrame->nb_samples = frameSize;
+      if (av_frame_make_writable(m_EncoderFrame) < 0) {
+        AF_ERROR("Failed to make encoder frame writable");
+        return false;
+      }
+
+      int samples = std::min(av_audio_fifo_size(m_Fifo), frameSize);
+      if (av_audio_fifo_read(m_Fifo, (void**) m_EncoderFrame->data, samples) < samples) {
+        AF_ERROR("Failed to read from audio FIFO");
+        return false;
+      }
+
+      m_EncoderFrame->nb_samples = samples;
+      if (!m_Encoder.Encode(m_EncoderFrame))
+        return false;
+    }
+
+    m_EncoderFrame->nb_samples = frameSize;
+    return true;
+  }
+
+} // namespace Video2Card::Audio
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "audio/AudioClip.h"
+#include "audio/AudioClipEncoder.h"
+
+struct AVAudioFifo;
+struct AVFrame;
+struct SwrContext;
+
+namespace Video2Card::Audio
+{
+
+  /**
+   * Turns decoded audio frames into an encoded clip: trims them to the clip, resamples them to the encoder
+   * format and feeds the encoder in frames of the size it expects.
+   * The resampler, FIFO and frames are reused from one clip to the next as long as the encoder settings stay
+   * the same. One clip at a time, and not thread safe.
+   */
+  class AudioClipTranscoder
+  {
+public:
+
+    AudioClipTranscoder();
+    ~AudioClipTranscoder();
+
+    AudioClipTranscoder(const AudioClipTranscoder&) = delete;
+    AudioClipTranscoder& operator=(const AudioClipTranscoder&) = delete;
+
+    /**
+     * Start a new clip, discarding any unfinished one
+     * @param profileId Encoder profile, the default profile is used if its encoder is missing from this build
+     * @return true if the encoder is ready
+     */
+    bool Begin(std::string_view profileId);
+
+    /**
+     * Add a decoded frame. Frames are expected in order, the ones outside the clip are skipped.
+     * @param frame Decoded audio, any format, rate and layout as long as it stays the same within a clip
+     * @param frameStart Time of the first sample of the frame, on the same timeline as start and end
+     * @param start Start of the clip in seconds
+     * @param end End of the clip in seconds
+     * @param sampleAccurate Trim frames overlapping either end to the exact sample instead of keeping them whole
+     * @param finished Set once a frame starts after the end of the clip
+     * @return false on error
+     */
+    bool
+    AddFrame(const AVFrame* frame, double frameStart, double start, double end, bool sampleAccurate, bool& finished);
+
+    /**
+     * Encode what is still buffered and finish the file
+     * @return The clip, empty on failure
+     */
+    AudioClip Finish();
+
+    /**
+     * Profile of the clip being encoded, which is not the requested one if that was unavailable
+     */
+    const AudioEncoderProfile* GetProfile() const { return m_Profile; }
+
+private:
+
+    bool EnsureResampler(const AVFrame* frame);
+    bool EncodeFifo(bool flush);
+
+    AudioClipEncoder m_Encoder;
+    const AudioEncoderProfile* m_Profile = nullptr;
+
+    AVFrame* m_ResampledFrame = nullptr;
+    AVFrame* m_EncoderFrame = nullptr;
+    SwrContext* m_Resampler = nullptr;
+    AVAudioFifo* m_Fifo = nullptr;
+    std::vector<const uint8_t*> m_InputPlanes;
+  };
+
+} // namespace Video2Card::Audio
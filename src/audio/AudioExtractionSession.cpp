@@ -0,0 +1,311 @@
+#include "audio/AudioExtractionSession.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+}
+
+#include <chrono>
+#include <cmath>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Audio
+{
+
+  AudioExtractionSession::AudioExtractionSession()
+  {
+    m_Packet = av_packet_alloc();
+    m_Frame = av_frame_alloc();
+    m_Worker = std::thread(&AudioExtractionSession::WorkerMain, this);
+  }
+
+  AudioExtractionSession::~AudioExtractionSession()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      m_StopRequested = true;
+    }
+    m_QueueCondition.notify_one();
+    if (m_Worker.joinable()) {
+      m_Worker.join();
+    }
+
+    CloseInput();
+    av_packet_free(&m_Packet);
+    av_frame_free(&m_Frame);
+  }
+
+  void AudioExtractionSession::Open(const std::string& path)
+  {
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_RequestedPath = path;
+  }
+
+  void AudioExtractionSession::Close()
+  {
+    Open("");
+  }
+
+  std::future<AudioClip> AudioExtractionSession::RequestClip(double start,
+                                                             double end,
+                                                             const AudioClipOptions& options,
+                                                             std::stop_token cancel)
+  {
+    auto promise = std::make_shared<std::promise<AudioClip>>();
+    std::future<AudioClip> result = promise->get_future();
+
+    bool prefetch = cancel.stop_possible();
+    Post(
+        [this, promise, start, end, options, cancel = std::move(cancel)]() {
+          AudioClip clip;
+          // A prefetch for a line the user seeked away from is not worth the extraction
+          if (!cancel.stop_requested() && EnsureOpen()) {
+            // Packets can only be cut where they begin, so an exact cut always goes through the encoder
+            if (options.streamCopy && !options.sampleAccurate && !m_RemuxExtension.empty()) {
+              clip = RemuxClip(start, end);
+            }
+            if (clip.IsEmpty()) {
+              clip = TranscodeClip(start, end, options);
+            }
+          }
+          promise->set_value(std::move(clip));
+        },
+        prefetch);
+
+    return result;
+  }
+
+  void AudioExtractionSession::Post(std::function<void()> job, bool prefetch)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      (prefetch ? m_Prefetches : m_Jobs).push_back(std::move(job));
+    }
+    m_QueueCondition.notify_one();
+  }
+
+  void AudioExtractionSession::WorkerMain()
+  {
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        m_QueueCondition.wait(lock,
+                              [this] { return m_StopRequested || !m_Jobs.empty() || !m_Prefetches.empty(); });
+        // Outstanding jobs still run so that no promise is left unfulfilled
+        if (!m_Jobs.empty()) {
+          job = std::move(m_Jobs.front());
+          m_Jobs.pop_front();
+        } else if (!m_Prefetches.empty()) {
+          // The newest line is the one the user is looking at, older ones can wait
+          job = std::move(m_Prefetches.back());
+          m_Prefetches.pop_back();
+        } else {
+          break;
+        }
+      }
+      job();
+    }
+  }
+
+  bool AudioExtractionSession::EnsureOpen()
+  {
+    std::string path;
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      path = m_RequestedPath;
+    }
+
+    if (path == m_OpenPath && m_Decoder)
+      return true;
+
+    CloseInput();
+    if (path.empty())
+      return false;
+
+    av_log_set_level(AV_LOG_QUIET);
+
+    if (avformat_open_input(&m_FormatContext, path.c_str(), nullptr, nullptr) < 0) {
+      AF_ERROR("Failed to open input file for audio extraction: {}", path);
+      return false;
+    }
+
+    if (avformat_find_stream_info(m_FormatContext, nullptr) < 0) {
+      AF_ERROR("Failed to find stream info");
+      CloseInput();
+      return false;
+    }
+
+    const AVCodec* codec = nullptr;
+    m_StreamIndex = av_find_best_stream(m_FormatContext, AVMEDIA_TYPE_AUDIO, -1, -1, &codec, 0);
+    if (m_StreamIndex < 0 || !codec) {
+      AF_ERROR("No audio stream found");
+      CloseInput();
+      return false;
+    }
+
+    // Only the audio stream is needed, let the demuxer skip everything else
+    for (unsigned int i = 0; i < m_FormatContext->nb_streams; i++) {
+      if ((int) i != m_StreamIndex) {
+        m_FormatContext->streams[i]->discard = AVDISCARD_ALL;
+      }
+    }
+
+    AVStream* stream = m_FormatContext->streams[m_StreamIndex];
+    m_Decoder = avcodec_alloc_context3(codec);
+    avcodec_parameters_to_context(m_Decoder, stream->codecpar);
+    m_Decoder->pkt_timebase = stream->time_base;
+    if (avcodec_open2(m_Decoder, codec, nullptr) < 0) {
+      AF_ERROR("Failed to open input codec");
+      CloseInput();
+      return false;
+    }
+
+    // mpv's time-pos starts at 0 even for files with a non-zero start time
+    m_StartTime = 0.0;
+    if (m_FormatContext->start_time != AV_NOPTS_VALUE) {
+      m_StartTime = m_FormatContext->start_time / (double) AV_TIME_BASE;
+    }
+
+    m_RemuxExtension = AudioClipRemuxer::GetExtension(stream->codecpar);
+
+    m_OpenPath = path;
+    return true;
+  }
+
+  void AudioExtractionSession::CloseInput()
+  {
+    avcodec_free_context(&m_Decoder);
+    avformat_close_input(&m_FormatContext);
+    m_StreamIndex = -1;
+    m_RemuxExtension.clear();
+    m_OpenPath.clear();
+  }
+
+  void AudioExtractionSession::SeekTo(double start)
+  {
+    AVStream* stream = m_FormatContext->streams[m_StreamIndex];
+    int64_t seekTarget =
+        av_rescale_q(std::llround((start + m_StartTime) * AV_TIME_BASE), AV_TIME_BASE_Q, stream->time_base);
+    if (av_seek_frame(m_FormatContext, m_StreamIndex, seekTarget, AVSEEK_FLAG_BACKWARD) < 0) {
+      AF_WARN("Audio seek to {} failed, reading from the start", start);
+      av_seek_frame(m_FormatContext, m_StreamIndex, 0, AVSEEK_FLAG_BACKWARD);
+    }
+  }
+
+  AudioClip AudioExtractionSession::RemuxClip(double start, double end)
+  {
+    AF_INFO("Copying audio from {} to {}", start, end);
+    auto startedAt = std::chrono::steady_clock::now();
+
+    AVStream* stream = m_FormatContext->streams[m_StreamIndex];
+    if (!m_Remuxer.Begin(stream))
+      return {};
+
+    SeekTo(start);
+
+    const double timeBase = av_q2d(stream->time_base);
+    bool failed = false;
+    while (!failed && av_read_frame(m_FormatContext, m_Packet) >= 0) {
+      if (m_Packet->stream_index != m_StreamIndex) {
+        av_packet_unref(m_Packet);
+        continue;
+      }
+
+      int64_t pts = m_Packet->pts != AV_NOPTS_VALUE ? m_Packet->pts : m_Packet->dts;
+      if (pts == AV_NOPTS_VALUE) {
+        av_packet_unref(m_Packet);
+        continue;
+      }
+
+      // Same packet granularity as the transcode path without sample-accurate trimming
+      double packetStart = pts * timeBase - m_StartTime;
+      if (packetStart > end) {
+        av_packet_unref(m_Packet);
+        break;
+      }
+
+      double packetEnd = packetStart + m_Packet->duration * timeBase;
+      if (packetEnd < start) {
+        av_packet_unref(m_Packet);
+        continue;
+      }
+
+      failed = !m_Remuxer.Write(m_Packet);
+      av_packet_unref(m_Packet);
+    }
+
+    AudioClip clip;
+    clip.data = m_Remuxer.Finish();
+    clip.extension = m_RemuxExtension;
+    if (failed || clip.IsEmpty()) {
+      AF_WARN("Audio stream copy failed, falling back to transcoding");
+      return {};
+    }
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startedAt);
+    AF_INFO("Audio stream copy finished, size: {}, {:.1f} ms", clip.data.size(), elapsed.count());
+    return clip;
+  }
+
+  AudioClip AudioExtractionSession::TranscodeClip(double start, double end, const AudioClipOptions& options)
+  {
+    AF_INFO("Extracting audio from {} to {}", start, end);
+    auto startedAt = std::chrono::steady_clock::now();
+
+    if (!m_Transcoder.Begin(options.encoderProfile))
+      return {};
+
+    SeekTo(start);
+    avcodec_flush_buffers(m_Decoder);
+
+    const double timeBase = av_q2d(m_FormatContext->streams[m_StreamIndex]->time_base);
+    bool finished = false;
+    bool failed = false;
+    while (!finished && !failed) {
+      int readResult = av_read_frame(m_FormatContext, m_Packet);
+      if (readResult < 0) {
+        // End of file: drain whatever the decoder still holds
+        avcodec_send_packet(m_Decoder, nullptr);
+      } else if (m_Packet->stream_index != m_StreamIndex) {
+        av_packet_unref(m_Packet);
+        continue;
+      } else {
+        avcodec_send_packet(m_Decoder, m_Packet);
+        av_packet_unref(m_Packet);
+      }
+
+      while (!finished && !failed && avcodec_receive_frame(m_Decoder, m_Frame) == 0) {
+        int64_t pts =
+            m_Frame->best_effort_timestamp != AV_NOPTS_VALUE ? m_Frame->best_effort_timestamp : m_Frame->pts;
+        if (pts != AV_NOPTS_VALUE) {
+          double frameStart = pts * timeBase - m_StartTime;
+          failed = !m_Transcoder.AddFrame(m_Frame, frameStart, start, end, options.sampleAccurate, finished);
+        }
+        av_frame_unref(m_Frame);
+      }
+
+      if (readResult < 0)
+        break;
+    }
+
+    if (failed) {
+      AF_ERROR("Audio extraction failed");
+      return {};
+    }
+
+    AudioClip clip = m_Transcoder.Finish();
+    if (clip.IsEmpty())
+      return {};
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startedAt);
+    AF_INFO("Audio extraction finished ({}), size: {}, {:.1f} ms",
+            m_Transcoder.GetProfile()->id,
+            clip.data.size(),
+            elapsed.count());
+    return clip;
+  }
+
+} // namespace Video2Card::Audio
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "audio/AudioClip.h"
+#include "audio/AudioClipRemuxer.h"
+#include "audio/AudioClipTranscoder.h"
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+
+namespace Video2Card::Audio
+{
+
+  /**
+   * Extracts audio clips from a video file on a worker thread
+   * The file, decoder, resampler, FIFO, frames and packets are set up once per video and reused, so a clip only
+   * costs a seek, a decoder flush and the actual decoding and encoding. Everything but the audio stream is
+   * discarded by the demuxer.
+   * When the source codec is one Anki plays, the packets are copied into a new container instead, which skips
+   * decoding and encoding entirely. The transcode path remains for other codecs and for sample-accurate cuts.
+   */
+  class AudioExtractionSession
+  {
+public:
+
+    AudioExtractionSession();
+    ~AudioExtractionSession();
+
+    AudioExtractionSession(const AudioExtractionSession&) = delete;
+    AudioExtractionSession& operator=(const AudioExtractionSession&) = delete;
+
+    /**
+     * Set the file clips are taken from. The file is opened lazily on the worker
+     */
+    void Open(const std::string& path);
+    void Close();
+
+    /**
+     * Extract the audio between two timestamps
+     * @param start Start time in seconds (same timeline as mpv's time-pos)
+     * @param end End time in seconds
+     * @param options Whether the packets may be copied and how exact the cut has to be
+     * @param cancel Marks a prefetch: it waits for the direct requests and is skipped once a stop is requested
+     * @return Future with the clip, empty on failure or when skipped
+     */
+    std::future<AudioClip>
+    RequestClip(double start, double end, const AudioClipOptions& options = {}, std::stop_token cancel = {});
+
+private:
+
+    void WorkerMain();
+    void Post(std::function<void()> job, bool prefetch);
+
+    bool EnsureOpen();
+    void CloseInput();
+
+    void SeekTo(double start);
+
+    // Stream copy, cuts on packet boundaries
+    AudioClip RemuxClip(double start, double end);
+
+    // Decode, resample and encode with the profile from the options
+    AudioClip TranscodeClip(double start, double end, const AudioClipOptions& options);
+
+    std::thread m_Worker;
+    std::mutex m_QueueMutex;
+    std::condition_variable m_QueueCondition;
+    std::deque<std::function<void()>> m_Jobs;
+    std::deque<std::function<void()>> m_Prefetches; // Run once m_Jobs is empty, newest first
+    bool m_StopRequested = false;
+
+    std::string m_RequestedPath; // Guarded by m_QueueMutex
+
+    // Worker thread state
+    std::string m_OpenPath;
+    AVFormatContext* m_FormatContext = nullptr;
+    AVCodecContext* m_Decoder = nullptr;
+    int m_StreamIndex = -1;
+    double m_StartTime = 0.0;
+    std::string m_RemuxExtension; // Empty when the stream has to be transcoded
+
+    AVPacket* m_Packet = nullptr;
+    AVFrame* m_Frame = nullptr;
+
+    AudioClipTranscoder m_Transcoder;
+    AudioClipRemuxer m_Remuxer;
+  };
+
+} // namespace Video2Card::Audio
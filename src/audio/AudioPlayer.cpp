@@ -7,8 +7,156 @@
 #define STB_VORBIS_NO_PUSHDATA_API
 #include "../../third_party/stb_vorbis.c"
 
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+#include <libswresample/swresample.h>
+}
+
 namespace Video2Card::Audio
 {
+  namespace
+  {
+    struct MemoryReader
+    {
+      const unsigned char* data;
+      size_t size;
+      size_t position;
+    };
+
+    int ReadMemory(void* opaque, uint8_t* buffer, int size)
+    {
+      auto* reader = static_cast<MemoryReader*>(opaque);
+      size_t count = std::min(static_cast<size_t>(size), reader->size - reader->position);
+      if (count == 0)
+        return AVERROR_EOF;
+
+      std::memcpy(buffer, reader->data + reader->position, count);
+      reader->position += count;
+      return static_cast<int>(count);
+    }
+
+    int64_t SeekMemory(void* opaque, int64_t offset, int whence)
+    {
+      auto* reader = static_cast<MemoryReader*>(opaque);
+      int64_t position = 0;
+      switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+          return static_cast<int64_t>(reader->size);
+        case SEEK_SET:
+          position = offset;
+          break;
+        case SEEK_CUR:
+          position = static_cast<int64_t>(reader->position) + offset;
+          break;
+        case SEEK_END:
+          position = static_cast<int64_t>(reader->size) + offset;
+          break;
+        default:
+          return AVERROR(EINVAL);
+      }
+
+      if (position < 0 || position > static_cast<int64_t>(reader->size))
+        return AVERROR(EINVAL);
+
+      reader->position = static_cast<size_t>(position);
+      return position;
+    }
+
+    // Decodes whatever FFmpeg understands into interleaved 16-bit samples. Used for the formats miniaudio and
+    // stb_vorbis can't play, like the AAC and Opus clips copied straight from a video.
+    bool DecodeWithFFmpeg(const std::vector<unsigned char>& data,
+                          std::vector<short>& pcm,
+                          ma_uint32& sampleRate,
+                          ma_uint32& channels)
+    {
+      constexpr int IO_BUFFER_SIZE = 4096;
+      MemoryReader reader {data.data(), data.size(), 0};
+
+      auto* ioBuffer = static_cast<unsigned char*>(av_malloc(IO_BUFFER_SIZE));
+      AVIOContext* ioContext =
+          avio_alloc_context(ioBuffer, IO_BUFFER_SIZE, 0, &reader, ReadMemory, nullptr, SeekMemory);
+      AVFormatContext* formatContext = avformat_alloc_context();
+      AVCodecContext* decoder = nullptr;
+      SwrContext* resampler = nullptr;
+      AVPacket* packet = av_packet_alloc();
+      AVFrame* frame = av_frame_alloc();
+
+      bool ok = false;
+      if (ioContext && formatContext) {
+        formatContext->pb = ioContext;
+        formatContext->flags |= AVFMT_FLAG_CUSTOM_IO;
+        if (avformat_open_input(&formatContext, nullptr, nullptr, nullptr) == 0 &&
+            avformat_find_stream_info(formatContext, nullptr) >= 0)
+        {
+          const AVCodec* codec = nullptr;
+          int streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, &codec, 0);
+          if (streamIndex >= 0 && codec) {
+            decoder = avcodec_alloc_context3(codec);
+            avcodec_parameters_to_context(decoder, formatContext->streams[streamIndex]->codecpar);
+            ok = avcodec_open2(decoder, codec, nullptr) == 0;
+          }
+
+          if (ok) {
+            // Keep the rate, fold anything beyond stereo down
+            AVChannelLayout outputLayout;
+            av_channel_layout_default(&outputLayout, std::min(decoder->ch_layout.nb_channels, 2));
+            ok = swr_alloc_set_opts2(&resampler,
+                                     &outputLayout,
+                                     AV_SAMPLE_FMT_S16,
+                                     decoder->sample_rate,
+                                     &decoder->ch_layout,
+                                     decoder->sample_fmt,
+                                     decoder->sample_rate,
+                                     0,
+                                     nullptr) == 0 &&
+                 swr_init(resampler) == 0;
+            sampleRate = decoder->sample_rate;
+            channels = outputLayout.nb_channels;
+            av_channel_layout_uninit(&outputLayout);
+          }
+
+          pcm.clear();
+          bool draining = false;
+          while (ok && !draining) {
+            if (av_read_frame(formatContext, packet) < 0) {
+              avcodec_send_packet(decoder, nullptr);
+              draining = true;
+            } else if (packet->stream_index == streamIndex) {
+              avcodec_send_packet(decoder, packet);
+            }
+            av_packet_unref(packet);
+
+            while (ok && avcodec_receive_frame(decoder, frame) == 0) {
+              int capacity = swr_get_out_samples(resampler, frame->nb_samples);
+              size_t offset = pcm.size();
+              pcm.resize(offset + static_cast<size_t>(capacity) * channels);
+              uint8_t* output = reinterpret_cast<uint8_t*>(pcm.data() + offset);
+              int converted =
+                  swr_convert(resampler, &output, capacity, (const uint8_t**) frame->extended_data, frame->nb_samples);
+              ok = converted >= 0;
+              pcm.resize(offset + static_cast<size_t>(std::max(converted, 0)) * channels);
+              av_frame_unref(frame);
+            }
+          }
+        }
+      }
+
+      av_frame_free(&frame);
+      av_packet_free(&packet);
+      swr_free(&resampler);
+      avcodec_free_context(&decoder);
+      avformat_close_input(&formatContext);
+      if (ioContext) {
+        av_freep(&ioContext->buffer);
+        avio_context_free(&ioContext);
+      }
+
+      return ok && !pcm.empty();
+    }
+  } // namespace
+
   struct AudioPlayer::Impl
   {
     ma_device device;
@@ -100,39 +248,49 @@ namespace Video2Card::Audio
       stb_vorbis* vorbis = stb_vorbis_open_memory(
           m_Impl->audioBuffer.data(), static_cast<int>(m_Impl->audioBuffer.size()), &error, nullptr);
 
-      if (!vorbis) {
-        AF_ERROR("Failed to initialize audio decoder with stb_vorbis (error: {})", error);
-        return false;
-      }
+      if (vorbis) {
+        stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+        AF_INFO("OGG file: {} channels, {} Hz", info.channels, info.sample_rate);
 
-      stb_vorbis_info info = stb_vorbis_get_info(vorbis);
-      AF_INFO("OGG file: {} channels, {} Hz", info.channels, info.sample_rate);
+        unsigned int totalSamples = stb_vorbis_stream_length_in_samples(vorbis);
+        m_Impl->pcmBuffer.resize(totalSamples * info.channels);
 
-      unsigned int totalSamples = stb_vorbis_stream_length_in_samples(vorbis);
-      m_Impl->pcmBuffer.resize(totalSamples * info.channels);
+        int samplesDecoded = stb_vorbis_get_samples_short_interleaved(
+            vorbis, info.channels, m_Impl->pcmBuffer.data(), m_Impl->pcmBuffer.size());
 
-      int samplesDecoded = stb_vorbis_get_samples_short_interleaved(
-          vorbis, info.channels, m_Impl->pcmBuffer.data(), m_Impl->pcmBuffer.size());
+        stb_vorbis_close(vorbis);
 
-      stb_vorbis_close(vorbis);
+        if (samplesDecoded <= 0) {
+          AF_ERROR("Failed to decode OGG audio data");
+          return false;
+        }
+
+        m_Impl->pcmBuffer.resize(samplesDecoded * info.channels);
+        m_Impl->sampleRate = info.sample_rate;
+        m_Impl->channels = info.channels;
+
+        AF_INFO("Decoded {} samples from OGG", samplesDecoded);
+      } else {
+        AF_WARN("stb_vorbis failed (error: {}), trying FFmpeg", error);
 
-      if (samplesDecoded <= 0) {
-        AF_ERROR("Failed to decode OGG audio data");
-        return false;
+        if (!DecodeWithFFmpeg(m_Impl->audioBuffer, m_Impl->pcmBuffer, m_Impl->sampleRate, m_Impl->channels)) {
+          AF_ERROR("Failed to decode audio data with FFmpeg");
+          return false;
+        }
+
+        AF_INFO("Decoded {} samples with FFmpeg: {} channels, {} Hz",
+                m_Impl->pcmBuffer.size() / m_Impl->channels,
+                m_Impl->channels,
+                m_Impl->sampleRate);
       }
 
-      m_Impl->pcmBuffer.resize(samplesDecoded * info.channels);
       m_Impl->pcmPlaybackPosition = 0;
-      m_Impl->sampleRate = info.sample_rate;
-      m_Impl->channels = info.channels;
       m_Impl->isRawPCM = true;
 
-      AF_INFO("Decoded {} samples from OGG", samplesDecoded);
-
       deviceConfig = ma_device_config_init(ma_device_type_playback);
       deviceConfig.playback.format = ma_format_s16;
-      deviceConfig.playback.channels = info.channels;
-      deviceConfig.sampleRate = info.sample_rate;
+      deviceConfig.playback.channels = m_Impl->channels;
+      deviceConfig.sampleRate = m_Impl->sampleRate;
       deviceConfig.dataCallback = Impl::DataCallback;
       deviceConfig.pUserData = m_Impl.get();
     } else {
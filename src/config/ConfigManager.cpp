@@ -62,6 +62,21 @@ namespace Video2Card::Config
       if (j.contains("deepl_target_lang"))
         m_Config.DeepLTargetLang = j["deepl_target_lang"];
 
+      if (j.contains("video_render_at_display_resolution"))
+        m_Config.VideoRenderAtDisplayResolution = j["video_render_at_display_resolution"];
+      if (j.contains("prefetch_extraction"))
+        m_Config.PrefetchExtraction = j["prefetch_extraction"];
+
+      if (j.contains("image_encoder_profile"))
+        m_Config.ImageEncoderProfile = j["image_encoder_profile"];
+
+      if (j.contains("audio_stream_copy"))
+        m_Config.AudioStreamCopy = j["audio_stream_copy"];
+      if (j.contains("audio_sample_accurate"))
+        m_Config.AudioSampleAccurate = j["audio_sample_accurate"];
+      if (j.contains("audio_encoder_profile"))
+        m_Config.AudioEncoderProfile = j["audio_encoder_profile"];
+
       if (j.contains("window_width"))
         m_Config.WindowWidth = j["window_width"];
       if (j.contains("window_height"))
@@ -114,6 +129,15 @@ namespace Video2Card::Config
     j["deepl_source_lang"] = m_Config.DeepLSourceLang;
     j["deepl_target_lang"] = m_Config.DeepLTargetLang;
 
+    j["video_render_at_display_resolution"] = m_Config.VideoRenderAtDisplayResolution;
+    j["prefetch_extraction"] = m_Config.PrefetchExtraction;
+
+    j["image_encoder_profile"] = m_Config.ImageEncoderProfile;
+
+    j["audio_stream_copy"] = m_Config.AudioStreamCopy;
+    j["audio_sample_accurate"] = m_Config.AudioSampleAccurate;
+    j["audio_encoder_profile"] = m_Config.AudioEncoderProfile;
+
     j["window_width"] = m_Config.WindowWidth;
     j["window_height"] = m_Config.WindowHeight;
 
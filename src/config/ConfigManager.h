@@ -31,6 +31,19 @@ namespace Video2Card::Config
     std::string DeepLSourceLang = "JA";
     std::string DeepLTargetLang = "EN-US";
 
+    // Video Playback Configuration
+    bool VideoRenderAtDisplayResolution = true; // Render at panel size instead of the video's native size
+    bool PrefetchExtraction = true;             // Prepare the current subtitle line for Extract in the background
+
+    // Card Image Configuration
+    std::string ImageEncoderProfile = "balanced"; // "fast-lossy", "balanced", "compact" or "archival-lossless"
+
+    // Sentence Audio Configuration
+    bool AudioStreamCopy = true;      // Copy the source audio without re-encoding when Anki can play its codec
+    bool AudioSampleAccurate = false; // Cut clips at the exact sample, always re-encodes
+    // Used when re-encoding: "compat-vorbis", "speech-opus", "stereo-opus" or "speech-mp3"
+    std::string AudioEncoderProfile = "compat-vorbis";
+
     int WindowWidth = 1280;
     int WindowHeight = 720;
 
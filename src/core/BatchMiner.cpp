@@ -0,0 +1,664 @@
+#include "core/BatchMiner.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <numeric>
+
+#include "audio/AudioClipRemuxer.h"
+#include "audio/AudioClipTranscoder.h"
+#include "core/Logger.h"
+#include "utils/ImageScaler.h"
+
+namespace Video2Card::Core
+{
+
+  namespace
+  {
+    struct TimedFrame
+    {
+      AVFrame* frame;
+      double start;
+    };
+
+    struct MiningTarget
+    {
+      double start = 0.0;
+      double end = 0.0;
+      double midpoint = 0.0;
+      std::shared_ptr<std::promise<Utils::RawImage>> image;
+      std::shared_ptr<std::promise<Audio::AudioClip>> audio;
+      bool imageQueued = false;
+      bool audioQueued = false;
+
+      // Stream copy: the clip is muxed while the packets go by
+      std::unique_ptr<Audio::AudioClipRemuxer> remuxer;
+      bool remuxFailed = false;
+
+      // Transcode: decoded frames overlapping the line, encoded on the pool once the line is over
+      std::vector<TimedFrame> frames;
+    };
+
+    struct AnalysisQueue
+    {
+      BatchMiner::LocalAnalysis analyze;
+      std::vector<std::string> sentences;
+      std::vector<std::shared_ptr<std::promise<nlohmann::json>>> results;
+      std::atomic<size_t> next{0};
+      std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    // Analyzes one line and queues itself again, so the analyses take turns with the media jobs on the pool
+    // instead of holding a thread for the whole run
+    void AnalyzeNext(ThreadPool& pool, std::shared_ptr<AnalysisQueue> queue)
+    {
+      size_t index = queue->next++;
+      if (index >= queue->results.size())
+        return;
+
+      if (queue->cancelled->load()) {
+        queue->results[index]->set_value(nullptr);
+        for (index = queue->next++; index < queue->results.size(); index = queue->next++) {
+          queue->results[index]->set_value(nullptr);
+        }
+        return;
+      }
+
+      nlohmann::json result = nullptr;
+      try {
+        result = queue->analyze(queue->sentences[index]);
+      } catch (const std::exception& e) {
+        AF_WARN("Analysis of a mined line failed: {}", e.what());
+      }
+      queue->results[index]->set_value(std::move(result));
+
+      pool.Submit([&pool, queue]() { AnalyzeNext(pool, queue); });
+    }
+
+    /**
+     * One linear read of a video file, run on the miner's thread
+     */
+    class MiningPass
+    {
+public:
+
+      MiningPass(ThreadPool& pool,
+                 std::vector<MiningTarget>& targets,
+                 const MiningOptions& options,
+                 const std::atomic<bool>& cancelled,
+                 std::atomic<float>& progress)
+          : m_Pool(pool)
+          , m_Targets(targets)
+          , m_Options(options)
+          , m_Cancelled(cancelled)
+          , m_Progress(progress)
+      {
+        m_ImageOrder.resize(targets.size());
+        std::iota(m_ImageOrder.begin(), m_ImageOrder.end(), 0);
+        std::stable_sort(m_ImageOrder.begin(), m_ImageOrder.end(), [&](size_t a, size_t b) {
+          return targets[a].midpoint < targets[b].midpoint;
+        });
+
+        m_AudioOrder.resize(targets.size());
+        std::iota(m_AudioOrder.begin(), m_AudioOrder.end(), 0);
+        std::stable_sort(m_AudioOrder.begin(), m_AudioOrder.end(), [&](size_t a, size_t b) {
+          return targets[a].start < targets[b].start;
+        });
+      }
+
+      ~MiningPass()
+      {
+        // Whatever the pass didn't get to resolves empty
+        for (auto& target : m_Targets) {
+          if (!target.imageQueued) {
+            target.image->set_value({});
+          }
+          if (!target.audioQueued) {
+            target.audio->set_value({});
+          }
+          for (auto& timed : target.frames) {
+            av_frame_free(&timed.frame);
+          }
+        }
+
+        ClearGop();
+        av_packet_free(&m_Packet);
+        av_packet_free(&m_Scratch);
+        av_frame_free(&m_Frame);
+        av_frame_free(&m_Candidate);
+        avcodec_free_context(&m_VideoDecoder);
+        avcodec_free_context(&m_AudioDecoder);
+        avformat_close_input(&m_FormatContext);
+      }
+
+      MiningPass(const MiningPass&) = delete;
+      MiningPass& operator=(const MiningPass&) = delete;
+
+      void Run(const std::string& path)
+      {
+        auto startedAt = std::chrono::steady_clock::now();
+        if (!Open(path))
+          return;
+
+        while (!m_Cancelled.load() && !IsDone()) {
+          if (av_read_frame(m_FormatContext, m_Packet) < 0)
+            break;
+
+          if (m_Packet->stream_index == m_VideoIndex) {
+            HandleVideoPacket();
+          } else if (m_Packet->stream_index == m_AudioIndex) {
+            HandleAudioPacket();
+          }
+          av_packet_unref(m_Packet);
+        }
+
+        if (m_Cancelled.load()) {
+          AF_INFO("Batch mining cancelled");
+          return;
+        }
+
+        // End of file: the last keyframe interval and the lines still running
+        if (m_VideoDecoder && !m_Gop.empty() && HasImageBefore(std::numeric_limits<double>::infinity())) {
+          DecodeGop(std::numeric_limits<double>::infinity());
+        }
+        if (m_AudioDecoder) {
+          avcodec_send_packet(m_AudioDecoder, nullptr);
+          ReceiveAudioFrames();
+        }
+        for (size_t index : m_ActiveAudio) {
+          FinishAudio(m_Targets[index]);
+        }
+        m_ActiveAudio.clear();
+        for (; m_NextAudio < m_AudioOrder.size(); ++m_NextAudio) {
+          FinishAudio(m_Targets[m_AudioOrder[m_NextAudio]]);
+        }
+
+        m_Progress.store(1.0f);
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startedAt);
+        AF_INFO("Batch mining read {} lines in {:.1f} ms", m_Targets.size(), elapsed.count());
+      }
+
+private:
+
+      bool Open(const std::string& path)
+      {
+        av_log_set_level(AV_LOG_QUIET);
+
+        if (avformat_open_input(&m_FormatContext, path.c_str(), nullptr, nullptr) < 0) {
+          AF_ERROR("Failed to open input file for batch mining: {}", path);
+          return false;
+        }
+
+        if (avformat_find_stream_info(m_FormatContext, nullptr) < 0) {
+          AF_ERROR("Failed to find stream info for batch mining");
+          return false;
+        }
+
+        // mpv's time-pos starts at 0 even for files with a non-zero start time
+        if (m_FormatContext->start_time != AV_NOPTS_VALUE) {
+          m_StartTime = m_FormatContext->start_time / (double) AV_TIME_BASE;
+        }
+        if (m_FormatContext->duration > 0) {
+          m_Duration = m_FormatContext->duration / (double) AV_TIME_BASE;
+        }
+
+        const AVCodec* videoCodec = nullptr;
+        m_VideoIndex = av_find_best_stream(m_FormatContext, AVMEDIA_TYPE_VIDEO, -1, -1, &videoCodec, 0);
+        if (m_VideoIndex >= 0 && videoCodec) {
+          AVStream* stream = m_FormatContext->streams[m_VideoIndex];
+          m_VideoDecoder = avcodec_alloc_context3(videoCodec);
+          avcodec_parameters_to_context(m_VideoDecoder, stream->codecpar);
+          m_VideoDecoder->thread_count = 0;
+          if (avcodec_open2(m_VideoDecoder, videoCodec, nullptr) < 0) {
+            AF_ERROR("Failed to open video decoder for batch mining");
+            avcodec_free_context(&m_VideoDecoder);
+          }
+        }
+        if (!m_VideoDecoder) {
+          AF_WARN("No video to take snapshots from, the mined lines get no image");
+          m_VideoIndex = -1;
+          m_NextImage = m_ImageOrder.size();
+        }
+
+        const AVCodec* audioCodec = nullptr;
+        m_AudioIndex = av_find_best_stream(m_FormatContext, AVMEDIA_TYPE_AUDIO, -1, -1, &audioCodec, 0);
+        if (m_AudioIndex >= 0 && audioCodec) {
+          AVStream* stream = m_FormatContext->streams[m_AudioIndex];
+          std::string extension = Audio::AudioClipRemuxer::GetExtension(stream->codecpar);
+
+          // Packets can only be cut where they begin, so an exact cut always goes through the encoder
+          const Audio::AudioClipOptions& audio = m_Options.audio;
+          Audio::AudioClipRemuxer probe;
+          if (audio.streamCopy && !audio.sampleAccurate && !extension.empty() && probe.Begin(stream)) {
+            m_RemuxExtension = extension;
+          } else {
+            m_AudioDecoder = avcodec_alloc_context3(audioCodec);
+            avcodec_parameters_to_context(m_AudioDecoder, stream->codecpar);
+            m_AudioDecoder->pkt_timebase = stream->time_base;
+            if (avcodec_open2(m_AudioDecoder, audioCodec, nullptr) < 0) {
+              AF_ERROR("Failed to open audio decoder for batch mining");
+              avcodec_free_context(&m_AudioDecoder);
+              m_AudioIndex = -1;
+            }
+          }
+        } else {
+          m_AudioIndex = -1;
+        }
+        if (m_AudioIndex < 0) {
+          AF_WARN("No audio to cut, the mined lines get no sentence audio");
+          m_NextAudio = m_AudioOrder.size();
+        }
+
+        for (unsigned int i = 0; i < m_FormatContext->nb_streams; i++) {
+          if ((int) i != m_VideoIndex && (int) i != m_AudioIndex) {
+            m_FormatContext->streams[i]->discard = AVDISCARD_ALL;
+          }
+        }
+
+        m_Packet = av_packet_alloc();
+        m_Scratch = av_packet_alloc();
+        m_Frame = av_frame_alloc();
+        m_Candidate = av_frame_alloc();
+        return true;
+      }
+
+      bool IsDone() const { return m_NextImage >= m_ImageOrder.size() && IsAudioDone(); }
+      bool IsAudioDone() const { return m_NextAudio >= m_AudioOrder.size() && m_ActiveAudio.empty(); }
+
+      static double ToSeconds(int64_t timestamp, AVRational timeBase, double startTime)
+      {
+        if (timestamp == AV_NOPTS_VALUE)
+          return std::numeric_limits<double>::quiet_NaN();
+        return timestamp * av_q2d(timeBase) - startTime;
+      }
+
+      void UpdateProgress(double time)
+      {
+        if (m_Duration > 0.0 && !std::isnan(time)) {
+          m_Progress.store((float) std::clamp(time / m_Duration, 0.0, 1.0));
+        }
+      }
+
+      // Video
+
+      bool HasImageBefore(double limit) const
+      {
+        return m_NextImage < m_ImageOrder.size() && m_Targets[m_ImageOrder[m_NextImage]].midpoint < limit;
+      }
+
+      void HandleVideoPacket()
+      {
+        AVStream* stream = m_FormatContext->streams[m_VideoIndex];
+        int64_t pts = m_Packet->pts != AV_NOPTS_VALUE ? m_Packet->pts : m_Packet->dts;
+        double time = ToSeconds(pts, stream->time_base, m_StartTime);
+        UpdateProgress(time);
+
+        // A keyframe closes the buffered interval. Its lines are all before the keyframe, so they can be
+        // decoded now, and if there are none the interval is dropped without decoding anything.
+        if ((m_Packet->flags & AV_PKT_FLAG_KEY) && !m_Gop.empty() && !std::isnan(time)) {
+          if (HasImageBefore(time)) {
+            DecodeGop(time);
+          }
+          ClearGop();
+        }
+
+        if (m_NextImage >= m_ImageOrder.size()) {
+          // Every line has its image, the demuxer can skip the video from here on
+          stream->discard = AVDISCARD_ALL;
+          return;
+        }
+
+        AVPacket* packet = av_packet_alloc();
+        av_packet_move_ref(packet, m_Packet);
+        m_Gop.push_back(packet);
+      }
+
+      void ClearGop()
+      {
+        for (auto& packet : m_Gop) {
+          av_packet_free(&packet);
+        }
+        m_Gop.clear();
+      }
+
+      // Decode the buffered interval until every line with its midpoint before limit has a frame. The frame
+      // for a line is the last one with a timestamp at or before the midpoint, the same as a snapshot.
+      void DecodeGop(double limit)
+      {
+        avcodec_flush_buffers(m_VideoDecoder);
+        av_frame_unref(m_Candidate);
+        m_HaveCandidate = false;
+
+        bool done = false;
+        for (size_t i = 0; i < m_Gop.size() && !done; ++i) {
+          avcodec_send_packet(m_VideoDecoder, m_Gop[i]);
+          while (!done && avcodec_receive_frame(m_VideoDecoder, m_Frame) == 0) {
+            done = AcceptFrame(limit);
+          }
+        }
+
+        if (!done) {
+          avcodec_send_packet(m_VideoDecoder, nullptr);
+          while (!done && avcodec_receive_frame(m_VideoDecoder, m_Frame) == 0) {
+            done = AcceptFrame(limit);
+          }
+        }
+
+        // Lines after the last frame of the interval show that frame
+        while (m_HaveCandidate && HasImageBefore(limit)) {
+          QueueImage(m_Targets[m_ImageOrder[m_NextImage++]], m_Candidate);
+        }
+        av_frame_unref(m_Candidate);
+        m_HaveCandidate = false;
+      }
+
+      // Returns true once the lines before limit all have their frame
+      bool AcceptFrame(double limit)
+      {
+        AVStream* stream = m_FormatContext->streams[m_VideoIndex];
+        int64_t pts =
+            m_Frame->best_effort_timestamp != AV_NOPTS_VALUE ? m_Frame->best_effort_timestamp : m_Frame->pts;
+        double time = ToSeconds(pts, stream->time_base, m_StartTime);
+
+        // A frame past a line's midpoint means the previous one was on screen at that point
+        while (!std::isnan(time) && HasImageBefore(limit) && time > m_Targets[m_ImageOrder[m_NextImage]].midpoint)
+        {
+          QueueImage(m_Targets[m_ImageOrder[m_NextImage++]], m_HaveCandidate ? m_Candidate : m_Frame);
+        }
+
+        if (!HasImageBefore(limit)) {
+          av_frame_unref(m_Frame);
+          return true;
+        }
+
+        av_frame_unref(m_Candidate);
+        av_frame_move_ref(m_Candidate, m_Frame);
+        m_HaveCandidate = true;
+        return false;
+      }
+
+      void QueueImage(MiningTarget& target, const AVFrame* frame)
+      {
+        target.imageQueued = true;
+
+        AVFrame* copy = av_frame_clone(frame);
+        if (!copy) {
+          target.image->set_value({});
+          return;
+        }
+
+        // Account for anamorphic video so the image has the same shape as on screen
+        AVRational sar =
+            av_guess_sample_aspect_ratio(m_FormatContext, m_FormatContext->streams[m_VideoIndex], copy);
+        double aspect = (sar.num > 0 && sar.den > 0) ? av_q2d(sar) : 1.0;
+        int maxWidth = m_Options.imageMaxWidth;
+        int maxHeight = m_Options.imageMaxHeight;
+
+        m_Pool.Submit([copy, aspect, maxWidth, maxHeight, promise = target.image]() mutable {
+          // Each pool thread keeps its own scaler and with it the swscale contexts for this video size
+          static thread_local Utils::ImageScaler scaler;
+          Utils::RawImage image = scaler.ConvertFrame(copy, aspect, maxWidth, maxHeight);
+          av_frame_free(&copy);
+          promise->set_value(std::move(image));
+        });
+      }
+
+      // Audio
+
+      void HandleAudioPacket()
+      {
+        if (IsAudioDone()) {
+          // Every line has its audio, the demuxer can skip the audio from here on
+          m_FormatContext->streams[m_AudioIndex]->discard = AVDISCARD_ALL;
+          return;
+        }
+
+        if (m_AudioDecoder) {
+          if (avcodec_send_packet(m_AudioDecoder, m_Packet) == 0) {
+            ReceiveAudioFrames();
+          }
+          return;
+        }
+
+        AVStream* stream = m_FormatContext->streams[m_AudioIndex];
+        int64_t pts = m_Packet->pts != AV_NOPTS_VALUE ? m_Packet->pts : m_Packet->dts;
+        double packetStart = ToSeconds(pts, stream->time_base, m_StartTime);
+        if (std::isnan(packetStart))
+          return;
+
+        // Same packet granularity as AudioExtractionSession's stream copy
+        double packetEnd = packetStart + m_Packet->duration * av_q2d(stream->time_base);
+        UpdateProgress(packetStart);
+        ForEachOverlap(packetStart, packetEnd, [&](MiningTarget& target) {
+          if (target.remuxFailed || av_packet_ref(m_Scratch, m_Packet) < 0)
+            return;
+          target.remuxFailed = !target.remuxer->Write(m_Scratch);
+          av_packet_unref(m_Scratch);
+        });
+      }
+
+      void ReceiveAudioFrames()
+      {
+        AVStream* stream = m_FormatContext->streams[m_AudioIndex];
+        while (avcodec_receive_frame(m_AudioDecoder, m_Frame) == 0) {
+          int64_t pts =
+              m_Frame->best_effort_timestamp != AV_NOPTS_VALUE ? m_Frame->best_effort_timestamp : m_Frame->pts;
+          double frameStart = ToSeconds(pts, stream->time_base, m_StartTime);
+          if (!std::isnan(frameStart) && m_Frame->sample_rate > 0) {
+            double frameEnd = frameStart + (double) m_Frame->nb_samples / m_Frame->sample_rate;
+            UpdateProgress(frameStart);
+            // Frames are reference counted, a line only adds a reference to the decoded samples
+            ForEachOverlap(frameStart, frameEnd, [&](MiningTarget& target) {
+              if (AVFrame* copy = av_frame_clone(m_Frame)) {
+                target.frames.push_back({copy, frameStart});
+              }
+            });
+          }
+          av_frame_unref(m_Frame);
+        }
+      }
+
+      // Calls add for every line running between start and end, and finishes the lines that ended before start
+      template <typename Add>
+      void ForEachOverlap(double start, double end, Add&& add)
+      {
+        while (m_NextAudio < m_AudioOrder.size() && m_Targets[m_AudioOrder[m_NextAudio]].start <= end) {
+          size_t index = m_AudioOrder[m_NextAudio++];
+          MiningTarget& target = m_Targets[index];
+          if (!m_AudioDecoder) {
+            target.remuxer = std::make_unique<Audio::AudioClipRemuxer>();
+            target.remuxFailed = !target.remuxer->Begin(m_FormatContext->streams[m_AudioIndex]);
+          }
+          m_ActiveAudio.push_back(index);
+        }
+
+        std::erase_if(m_ActiveAudio, [&](size_t index) {
+          MiningTarget& target = m_Targets[index];
+          if (start > target.end) {
+            FinishAudio(target);
+            return true;
+          }
+          if (end >= target.start) {
+            add(target);
+          }
+          return false;
+        });
+      }
+
+      void FinishAudio(MiningTarget& target)
+      {
+        target.audioQueued = true;
+
+        if (!m_AudioDecoder) {
+          Audio::AudioClip clip;
+          if (target.remuxer) {
+            clip.data = target.remuxer->Finish();
+            clip.extension = m_RemuxExtension;
+            target.remuxer.reset();
+          }
+          if (target.remuxFailed || clip.IsEmpty()) {
+            AF_WARN("Audio stream copy failed for the line at {:.2f}", target.start);
+            clip = {};
+          }
+          target.audio->set_value(std::move(clip));
+          return;
+        }
+
+        m_Pool.Submit([frames = std::move(target.frames),
+                       start = target.start,
+                       end = target.end,
+                       options = m_Options.audio,
+                       promise = target.audio]() mutable {
+          // Reused between the clips encoded on the same pool thread, like the session's transcoder
+          static thread_local Audio::AudioClipTranscoder transcoder;
+
+          bool failed = !transcoder.Begin(options.encoderProfile);
+          bool finished = false;
+          for (auto& timed : frames) {
+            if (!failed && !finished) {
+              failed =
+                  !transcoder.AddFrame(timed.frame, timed.start, start, end, options.sampleAccurate, finished);
+            }
+            av_frame_free(&timed.frame);
+          }
+
+          promise->set_value(failed ? Audio::AudioClip{} : transcoder.Finish());
+        });
+        target.frames.clear();
+      }
+
+      ThreadPool& m_Pool;
+      std::vector<MiningTarget>& m_Targets;
+      const MiningOptions& m_Options;
+      const std::atomic<bool>& m_Cancelled;
+      std::atomic<float>& m_Progress;
+
+      AVFormatContext* m_FormatContext = nullptr;
+      double m_StartTime = 0.0;
+      double m_Duration = 0.0;
+      AVPacket* m_Packet = nullptr;
+      AVFrame* m_Frame = nullptr;
+
+      // Video: lines by midpoint, the packets since the last keyframe and the latest decoded frame
+      int m_VideoIndex = -1;
+      AVCodecContext* m_VideoDecoder = nullptr;
+      std::vector<size_t> m_ImageOrder;
+      size_t m_NextImage = 0;
+      std::vector<AVPacket*> m_Gop;
+      AVFrame* m_Candidate = nullptr;
+      bool m_HaveCandidate = false;
+
+      // Audio: lines by start and the ones the read position is in. The decoder is only open to transcode.
+      int m_AudioIndex = -1;
+      AVCodecContext* m_AudioDecoder = nullptr;
+      std::string m_RemuxExtension;
+      AVPacket* m_Scratch = nullptr;
+      std::vector<size_t> m_AudioOrder;
+      size_t m_NextAudio = 0;
+      std::vector<size_t> m_ActiveAudio;
+    };
+  } // namespace
+
+  BatchMiner::BatchMiner(ThreadPool& pool, LocalAnalysis analyze)
+      : m_Pool(pool)
+      , m_Analyze(std::move(analyze))
+  {
+  }
+
+  BatchMiner::~BatchMiner()
+  {
+    Cancel();
+    Join();
+  }
+
+  std::vector<PreparedCue> BatchMiner::Start(const std::string& videoPath,
+                                             const std::vector<Video::SubtitleCue>& cues,
+                                             const MiningOptions& options)
+  {
+    Cancel();
+    Join();
+
+    m_Cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_Progress.store(0.0f);
+
+    std::vector<PreparedCue> candidates;
+    std::vector<MiningTarget> targets;
+    auto analysis = std::make_shared<AnalysisQueue>();
+    analysis->analyze = m_Analyze;
+    analysis->cancelled = m_Cancelled;
+
+    candidates.reserve(cues.size());
+    targets.reserve(cues.size());
+    for (const auto& cue : cues) {
+      if (cue.text.empty() || cue.end <= cue.start)
+        continue;
+
+      MiningTarget target;
+      target.start = cue.start;
+      target.end = cue.end;
+      // Same snapshot time as a manual Extract: the middle of the line
+      target.midpoint = (cue.start + cue.end) / 2.0;
+      target.image = std::make_shared<std::promise<Utils::RawImage>>();
+      target.audio = std::make_shared<std::promise<Audio::AudioClip>>();
+
+      PreparedCue candidate;
+      candidate.sentence = cue.text;
+      candidate.start = cue.start;
+      candidate.end = cue.end;
+      candidate.image = target.image->get_future().share();
+      candidate.audio = target.audio->get_future().share();
+
+      auto result = std::make_shared<std::promise<nlohmann::json>>();
+      candidate.analysis = result->get_future().share();
+      analysis->sentences.push_back(cue.text);
+      analysis->results.push_back(std::move(result));
+
+      candidates.push_back(std::move(candidate));
+      targets.push_back(std::move(target));
+    }
+
+    if (candidates.empty())
+      return candidates;
+
+    AF_INFO("Mining {} lines from {}", candidates.size(), videoPath);
+
+    for (size_t i = 0, chains = GetAnalysisChains(); i < chains; ++i) {
+      m_Pool.Submit([&pool = m_Pool, analysis]() { AnalyzeNext(pool, analysis); });
+    }
+
+    m_Running.store(true);
+    m_Thread = std::thread(
+        [this, videoPath, options, cancelled = m_Cancelled, targets = std::move(targets)]() mutable {
+          {
+            MiningPass pass(m_Pool, targets, options, *cancelled, m_Progress);
+            pass.Run(videoPath);
+          }
+          m_Running.store(false);
+        });
+
+    return candidates;
+  }
+
+  void BatchMiner::Cancel()
+  {
+    if (m_Cancelled) {
+      m_Cancelled->store(true);
+    }
+  }
+
+  void BatchMiner::Join()
+  {
+    if (m_Thread.joinable()) {
+      m_Thread.join();
+    }
+  }
+
+} // namespace Video2Card::Core
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio/AudioClip.h"
+#include "core/PreparedCue.h"
+#include "core/ThreadPool.h"
+#include "video/SubtitleIndex.h"
+
+namespace Video2Card::Core
+{
+
+  /**
+   * How the media of mined lines is cut
+   */
+  struct MiningOptions
+  {
+    Audio::AudioClipOptions audio;
+    int imageMaxWidth = 320;
+    int imageMaxHeight = 320;
+  };
+
+  /**
+   * Prepares a card candidate for every subtitle line of a video in a single pass over the file
+   * Instead of a seek and a file open per line, one demuxer reads the file from start to end on a thread of
+   * its own. Video packets are buffered a keyframe interval at a time and only decoded when a line's midpoint
+   * falls into the interval, as far as the last such midpoint. Audio packets are copied into each line's clip
+   * as they go by, or decoded once and handed to the lines they overlap when the clip has to be transcoded.
+   * Frame conversion, audio encoding and the local sentence analysis run on the thread pool.
+   *
+   * Start() and Cancel() are meant for the UI thread.
+   */
+  class BatchMiner
+  {
+public:
+
+    using LocalAnalysis = std::function<nlohmann::json(const std::string& sentence)>;
+
+    /**
+     * @param pool Runs the encoding and analysis jobs, must outlive the miner
+     * @param analyze Runs the local part of the sentence analysis, called on the pool
+     */
+    BatchMiner(ThreadPool& pool, LocalAnalysis analyze);
+    ~BatchMiner();
+
+    BatchMiner(const BatchMiner&) = delete;
+    BatchMiner& operator=(const BatchMiner&) = delete;
+
+    /**
+     * Start mining a video, cancelling the previous run
+     * @param videoPath File to read
+     * @param cues Lines to mine with their text as it should end up on the card, on mpv's timeline
+     * @param options Audio cut and image size
+     * @return One candidate per line, in the order given. Their futures resolve as the pass gets to them, with
+     * empty media and a null analysis if the run fails or is cancelled first.
+     */
+    std::vector<PreparedCue>
+    Start(const std::string& videoPath, const std::vector<Video::SubtitleCue>& cues, const MiningOptions& options);
+
+    /**
+     * Stop the pass and the analyses that have not started yet. Jobs already on the pool still finish.
+     */
+    void Cancel();
+
+    /**
+     * True while the demuxer is reading the file
+     */
+    bool IsRunning() const { return m_Running.load(); }
+
+    /**
+     * Position of the demuxer in the file, from 0 to 1
+     */
+    float GetProgress() const { return m_Progress.load(); }
+
+private:
+
+    // Local analyses run in parallel, but only on half of the pool so the frames and clips keep flowing
+    size_t GetAnalysisChains() const { return std::max<size_t>(1, m_Pool.GetThreadCount() / 2); }
+
+    void Join();
+
+    ThreadPool& m_Pool;
+    LocalAnalysis m_Analyze;
+
+    std::thread m_Thread;
+    std::shared_ptr<std::atomic<bool>> m_Cancelled;
+    std::atomic<bool> m_Running{false};
+    std::atomic<float> m_Progress{0.0f};
+  };
+
+} // namespace Video2Card::Core
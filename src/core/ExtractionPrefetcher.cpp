@@ -0,0 +1,136 @@
+#include "core/ExtractionPrefetcher.h"
+
+#include <chrono>
+#include <cmath>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Core
+{
+
+  ExtractionPrefetcher::ExtractionPrefetcher(ImageRequest requestImage,
+                                             AudioRequest requestAudio,
+                                             LocalAnalysis analyze,
+                                             size_t capacity)
+      : m_RequestImage(std::move(requestImage))
+      , m_RequestAudio(std::move(requestAudio))
+      , m_Analyze(std::move(analyze))
+      , m_Capacity(capacity > 0 ? capacity : 1)
+  {
+    m_Worker = std::thread(&ExtractionPrefetcher::WorkerMain, this);
+  }
+
+  ExtractionPrefetcher::~ExtractionPrefetcher()
+  {
+    Cancel();
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      m_StopRequested = true;
+    }
+    m_QueueCondition.notify_one();
+    if (m_Worker.joinable()) {
+      m_Worker.join();
+    }
+  }
+
+  bool ExtractionPrefetcher::Matches(const PreparedCue& cue, const std::string& sentence, double start, double end)
+  {
+    // Timings come from mpv as doubles, a millisecond is well below any real difference between two lines
+    return std::abs(cue.start - start) < 0.001 && std::abs(cue.end - end) < 0.001 && cue.sentence == sentence;
+  }
+
+  void ExtractionPrefetcher::Prefetch(const std::string& sentence, double start, double end)
+  {
+    if (sentence.empty() || end <= start)
+      return;
+
+    for (const auto& cue : m_Cache) {
+      if (Matches(cue, sentence, start, end))
+        return;
+    }
+
+    AF_DEBUG("Prefetching subtitle line {:.2f}-{:.2f}: {}", start, end, sentence);
+
+    PreparedCue cue;
+    cue.sentence = sentence;
+    cue.start = start;
+    cue.end = end;
+    // Same snapshot time as a manual Extract: the middle of the line
+    cue.image = m_RequestImage((start + end) / 2.0, m_RequestsStop.get_token()).share();
+    cue.audio = m_RequestAudio(start, end, m_RequestsStop.get_token()).share();
+
+    auto result = std::make_shared<std::promise<nlohmann::json>>();
+    cue.analysis = result->get_future().share();
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      m_Jobs.push_back({sentence, result});
+    }
+    m_QueueCondition.notify_one();
+
+    m_Cache.push_front(std::move(cue));
+    if (m_Cache.size() > m_Capacity) {
+      m_Cache.pop_back();
+    }
+  }
+
+  std::optional<PreparedCue> ExtractionPrefetcher::Find(const std::string& sentence, double start, double end) const
+  {
+    for (const auto& cue : m_Cache) {
+      if (Matches(cue, sentence, start, end))
+        return cue;
+    }
+    return std::nullopt;
+  }
+
+  void ExtractionPrefetcher::Cancel()
+  {
+    m_RequestsStop.request_stop();
+    m_RequestsStop = std::stop_source();
+
+    // A stopped request may still be skipped, only lines with both results in hand are known to be complete
+    std::erase_if(m_Cache, [](const PreparedCue& cue) {
+      return cue.image.wait_for(std::chrono::seconds(0)) != std::future_status::ready ||
+             cue.audio.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    });
+
+    std::deque<AnalysisJob> dropped;
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      dropped.swap(m_Jobs);
+    }
+
+    for (auto& job : dropped) {
+      job.result->set_value(nullptr);
+    }
+  }
+
+  void ExtractionPrefetcher::Clear()
+  {
+    Cancel();
+    m_Cache.clear();
+  }
+
+  void ExtractionPrefetcher::WorkerMain()
+  {
+    while (true) {
+      AnalysisJob job;
+      {
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        m_QueueCondition.wait(lock, [this] { return m_StopRequested || !m_Jobs.empty(); });
+        if (m_Jobs.empty())
+          break;
+        // The newest line is the one the user is looking at, older ones can wait
+        job = std::move(m_Jobs.back());
+        m_Jobs.pop_back();
+      }
+
+      try {
+        job.result->set_value(m_Analyze(job.sentence));
+      } catch (const std::exception& e) {
+        AF_WARN("Prefetched analysis failed: {}", e.what());
+        job.result->set_value(nullptr);
+      }
+    }
+  }
+
+} // namespace Video2Card::Core
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "audio/AudioClip.h"
+#include "core/PreparedCue.h"
+#include "utils/RawImage.h"
+
+namespace Video2Card::Core
+{
+
+  /**
+   * Prepares the subtitle lines the user is likely to extract while the video plays
+   * For each line the snapshot and sentence audio are requested from their workers right away, and the local
+   * part of the sentence analysis is queued on a thread of its own. The results are kept in a small cache
+   * keyed by the line, so an Extract on a prepared line only has to wait for the translation.
+   *
+   * The snapshot and audio requests carry a stop token, so their workers serve direct requests first and skip a
+   * prefetch that was cancelled before it ran.
+   *
+   * Prefetch(), Find(), Cancel() and Clear() are meant for the UI thread.
+   */
+  class ExtractionPrefetcher
+  {
+public:
+
+    using ImageRequest = std::function<std::future<Utils::RawImage>(double timestamp, std::stop_token cancel)>;
+    using AudioRequest =
+        std::function<std::future<Audio::AudioClip>(double start, double end, std::stop_token cancel)>;
+    using LocalAnalysis = std::function<nlohmann::json(const std::string& sentence)>;
+
+    /**
+     * @param requestImage Requests the frame shown at a timestamp
+     * @param requestAudio Requests the audio between two timestamps
+     * @param analyze Runs the local part of the sentence analysis, called on the prefetch thread
+     * @param capacity Number of lines kept in the cache
+     */
+    ExtractionPrefetcher(ImageRequest requestImage,
+                         AudioRequest requestAudio,
+                         LocalAnalysis analyze,
+                         size_t capacity = 4);
+    ~ExtractionPrefetcher();
+
+    ExtractionPrefetcher(const ExtractionPrefetcher&) = delete;
+    ExtractionPrefetcher& operator=(const ExtractionPrefetcher&) = delete;
+
+    /**
+     * Start preparing a line unless it is cached already
+     * @param sentence Subtitle text, as it would end up on the card
+     * @param start Start time in seconds
+     * @param end End time in seconds
+     */
+    void Prefetch(const std::string& sentence, double start, double end);
+
+    /**
+     * Look up a prepared line
+     * @return The line, or nothing if it was never prefetched or has been evicted
+     */
+    std::optional<PreparedCue> Find(const std::string& sentence, double start, double end) const;
+
+    /**
+     * Drop the work that has not started yet, e.g. after a seek. Lines whose snapshot or audio was still pending
+     * are forgotten, the others stay and their analysis resolves to null if it had not started.
+     */
+    void Cancel();
+
+    /**
+     * Forget every line, e.g. when another video is loaded
+     */
+    void Clear();
+
+private:
+
+    struct AnalysisJob
+    {
+      std::string sentence;
+      std::shared_ptr<std::promise<nlohmann::json>> result;
+    };
+
+    static bool Matches(const PreparedCue& cue, const std::string& sentence, double start, double end);
+
+    void WorkerMain();
+
+    ImageRequest m_RequestImage;
+    AudioRequest m_RequestAudio;
+    LocalAnalysis m_Analyze;
+    size_t m_Capacity;
+
+    // Most recently prefetched line first, UI thread only
+    std::deque<PreparedCue> m_Cache;
+    // Stops the snapshot and audio requests made since the last Cancel(), UI thread only
+    std::stop_source m_RequestsStop;
+
+    std::thread m_Worker;
+    std::mutex m_QueueMutex;
+    std::condition_variable m_QueueCondition;
+    std::deque<AnalysisJob> m_Jobs;
+    bool m_StopRequested = false;
+  };
+
+} // namespace Video2Card::Core
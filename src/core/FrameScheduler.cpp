@@ -0,0 +1,172 @@
+#include "core/FrameScheduler.h"
+
+#include <algorithm>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Core
+{
+
+  bool FrameScheduler::Initialize()
+  {
+    m_WakeEventType = SDL_RegisterEvents(1);
+    if (m_WakeEventType == 0) {
+      AF_WARN("Failed to register frame scheduler wake event, falling back to polling");
+      return false;
+    }
+
+    m_FrameStartTime = 0;
+    m_LastInputTime = SDL_GetTicksNS();
+    return true;
+  }
+
+  void FrameScheduler::RequestWake()
+  {
+    if (m_WakeEventType == 0)
+      return;
+
+    // One pending wake event is enough, the main loop handles everything that changed once it runs
+    if (m_WakePending.exchange(true))
+      return;
+
+    SDL_Event event{};
+    event.type = m_WakeEventType;
+    if (!SDL_PushEvent(&event)) {
+      m_WakePending.store(false);
+    }
+  }
+
+  bool FrameScheduler::IsWakeEvent(const SDL_Event& event)
+  {
+    if (m_WakeEventType == 0 || event.type != m_WakeEventType)
+      return false;
+
+    m_WakePending.store(false);
+    return true;
+  }
+
+  void FrameScheduler::NotifyInput()
+  {
+    m_LastInputTime = SDL_GetTicksNS();
+  }
+
+  void FrameScheduler::SetPlayback(bool playing, double videoFrameRate)
+  {
+    m_Playing = playing;
+    m_VideoFrameRate = videoFrameRate;
+  }
+
+  void FrameScheduler::SetDisplayRefreshRate(float refreshRate)
+  {
+    // Some drivers report 0 for an unknown refresh rate
+    m_DisplayRefreshRate = refreshRate > 0.0f ? refreshRate : 60.0;
+  }
+
+  FrameMode FrameScheduler::ComputeMode(uint64_t now) const
+  {
+    if (m_WakeEventType == 0)
+      return FrameMode::Interactive;
+
+    if (now - m_LastInputTime < INTERACTIVE_LINGER_NS)
+      return FrameMode::Interactive;
+
+    if (m_Playing)
+      return FrameMode::Playback;
+
+    if (m_Busy)
+      return FrameMode::Busy;
+
+    return FrameMode::Idle;
+  }
+
+  double FrameScheduler::GetTargetFrameRate() const
+  {
+    switch (m_Mode) {
+      case FrameMode::Playback:
+        if (m_VideoFrameRate > 0.0)
+          return std::min(m_VideoFrameRate, m_DisplayRefreshRate);
+        return m_DisplayRefreshRate;
+      case FrameMode::Busy:
+        return std::min(BUSY_FRAME_RATE, m_DisplayRefreshRate);
+      default:
+        return m_DisplayRefreshRate;
+    }
+  }
+
+  void FrameScheduler::WaitForNextFrame()
+  {
+    uint64_t now = SDL_GetTicksNS();
+    m_Mode = ComputeMode(now);
+
+    if (m_Mode == FrameMode::Idle) {
+      // The timeout only matters for state changed by threads that don't wake us (status messages and such)
+      SDL_WaitEventTimeout(nullptr, IDLE_TIMEOUT_MS);
+      return;
+    }
+
+    if (m_FrameStartTime == 0)
+      return;
+
+    uint64_t interval = static_cast<uint64_t>(1'000'000'000.0 / GetTargetFrameRate());
+    uint64_t nextFrame = m_FrameStartTime + interval;
+    if (now >= nextFrame)
+      return;
+
+    // Sleep the coarse part while still reacting to input, then the sub-millisecond rest
+    int32_t timeoutMs = static_cast<int32_t>((nextFrame - now) / 1'000'000);
+    if (timeoutMs > 0 && SDL_WaitEventTimeout(nullptr, timeoutMs))
+      return;
+
+    now = SDL_GetTicksNS();
+    if (now < nextFrame) {
+      SDL_DelayNS(nextFrame - now);
+    }
+  }
+
+  void FrameScheduler::BeginFrame()
+  {
+    m_FrameStartTime = SDL_GetTicksNS();
+  }
+
+  void FrameScheduler::EndFrame()
+  {
+    uint64_t now = SDL_GetTicksNS();
+
+    m_FrameDurations[m_FrameIndex] = now - m_FrameStartTime;
+    m_FrameStarts[m_FrameIndex] = m_FrameStartTime;
+    m_FrameIndex = (m_FrameIndex + 1) % FRAME_HISTORY;
+    m_FrameCount = std::min(m_FrameCount + 1, FRAME_HISTORY);
+
+    uint64_t total = 0;
+    uint64_t longest = 0;
+    uint64_t oldestStart = m_FrameStartTime;
+    for (size_t i = 0; i < m_FrameCount; ++i) {
+      total += m_FrameDurations[i];
+      longest = std::max(longest, m_FrameDurations[i]);
+      oldestStart = std::min(oldestStart, m_FrameStarts[i]);
+    }
+
+    m_Stats.averageFrameMs = total / 1e6 / m_FrameCount;
+    m_Stats.maxFrameMs = longest / 1e6;
+
+    // Frame rate over the recorded window, idle gaps included
+    uint64_t span = m_FrameStartTime - oldestStart;
+    m_Stats.framesPerSecond = (m_FrameCount > 1 && span > 0) ? (m_FrameCount - 1) * 1e9 / span : 0.0;
+  }
+
+  std::string_view FrameScheduler::ModeToString(FrameMode mode)
+  {
+    switch (mode) {
+      case FrameMode::Idle:
+        return "Idle";
+      case FrameMode::Interactive:
+        return "Interactive";
+      case FrameMode::Playback:
+        return "Playback";
+      case FrameMode::Busy:
+        return "Busy";
+    }
+    return "Unknown";
+  }
+
+} // namespace Video2Card::Core
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+namespace Video2Card::Core
+{
+
+  enum class FrameMode
+  {
+    Idle,        // Nothing is changing, block until an event arrives
+    Interactive, // Recent input, redraw at display refresh for a short while
+    Playback,    // Video is playing, redraw at the video frame rate
+    Busy         // Background work is running and the UI shows its progress
+  };
+
+  struct FrameStats
+  {
+    double averageFrameMs = 0.0; // Time spent producing a frame (update + render)
+    double maxFrameMs = 0.0;
+    double framesPerSecond = 0.0; // Frames actually produced per second
+  };
+
+  /**
+   * Decides when the main loop should produce the next frame
+   * While idle the loop blocks in SDL_WaitEventTimeout instead of spinning, so the app costs nothing while it
+   * sits next to Anki. Input, mpv frame updates and finished background tasks wake it up through SDL events.
+   * During playback the redraw rate is capped to the video frame rate (or the display refresh, if lower).
+   */
+  class FrameScheduler
+  {
+public:
+
+    FrameScheduler() = default;
+
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    /**
+     * Register the wake event type. Call after SDL_Init
+     * @return true on success
+     */
+    bool Initialize();
+
+    /**
+     * Wake the main loop from any thread. Multiple requests before the loop runs are coalesced into one event
+     */
+    void RequestWake();
+
+    /**
+     * @return true if the event is a wake request (it carries no other information)
+     */
+    bool IsWakeEvent(const SDL_Event& event);
+
+    /**
+     * Record user input, which keeps the loop in interactive mode for a short while
+     */
+    void NotifyInput();
+
+    void SetPlayback(bool playing, double videoFrameRate);
+    void SetBusy(bool busy) { m_Busy = busy; }
+    void SetDisplayRefreshRate(float refreshRate);
+
+    /**
+     * Block until the next frame is due or an event arrives
+     */
+    void WaitForNextFrame();
+
+    void BeginFrame();
+    void EndFrame();
+
+    FrameMode GetMode() const { return m_Mode; }
+    const FrameStats& GetStats() const { return m_Stats; }
+
+    static std::string_view ModeToString(FrameMode mode);
+
+private:
+
+    FrameMode ComputeMode(uint64_t now) const;
+    double GetTargetFrameRate() const;
+
+    static constexpr uint64_t INTERACTIVE_LINGER_NS = 300'000'000;
+    static constexpr int32_t IDLE_TIMEOUT_MS = 500;
+    static constexpr double BUSY_FRAME_RATE = 30.0;
+    static constexpr size_t FRAME_HISTORY = 120;
+
+    uint32_t m_WakeEventType = 0;
+    std::atomic<bool> m_WakePending{false};
+
+    FrameMode m_Mode = FrameMode::Interactive;
+    uint64_t m_LastInputTime = 0;
+    bool m_Playing = false;
+    bool m_Busy = false;
+    double m_VideoFrameRate = 0.0;
+    double m_DisplayRefreshRate = 60.0;
+
+    uint64_t m_FrameStartTime = 0;
+    std::array<uint64_t, FRAME_HISTORY> m_FrameDurations{};
+    std::array<uint64_t, FRAME_HISTORY> m_FrameStarts{};
+    size_t m_FrameIndex = 0;
+    size_t m_FrameCount = 0;
+    FrameStats m_Stats;
+  };
+
+} // namespace Video2Card::Core
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <future>
+#include <nlohmann/json.hpp>
+#include <string>
+
+#include "audio/AudioClip.h"
+#include "utils/RawImage.h"
+
+namespace Video2Card::Core
+{
+
+  /**
+   * A subtitle line with its card media being prepared ahead of an Extract
+   */
+  struct PreparedCue
+  {
+    std::string sentence;
+    double start = 0.0;
+    double end = 0.0;
+    std::shared_future<Utils::RawImage> image;
+    std::shared_future<Audio::AudioClip> audio;
+    // Everything the analyzer does locally (furigana, readings, dictionary, pitch accent), without the
+    // translation. Null if the analysis was cancelled before it ran.
+    std::shared_future<nlohmann::json> analysis;
+  };
+
+} // namespace Video2Card::Core
@@ -0,0 +1,61 @@
+#include "core/ThreadPool.h"
+
+#include <algorithm>
+
+namespace Video2Card::Core
+{
+
+  ThreadPool::ThreadPool(size_t threadCount)
+  {
+    if (threadCount == 0) {
+      unsigned int cores = std::thread::hardware_concurrency();
+      threadCount = std::max(1u, cores > 1 ? cores - 1 : 1u);
+    }
+
+    m_Workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+      m_Workers.emplace_back(&ThreadPool::WorkerMain, this);
+    }
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      m_StopRequested = true;
+    }
+    m_QueueCondition.notify_all();
+    for (auto& worker : m_Workers) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+  }
+
+  void ThreadPool::Post(std::function<void()> job)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      m_Jobs.push_back(std::move(job));
+    }
+    m_QueueCondition.notify_one();
+  }
+
+  void ThreadPool::WorkerMain()
+  {
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        m_QueueCondition.wait(lock, [this] { return m_StopRequested || !m_Jobs.empty(); });
+        // Outstanding jobs still run so that no promise is left unfulfilled
+        if (m_Jobs.empty())
+          break;
+        job = std::move(m_Jobs.front());
+        m_Jobs.pop_front();
+      }
+      job();
+    }
+  }
+
+} // namespace Video2Card::Core
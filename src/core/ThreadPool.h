@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Video2Card::Core
+{
+
+  /**
+   * A fixed set of worker threads for CPU-bound jobs such as encoding clips and scaling frames
+   * Jobs run in the order they were submitted. The destructor waits for the queued jobs to finish, so a future
+   * returned by Submit() is always fulfilled.
+   */
+  class ThreadPool
+  {
+public:
+
+    /**
+     * @param threadCount Number of workers, 0 for one per core minus one for the UI thread
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Queue a job
+     * @return Future with the job's result, or the exception it threw
+     */
+    template <typename Job>
+    auto Submit(Job&& job) -> std::future<std::invoke_result_t<std::decay_t<Job>>>
+    {
+      using Result = std::invoke_result_t<std::decay_t<Job>>;
+
+      // std::function needs something copyable, the task itself is move-only
+      auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Job>(job));
+      std::future<Result> result = task->get_future();
+      Post([task]() { (*task)(); });
+      return result;
+    }
+
+    size_t GetThreadCount() const { return m_Workers.size(); }
+
+private:
+
+    void Post(std::function<void()> job);
+    void WorkerMain();
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_QueueMutex;
+    std::condition_variable m_QueueCondition;
+    std::deque<std::function<void()>> m_Jobs;
+    bool m_StopRequested = false;
+  };
+
+} // namespace Video2Card::Core
@@ -1,6 +1,8 @@
 #include "SentenceAnalyzer.h"
 
+#include <future>
 #include <stdexcept>
+#include <utility>
 
 #include "core/Logger.h"
 #include "language/ILanguage.h"
@@ -11,6 +13,10 @@
 #include "language/services/DeepLService.h"
 #include "language/services/GoogleTranslateService.h"
 #include "language/services/ILanguageService.h"
+#include "language/translation/CachingTranslator.h"
+#include "language/translation/TranslationCache.h"
+#include "language/translation/TranslatorHealthMonitor.h"
+#include "utils/FileUtils.h"
 
 namespace Video2Card::Language::Analyzer
 {
@@ -22,17 +28,45 @@ namespace Video2Card::Language::Analyzer
       , m_DictClient(nullptr)
       , m_PitchAccent(nullptr)
       , m_PreferredTranslatorId("")
+      , m_TranslationCache(nullptr)
+      , m_TranslatorHealth(nullptr)
   {}
 
+  SentenceAnalyzer::~SentenceAnalyzer() = default;
+
   void SentenceAnalyzer::SetLanguageServices(const std::vector<std::unique_ptr<Services::ILanguageService>>* services)
   {
+    // Stop probing the previous services before they go away
+    m_TranslatorHealth.reset();
     m_LanguageServices = services;
+
+    if (!m_LanguageServices) {
+      return;
+    }
+
+    m_TranslatorHealth = std::make_unique<Translation::TranslatorHealthMonitor>();
+    for (const auto& service : *m_LanguageServices) {
+      if (service->GetType() != "translator") {
+        continue;
+      }
+
+      const Services::ILanguageService* watched = service.get();
+      m_TranslatorHealth->Register(service->GetId(), [watched]() {
+        // A service without a translator is not configured, which IsAvailable() of the service already covers
+        auto translator = GetServiceTranslator(*watched);
+        return !translator || translator->Probe();
+      });
+    }
   }
 
   void SentenceAnalyzer::SetPreferredTranslator(const std::string& translatorId)
   {
     m_PreferredTranslatorId = translatorId;
     AF_INFO("SentenceAnalyzer: Preferred translator set to '{}'", translatorId);
+
+    if (m_TranslatorHealth) {
+      m_TranslatorHealth->Recheck(translatorId);
+    }
   }
 
   bool SentenceAnalyzer::Initialize(const std::string& basePath)
@@ -66,6 +100,17 @@ namespace Video2Card::Language::Analyzer
         m_PitchAccent = nullptr;
       }
 
+      // Initialize translation cache
+      std::string cacheDir = Utils::FileUtils::GetCachePath();
+      if (!cacheDir.empty()) {
+        try {
+          m_TranslationCache = std::make_shared<Translation::TranslationCache>(cacheDir + "translations.db");
+        } catch (const std::exception& e) {
+          AF_WARN("Failed to open translation cache, translating without it: {}", e.what());
+          m_TranslationCache = nullptr;
+        }
+      }
+
       return true;
 
     } catch (const std::exception& e) {
@@ -76,6 +121,90 @@ namespace Video2Card::Language::Analyzer
 
   nlohmann::json
   SentenceAnalyzer::AnalyzeSentence(const std::string& sentence, const std::string& targetWord, ILanguage* language)
+  {
+    // The translation waits on the network, the local analysis runs meanwhile
+    auto translation = std::async(std::launch::async, [this, sentence]() { return TranslateSentence(sentence); });
+
+    nlohmann::json result = AnalyzeLocally(sentence, targetWord, language);
+    std::string translated = translation.get();
+    if (!result.contains("error")) {
+      result["translation"] = std::move(translated);
+    }
+    return result;
+  }
+
+  std::string SentenceAnalyzer::TranslateSentence(const std::string& sentence)
+  {
+    std::string serviceId;
+    auto translator = GetTranslator(serviceId);
+    if (!translator || sentence.empty())
+      return "";
+
+    if (m_TranslationCache) {
+      translator = std::make_shared<Translation::CachingTranslator>(std::move(translator), m_TranslationCache);
+    }
+
+    std::string translation;
+    try {
+      translation = translator->Translate(sentence);
+    } catch (const std::exception& e) {
+      AF_WARN("Translation failed: {}", e.what());
+    }
+
+    // A line that comes back unchanged (a name, a number, the same language) is a valid answer, not a failure
+    if (m_TranslatorHealth) {
+      if (translation.empty())
+        m_TranslatorHealth->ReportFailure(serviceId);
+      else
+        m_TranslatorHealth->ReportSuccess(serviceId);
+    }
+
+    return translation;
+  }
+
+  std::vector<std::string> SentenceAnalyzer::TranslateSentences(std::span<const std::string_view> sentences)
+  {
+    std::string serviceId;
+    auto translator = GetTranslator(serviceId);
+    if (!translator || sentences.empty())
+      return std::vector<std::string>(sentences.size());
+
+    if (m_TranslationCache) {
+      translator = std::make_shared<Translation::CachingTranslator>(std::move(translator), m_TranslationCache);
+    }
+
+    std::vector<std::string> translations;
+    try {
+      translations = translator->TranslateBatch(sentences);
+    } catch (const std::exception& e) {
+      AF_WARN("Translation of {} sentences failed: {}", sentences.size(), e.what());
+    }
+    translations.resize(sentences.size());
+
+    // A request that failed only takes its own lines with it, the translator is down if none went through
+    bool translated = false;
+    bool failed = false;
+    for (size_t i = 0; i < sentences.size(); ++i) {
+      if (sentences[i].empty())
+        continue;
+      if (translations[i].empty())
+        failed = true;
+      else
+        translated = true;
+    }
+
+    if (m_TranslatorHealth) {
+      if (translated)
+        m_TranslatorHealth->ReportSuccess(serviceId);
+      else if (failed)
+        m_TranslatorHealth->ReportFailure(serviceId);
+    }
+
+    return translations;
+  }
+
+  nlohmann::json
+  SentenceAnalyzer::AnalyzeLocally(const std::string& sentence, const std::string& targetWord, ILanguage* language)
   {
     (void) language; // Not currently used
 
@@ -92,33 +221,58 @@ namespace Video2Card::Language::Analyzer
     }
 
     try {
+      // The sentence is tokenized once, the target word, its dictionary form, reading and the furigana all come
+      // from these tokens
+      Morphology::TokenizedText sentenceTokens;
+      m_MorphAnalyzer->Tokenize(sentence, sentenceTokens);
+
       // Determine the target word
-      std::string focusWord = targetWord.empty() ? SelectTargetWord(sentence) : targetWord;
+      WordTokens word;
+      std::string focusWord = targetWord;
+      if (focusWord.empty()) {
+        size_t index = SelectTargetToken(sentenceTokens);
+        if (index < sentenceTokens.Size()) {
+          focusWord = sentenceTokens.Surface(sentenceTokens[index]);
+          word = {&sentenceTokens, index, index + 1};
+        }
+      }
 
       if (focusWord.empty()) {
         AF_WARN("Could not determine target word for sentence: {}", sentence);
         focusWord = "詞"; // Fallback
       }
 
+      // A typed word that does not line up with the tokens of the sentence is analyzed on its own
+      Morphology::TokenizedText ownWordTokens;
+      if (word.Empty() && !FindWordTokens(sentenceTokens, focusWord, word)) {
+        m_MorphAnalyzer->Tokenize(focusWord, ownWordTokens);
+        word = {&ownWordTokens, 0, ownWordTokens.Size()};
+      }
+
       // Generate furigana for the sentence
       std::string sentenceWithFurigana = sentence;
       if (m_FuriganaGen) {
         try {
-          sentenceWithFurigana = m_FuriganaGen->Generate(sentence);
+          sentenceWithFurigana = m_FuriganaGen->GenerateFromTokens(sentenceTokens);
         } catch (const std::exception& e) {
           AF_WARN("Failed to generate furigana: {}", e.what());
         }
       }
 
       // Get the dictionary form and reading of the target word
-      std::string dictionaryForm = GetDictionaryForm(focusWord);
-      std::string reading = GetReading(focusWord);
+      std::string dictionaryForm = GetDictionaryForm(focusWord, word);
+      std::string reading = GetReading(word);
 
       std::string targetWordFurigana;
       if (m_FuriganaGen && !reading.empty()) {
         try {
           std::string wordToAnnotate = dictionaryForm.empty() ? focusWord : dictionaryForm;
-          targetWordFurigana = m_FuriganaGen->GenerateForWord(wordToAnnotate);
+          // Only an inflected word needs its dictionary form analyzed again
+          if (wordToAnnotate == focusWord && !word.Empty()) {
+            targetWordFurigana = m_FuriganaGen->GenerateForWordFromTokens(*word.tokens, word.begin, word.end);
+          } else {
+            targetWordFurigana = m_FuriganaGen->GenerateForWord(wordToAnnotate);
+          }
         } catch (const std::exception& e) {
           AF_WARN("Failed to generate target word furigana: {}", e.what());
           targetWordFurigana = dictionaryForm.empty() ? focusWord : dictionaryForm;
@@ -138,17 +292,6 @@ namespace Video2Card::Language::Analyzer
         }
       }
 
-      // Translate the sentence using language services
-      std::string translation;
-      auto translator = GetTranslator();
-      if (translator) {
-        try {
-          translation = translator->Translate(sentence);
-        } catch (const std::exception& e) {
-          AF_WARN("Translation failed: {}", e.what());
-        }
-      }
-
       // Look up pitch accent
       std::string pitchAccent;
       if (m_PitchAccent) {
@@ -166,7 +309,7 @@ namespace Video2Card::Language::Analyzer
 
       // Build the result JSON
       result["sentence"] = sentence;
-      result["translation"] = translation;
+      result["translation"] = "";
       result["target_word"] = dictionaryForm.empty() ? focusWord : dictionaryForm;
       result["target_word_furigana"] = targetWordFurigana;
       result["furigana"] = sentenceWithFurigana;
@@ -189,47 +332,35 @@ namespace Video2Card::Language::Analyzer
     return m_MorphAnalyzer && m_FuriganaGen;
   }
 
-  std::shared_ptr<Translation::ITranslator> SentenceAnalyzer::GetTranslator() const
+  std::shared_ptr<Translation::ITranslator> SentenceAnalyzer::GetTranslator(std::string& serviceId) const
   {
     if (!m_LanguageServices) {
       return nullptr;
     }
 
+    auto isUsable = [this](const Services::ILanguageService& service) {
+      return service.GetType() == "translator" && service.IsAvailable() &&
+             (!m_TranslatorHealth || m_TranslatorHealth->IsAvailable(service.GetId()));
+    };
+
     if (!m_PreferredTranslatorId.empty()) {
       for (const auto& service : *m_LanguageServices) {
-        if (service->GetType() == "translator" && service->GetId() == m_PreferredTranslatorId && service->IsAvailable())
-        {
-          if (service->GetId() == "google_translate") {
-            auto* googleService = dynamic_cast<Services::GoogleTranslateService*>(service.get());
-            if (googleService) {
-              AF_INFO("GetTranslator: Using preferred Google Translate translator");
-              return googleService->GetTranslator();
-            }
-          } else if (service->GetId() == "deepl") {
-            auto* deeplService = dynamic_cast<Services::DeepLService*>(service.get());
-            if (deeplService) {
-              AF_INFO("GetTranslator: Using preferred DeepL translator");
-              return deeplService->GetTranslator();
-            }
+        if (service->GetId() == m_PreferredTranslatorId && isUsable(*service)) {
+          if (auto translator = GetServiceTranslator(*service)) {
+            AF_INFO("GetTranslator: Using preferred translator '{}'", service->GetId());
+            serviceId = service->GetId();
+            return translator;
           }
         }
       }
     }
 
     for (const auto& service : *m_LanguageServices) {
-      if (service->GetType() == "translator" && service->IsAvailable()) {
-        if (service->GetId() == "google_translate") {
-          auto* googleService = dynamic_cast<Services::GoogleTranslateService*>(service.get());
-          if (googleService) {
-            AF_INFO("GetTranslator: Using Google Translate translator");
-            return googleService->GetTranslator();
-          }
-        } else if (service->GetId() == "deepl") {
-          auto* deeplService = dynamic_cast<Services::DeepLService*>(service.get());
-          if (deeplService) {
-            AF_INFO("GetTranslator: Using DeepL translator");
-            return deeplService->GetTranslator();
-          }
+      if (isUsable(*service)) {
+        if (auto translator = GetServiceTranslator(*service)) {
+          AF_INFO("GetTranslator: Using translator '{}'", service->GetId());
+          serviceId = service->GetId();
+          return translator;
         }
       }
     }
@@ -237,43 +368,82 @@ namespace Video2Card::Language::Analyzer
     return nullptr;
   }
 
-  std::string SentenceAnalyzer::SelectTargetWord(const std::string& sentence)
+  std::shared_ptr<Translation::ITranslator>
+  SentenceAnalyzer::GetServiceTranslator(const Services::ILanguageService& service)
   {
-    if (!m_MorphAnalyzer) {
-      return "";
+    if (service.GetId() == "google_translate") {
+      auto* googleService = dynamic_cast<const Services::GoogleTranslateService*>(&service);
+      if (googleService) {
+        return googleService->GetTranslator();
+      }
+    } else if (service.GetId() == "deepl") {
+      auto* deeplService = dynamic_cast<const Services::DeepLService*>(&service);
+      if (deeplService) {
+        return deeplService->GetTranslator();
+      }
     }
 
-    try {
-      auto tokens = m_MorphAnalyzer->Analyze(sentence);
-
-      // Find the first content word (noun, verb, or adjective)
-      for (const auto& token : tokens) {
-        if (!token.surface.empty() &&
-            (token.partOfSpeech == "名詞" || token.partOfSpeech == "動詞" || token.partOfSpeech == "形容詞"))
-        {
-          return token.surface;
-        }
+    return nullptr;
+  }
+
+  size_t SentenceAnalyzer::SelectTargetToken(const Morphology::TokenizedText& tokens)
+  {
+    // Find the first content word (noun, verb, or adjective)
+    for (size_t i = 0; i < tokens.Size(); ++i) {
+      if (tokens[i].surface.length > 0 && Morphology::IsContentWord(tokens[i].partOfSpeech)) {
+        return i;
       }
+    }
 
-      // If no content word found, return the first non-empty token
-      for (const auto& token : tokens) {
-        if (!token.surface.empty()) {
-          return token.surface;
-        }
+    // If no content word found, return the first non-empty token
+    for (size_t i = 0; i < tokens.Size(); ++i) {
+      if (tokens[i].surface.length > 0) {
+        return i;
       }
-    } catch (const std::exception& e) {
-      AF_WARN("Failed to select target word: {}", e.what());
     }
 
-    return "";
+    return tokens.Size();
   }
 
-  std::string SentenceAnalyzer::GetDictionaryForm(const std::string& surface)
+  bool SentenceAnalyzer::FindWordTokens(const Morphology::TokenizedText& tokens,
+                                        std::string_view word,
+                                        WordTokens& result)
   {
-    if (!m_MorphAnalyzer) {
-      return surface;
+    if (word.empty()) {
+      return false;
+    }
+
+    std::string_view text = tokens.Text();
+    for (size_t position = text.find(word); position != std::string_view::npos;
+         position = text.find(word, position + 1))
+    {
+      size_t wordEnd = position + word.size();
+
+      size_t begin = 0;
+      while (begin < tokens.Size() && tokens[begin].surface.offset < position) {
+        ++begin;
+      }
+      if (begin == tokens.Size() || tokens[begin].surface.offset != position) {
+        continue;
+      }
+
+      for (size_t end = begin; end < tokens.Size(); ++end) {
+        size_t tokenEnd = tokens[end].surface.offset + tokens[end].surface.length;
+        if (tokenEnd == wordEnd) {
+          result = {&tokens, begin, end + 1};
+          return true;
+        }
+        if (tokenEnd > wordEnd) {
+          break;
+        }
+      }
     }
 
+    return false;
+  }
+
+  std::string SentenceAnalyzer::GetDictionaryForm(const std::string& surface, const WordTokens& word)
+  {
     if (m_DictClient) {
       try {
         auto dictEntry = m_DictClient->LookupWord(surface, "");
@@ -286,62 +456,47 @@ namespace Video2Card::Language::Analyzer
       }
     }
 
-    try {
-      auto tokens = m_MorphAnalyzer->Analyze(surface);
-      if (tokens.empty()) {
-        return surface;
-      }
+    if (word.Empty()) {
+      return surface;
+    }
 
-      if (tokens.size() == 1) {
-        return tokens[0].headword;
-      }
+    const auto& tokens = *word.tokens;
+    if (word.end - word.begin == 1) {
+      return std::string(tokens.Headword(tokens[word.begin]));
+    }
 
-      std::string combined;
-      for (const auto& token : tokens) {
-        combined += token.headword;
-      }
+    std::string combined;
+    for (size_t i = word.begin; i < word.end; ++i) {
+      combined += tokens.Headword(tokens[i]);
+    }
 
-      if (m_DictClient) {
-        try {
-          auto dictEntry = m_DictClient->LookupWord(combined, "");
-          if (!dictEntry.definition.empty()) {
-            AF_DEBUG("Found combined form '{}' in dictionary", combined);
-            return combined;
-          }
-        } catch (const std::exception& e) {
-          AF_DEBUG("Dictionary lookup failed for combined '{}': {}", combined, e.what());
+    if (m_DictClient) {
+      try {
+        auto dictEntry = m_DictClient->LookupWord(combined, "");
+        if (!dictEntry.definition.empty()) {
+          AF_DEBUG("Found combined form '{}' in dictionary", combined);
+          return combined;
         }
+      } catch (const std::exception& e) {
+        AF_DEBUG("Dictionary lookup failed for combined '{}': {}", combined, e.what());
       }
-
-      return tokens[0].headword;
-    } catch (const std::exception& e) {
-      AF_WARN("Failed to get dictionary form: {}", e.what());
-      return surface;
     }
+
+    return std::string(tokens.Headword(tokens[word.begin]));
   }
 
-  std::string SentenceAnalyzer::GetReading(const std::string& surface)
+  std::string SentenceAnalyzer::GetReading(const WordTokens& word)
   {
-    if (!m_MorphAnalyzer) {
+    if (word.Empty()) {
       return "";
     }
 
-    try {
-      auto tokens = m_MorphAnalyzer->Analyze(surface);
-      if (tokens.empty()) {
-        return "";
-      }
-
-      std::string combinedReading;
-      for (const auto& token : tokens) {
-        combinedReading += token.katakanaReading;
-      }
-
-      return combinedReading;
-    } catch (const std::exception& e) {
-      AF_WARN("Failed to get reading: {}", e.what());
-      return "";
+    std::string combinedReading;
+    for (size_t i = word.begin; i < word.end; ++i) {
+      combinedReading += word.tokens->Reading((*word.tokens)[i]);
     }
+
+    return combinedReading;
   }
 
 } // namespace Video2Card::Language::Analyzer
\ No newline at end of file
@@ -2,7 +2,9 @@
 
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Video2Card::Language
@@ -18,6 +20,7 @@ namespace Video2Card::Language::Services
 namespace Video2Card::Language::Morphology
 {
   class IMorphologicalAnalyzer;
+  class TokenizedText;
 }
 
 namespace Video2Card::Language::Furigana
@@ -33,6 +36,8 @@ namespace Video2Card::Language::Dictionary
 namespace Video2Card::Language::Translation
 {
   class ITranslator;
+  class TranslatorHealthMonitor;
+  class TranslationCache;
 }
 
 namespace Video2Card::Language::PitchAccent
@@ -53,10 +58,11 @@ namespace Video2Card::Language::Analyzer
 public:
 
     SentenceAnalyzer();
-    ~SentenceAnalyzer() = default;
+    ~SentenceAnalyzer();
 
     /**
    * Set the language services to use for analysis.
+   * Their translators are watched by a health monitor from then on, the services must outlive the analyzer.
    * @param services Vector of available language services
    */
     void SetLanguageServices(const std::vector<std::unique_ptr<Services::ILanguageService>>* services);
@@ -84,6 +90,36 @@ public:
     [[nodiscard]] nlohmann::json
     AnalyzeSentence(const std::string& sentence, const std::string& targetWord, ILanguage* language = nullptr);
 
+    /**
+   * Analyze a sentence with the local resources only (MeCab, dictionary, pitch accent).
+   * Same result as AnalyzeSentence() with an empty translation, cheap enough to run ahead of time.
+   * Safe to call from several threads at once.
+   * @param sentence The sentence to analyze
+   * @param targetWord Optional target word to focus on
+   * @param language The language configuration (unused for now)
+   * @return JSON with analysis results
+   */
+    [[nodiscard]] nlohmann::json
+    AnalyzeLocally(const std::string& sentence, const std::string& targetWord, ILanguage* language = nullptr);
+
+    /**
+   * Translate a sentence with the preferred translator.
+   * Translators the health monitor marked as down are skipped without a request, repeated sentences are answered
+   * from the translation cache.
+   * @param sentence The sentence to translate
+   * @return The translation, empty if no translator is available or it failed
+   */
+    [[nodiscard]] std::string TranslateSentence(const std::string& sentence);
+
+    /**
+   * Translate many sentences with the preferred translator, in as few requests as it allows.
+   * Goes through the translation cache like TranslateSentence(), so a later TranslateSentence() of one of the
+   * sentences is answered from it.
+   * @param sentences The sentences to translate, e.g. every line of an episode
+   * @return One translation per sentence, in the same order, empty if no translator is available
+   */
+    [[nodiscard]] std::vector<std::string> TranslateSentences(std::span<const std::string_view> sentences);
+
     /**
    * Check if the analyzer is ready to use.
    * @return true if all required components are initialized
@@ -94,30 +130,63 @@ private:
 
     /**
    * Get the translator from language services.
+   * Only cheap checks, the reachability of the provider comes from the health monitor.
+   * @param serviceId Receives the ID of the service the translator belongs to
    * @return Translator instance or nullptr
    */
-    [[nodiscard]] std::shared_ptr<Translation::ITranslator> GetTranslator() const;
+    [[nodiscard]] std::shared_ptr<Translation::ITranslator> GetTranslator(std::string& serviceId) const;
+
+    /**
+   * Get the translator of a translator service.
+   * @param service The service
+   * @return Translator instance or nullptr if the service has none
+   */
+    [[nodiscard]] static std::shared_ptr<Translation::ITranslator>
+    GetServiceTranslator(const Services::ILanguageService& service);
+
+    /**
+   * The tokens making up the target word, a range of the sentence's tokens when the word lines up with them.
+   */
+    struct WordTokens
+    {
+      const Morphology::TokenizedText* tokens = nullptr;
+      size_t begin = 0;
+      size_t end = 0;
+
+      [[nodiscard]] bool Empty() const { return !tokens || begin >= end; }
+    };
 
     /**
    * Select the target word if not provided.
-   * @param sentence The sentence to analyze
-   * @return The selected target word
+   * @param tokens The tokens of the sentence
+   * @return Index of the selected token, tokens.Size() if there is none
+   */
+    [[nodiscard]] static size_t SelectTargetToken(const Morphology::TokenizedText& tokens);
+
+    /**
+   * Find a word in the tokens of the sentence.
+   * @param tokens The tokens of the sentence
+   * @param word The word to find
+   * @param result Receives the tokens of the word
+   * @return false if the word does not start and end on token boundaries
    */
-    [[nodiscard]] std::string SelectTargetWord(const std::string& sentence);
+    [[nodiscard]] static bool
+    FindWordTokens(const Morphology::TokenizedText& tokens, std::string_view word, WordTokens& result);
 
     /**
    * Get the dictionary form of a word.
    * @param surface The surface form
+   * @param word The tokens of the word
    * @return Dictionary form
    */
-    [[nodiscard]] std::string GetDictionaryForm(const std::string& surface);
+    [[nodiscard]] std::string GetDictionaryForm(const std::string& surface, const WordTokens& word);
 
     /**
    * Get the reading of a word.
-   * @param surface The surface form
+   * @param word The tokens of the word
    * @return Katakana reading
    */
-    [[nodiscard]] std::string GetReading(const std::string& surface);
+    [[nodiscard]] static std::string GetReading(const WordTokens& word);
 
     const std::vector<std::unique_ptr<Services::ILanguageService>>* m_LanguageServices;
     std::shared_ptr<Morphology::IMorphologicalAnalyzer> m_MorphAnalyzer;
@@ -125,6 +194,8 @@ private:
     std::shared_ptr<Dictionary::IDictionaryClient> m_DictClient;
     std::shared_ptr<PitchAccent::IPitchAccentLookup> m_PitchAccent;
     std::string m_PreferredTranslatorId;
+    std::shared_ptr<Translation::TranslationCache> m_TranslationCache;
+    std::unique_ptr<Translation::TranslatorHealthMonitor> m_TranslatorHealth;
   };
 
 } // namespace Video2Card::Language::Analyzer
\ No newline at end of file
@@ -13,7 +13,11 @@ namespace Video2Card::Language::Dictionary
       : m_Database(nullptr)
       , m_DatabasePath(dbPath)
   {
-    int result = sqlite3_open(dbPath.c_str(), &m_Database);
+    // Serialized mode, analyses on different threads share the connection
+    int result = sqlite3_open_v2(dbPath.c_str(),
+                                 &m_Database,
+                                 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX,
+                                 nullptr);
 
     if (result != SQLITE_OK) {
       std::string error = sqlite3_errmsg(m_Database);
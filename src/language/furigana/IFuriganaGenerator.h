@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
+#include "language/morphology/TokenizedText.h"
+
 namespace Video2Card::Language::Furigana
 {
 
@@ -28,6 +31,23 @@ public:
    * @return Word with furigana (e.g., "食[た]べる")
    */
     [[nodiscard]] virtual std::string GenerateForWord(const std::string& word) = 0;
+
+    /**
+   * Generate furigana for text that was already tokenized, same result as Generate().
+   * @param tokens The tokens of the text
+   * @return Text with furigana in Anki format
+   */
+    [[nodiscard]] virtual std::string GenerateFromTokens(const Morphology::TokenizedText& tokens) = 0;
+
+    /**
+   * Generate furigana for a word made of a range of already analyzed tokens, same result as GenerateForWord().
+   * @param tokens The tokens the word is part of
+   * @param begin Index of the first token of the word
+   * @param end Index one past the last token of the word
+   * @return Word with furigana
+   */
+    [[nodiscard]] virtual std::string
+    GenerateForWordFromTokens(const Morphology::TokenizedText& tokens, size_t begin, size_t end) = 0;
   };
 
 } // namespace Video2Card::Language::Furigana
\ No newline at end of file
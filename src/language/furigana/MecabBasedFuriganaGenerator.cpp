@@ -319,37 +319,9 @@ namespace Video2Card::Language::Furigana
     }
 
     try {
-      auto tokens = m_Analyzer->Analyze(text);
-      std::string result;
-
-      AF_DEBUG("Furigana generation for text: '{}'", text);
-      AF_DEBUG("MeCab returned {} tokens", tokens.size());
-
-      for (const auto& token : tokens) {
-        AF_DEBUG("Token: surface='{}', reading='{}', hasKanji={}",
-                 token.surface,
-                 token.katakanaReading,
-                 HasKanji(token.surface));
-
-        if (HasKanji(token.surface)) {
-          std::string formatted = FormatFuriganaAdvanced(token.surface, token.katakanaReading);
-          AF_DEBUG("  Formatted as: '{}'", formatted);
-          result += formatted;
-        } else {
-          result += token.surface;
-        }
-      }
-
-      AF_DEBUG("Before trimming: '{}'", result);
-
-      while (!result.empty() && result.front() == ' ') {
-        result.erase(0, 1);
-      }
-      while (!result.empty() && result.back() == ' ') {
-        result.pop_back();
-      }
-      AF_DEBUG("After trimming: '{}'", result);
-      return result;
+      Morphology::TokenizedText tokens;
+      m_Analyzer->Tokenize(text, tokens);
+      return GenerateFromTokens(tokens);
     } catch (const std::exception& e) {
       AF_ERROR("Failed to generate furigana: {}", e.what());
       throw;
@@ -363,36 +335,74 @@ namespace Video2Card::Language::Furigana
     }
 
     try {
-      auto tokens = m_Analyzer->Analyze(word);
-      if (tokens.empty()) {
+      Morphology::TokenizedText tokens;
+      m_Analyzer->Tokenize(word, tokens);
+      if (tokens.Empty()) {
         return word;
       }
 
-      if (tokens.size() == 1) {
-        return FormatFurigana(tokens[0].surface, tokens[0].katakanaReading);
-      }
+      return GenerateForWordFromTokens(tokens, 0, tokens.Size());
+    } catch (const std::exception& e) {
+      AF_WARN("Failed to generate furigana for word '{}': {}", word, e.what());
+      return word;
+    }
+  }
 
-      std::string result;
-      for (const auto& token : tokens) {
-        if (HasKanji(token.surface)) {
-          result += FormatFuriganaAdvanced(token.surface, token.katakanaReading);
-        } else {
-          result += token.surface;
-        }
-      }
+  std::string MecabBasedFuriganaGenerator::GenerateFromTokens(const Morphology::TokenizedText& tokens)
+  {
+    AF_DEBUG("Furigana generation for text: '{}'", tokens.Text());
+    AF_DEBUG("MeCab returned {} tokens", tokens.Size());
 
-      while (!result.empty() && result.front() == ' ') {
-        result.erase(0, 1);
-      }
-      while (!result.empty() && result.back() == ' ') {
-        result.pop_back();
+    std::string result = FormatTokens(tokens, 0, tokens.Size());
+    AF_DEBUG("After trimming: '{}'", result);
+    return result;
+  }
+
+  std::string MecabBasedFuriganaGenerator::GenerateForWordFromTokens(const Morphology::TokenizedText& tokens,
+                                                                     size_t begin,
+                                                                     size_t end)
+  {
+    end = std::min(end, tokens.Size());
+    if (begin >= end) {
+      return "";
+    }
+
+    if (end - begin == 1) {
+      return FormatFurigana(std::string(tokens.Surface(tokens[begin])), std::string(tokens.Reading(tokens[begin])));
+    }
+
+    return FormatTokens(tokens, begin, end);
+  }
+
+  std::string MecabBasedFuriganaGenerator::FormatTokens(const Morphology::TokenizedText& tokens,
+                                                        size_t begin,
+                                                        size_t end)
+  {
+    std::string result;
+    result.reserve(tokens.Text().size() * 2);
+
+    for (size_t i = begin; i < end; ++i) {
+      std::string_view surface = tokens.Surface(tokens[i]);
+      std::string_view reading = tokens.Reading(tokens[i]);
+      AF_DEBUG("Token: surface='{}', reading='{}', hasKanji={}", surface, reading, HasKanji(surface));
+
+      if (HasKanji(surface)) {
+        std::string formatted = FormatFuriganaAdvanced(std::string(surface), std::string(reading));
+        AF_DEBUG("  Formatted as: '{}'", formatted);
+        result += formatted;
+      } else {
+        result += surface;
       }
+    }
 
-      return result;
-    } catch (const std::exception& e) {
-      AF_WARN("Failed to generate furigana for word '{}': {}", word, e.what());
-      return word;
+    while (!result.empty() && result.front() == ' ') {
+      result.erase(0, 1);
     }
+    while (!result.empty() && result.back() == ' ') {
+      result.pop_back();
+    }
+
+    return result;
   }
 
   std::string MecabBasedFuriganaGenerator::FormatFurigana(const std::string& word, const std::string& reading)
@@ -423,7 +433,7 @@ namespace Video2Card::Language::Furigana
     return FormatOutputInternal(word, hiraganaReading);
   }
 
-  bool MecabBasedFuriganaGenerator::HasKanji(const std::string& text)
+  bool MecabBasedFuriganaGenerator::HasKanji(std::string_view text)
   {
     size_t pos = 0;
     while (pos < text.length()) {
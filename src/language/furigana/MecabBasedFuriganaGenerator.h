@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "IFuriganaGenerator.h"
 #include "language/morphology/IMorphologicalAnalyzer.h"
@@ -21,6 +22,11 @@ public:
 
     [[nodiscard]] std::string GenerateForWord(const std::string& word) override;
 
+    [[nodiscard]] std::string GenerateFromTokens(const Morphology::TokenizedText& tokens) override;
+
+    [[nodiscard]] std::string
+    GenerateForWordFromTokens(const Morphology::TokenizedText& tokens, size_t begin, size_t end) override;
+
 private:
 
     std::shared_ptr<Morphology::IMorphologicalAnalyzer> m_Analyzer;
@@ -29,7 +35,9 @@ private:
 
     std::string FormatFuriganaAdvanced(const std::string& word, const std::string& reading);
 
-    static bool HasKanji(const std::string& text);
+    std::string FormatTokens(const Morphology::TokenizedText& tokens, size_t begin, size_t end);
+
+    static bool HasKanji(std::string_view text);
   };
 
 } // namespace Video2Card::Language::Furigana
\ No newline at end of file
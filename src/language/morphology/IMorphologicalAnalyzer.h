@@ -1,8 +1,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "MecabToken.h"
+#include "TokenizedText.h"
 
 namespace Video2Card::Language::Morphology
 {
@@ -26,6 +28,14 @@ public:
    */
     [[nodiscard]] virtual MecabTokenList Analyze(const std::string& text) = 0;
 
+    /**
+   * Tokenize Japanese text into a reusable buffer, without copying every field of every token.
+   * @param text The Japanese text to analyze
+   * @param tokens Receives the tokens, its previous content is replaced
+   * @throws std::runtime_error if analysis fails
+   */
+    virtual void Tokenize(std::string_view text, TokenizedText& tokens) = 0;
+
     /**
    * Get the dictionary form (headword) of a word.
    * @param surface The surface form of the word
@@ -1,20 +1,22 @@
 #include "MecabAnalyzer.h"
 
+#include <algorithm>
+#include <future>
 #include <mecab.h>
-#include <sstream>
 #include <stdexcept>
 
 #include "core/Logger.h"
+#include "core/ThreadPool.h"
 
 namespace Video2Card::Language::Morphology
 {
 
   MecabAnalyzer::MecabAnalyzer(const std::string& dictionaryPath)
-      : m_Mecab(nullptr)
+      : m_Model(nullptr)
       , m_IsInitialized(false)
   {
-    // Create Mecab instance
-    // mecab_new requires argc and argv
+    // Create the Mecab model, it holds the dictionary and is shared by every tagger
+    // mecab_model_new requires argc and argv
     int argc = 1;
     const char* argv[] = {"mecab", "-d", "", nullptr};
 
@@ -23,102 +25,173 @@ namespace Video2Card::Language::Morphology
       argv[2] = dictionaryPath.c_str();
     }
 
-    m_Mecab = mecab_new(argc, const_cast<char**>(argv));
+    m_Model = mecab_model_new(argc, const_cast<char**>(argv));
 
-    if (!m_Mecab) {
+    if (!m_Model) {
       const char* error = mecab_strerror(nullptr);
       AF_ERROR("Failed to initialize Mecab: {}", error ? error : "Unknown error");
       throw std::runtime_error("Failed to initialize Mecab morphological analyzer");
     }
 
     m_IsInitialized = true;
+
+    // Create the first parser right away, so a broken dictionary fails here instead of on the first analysis
+    try {
+      ReleaseParser(AcquireParser());
+    } catch (const std::exception&) {
+      mecab_model_destroy(m_Model);
+      m_Model = nullptr;
+      m_IsInitialized = false;
+      throw;
+    }
+
     AF_INFO("Mecab morphological analyzer initialized successfully");
   }
 
   MecabAnalyzer::~MecabAnalyzer()
   {
-    if (m_Mecab) {
-      mecab_destroy(m_Mecab);
-      m_Mecab = nullptr;
+    for (const Parser& parser : m_IdleParsers) {
+      DestroyParser(parser);
+    }
+    m_IdleParsers.clear();
+
+    if (m_Model) {
+      mecab_model_destroy(m_Model);
+      m_Model = nullptr;
     }
     m_IsInitialized = false;
   }
 
-  MecabAnalyzer::MecabAnalyzer(MecabAnalyzer&& other) noexcept
-      : m_Mecab(other.m_Mecab)
-      , m_IsInitialized(other.m_IsInitialized)
+  MecabAnalyzer::Parser MecabAnalyzer::AcquireParser()
   {
-    other.m_Mecab = nullptr;
-    other.m_IsInitialized = false;
+    {
+      std::lock_guard<std::mutex> lock(m_ParserMutex);
+      if (!m_IdleParsers.empty()) {
+        Parser parser = m_IdleParsers.back();
+        m_IdleParsers.pop_back();
+        return parser;
+      }
+    }
+
+    Parser parser;
+    parser.tagger = mecab_model_new_tagger(m_Model);
+    parser.lattice = mecab_model_new_lattice(m_Model);
+
+    if (!parser.tagger || !parser.lattice) {
+      DestroyParser(parser);
+      AF_ERROR("Failed to create a Mecab tagger");
+      throw std::runtime_error("Failed to create a Mecab tagger");
+    }
+
+    return parser;
   }
 
-  MecabAnalyzer& MecabAnalyzer::operator=(MecabAnalyzer&& other) noexcept
+  void MecabAnalyzer::ReleaseParser(Parser parser)
   {
-    if (this != &other) {
-      if (m_Mecab) {
-        mecab_destroy(m_Mecab);
-      }
-      m_Mecab = other.m_Mecab;
-      m_IsInitialized = other.m_IsInitialized;
+    mecab_lattice_clear(parser.lattice);
+
+    std::lock_guard<std::mutex> lock(m_ParserMutex);
+    m_IdleParsers.push_back(parser);
+  }
 
-      other.m_Mecab = nullptr;
-      other.m_IsInitialized = false;
+  void MecabAnalyzer::DestroyParser(Parser parser)
+  {
+    if (parser.lattice) {
+      mecab_lattice_destroy(parser.lattice);
+    }
+    if (parser.tagger) {
+      mecab_destroy(parser.tagger);
     }
-    return *this;
   }
 
   MecabTokenList MecabAnalyzer::Analyze(const std::string& text)
   {
-    if (!m_IsInitialized || !m_Mecab) {
+    TokenizedText tokens;
+    Tokenize(text, tokens);
+    return tokens.ToMecabTokenList();
+  }
+
+  void MecabAnalyzer::Tokenize(std::string_view text, TokenizedText& tokens)
+  {
+    if (!m_IsInitialized || !m_Model) {
       AF_ERROR("Mecab is not initialized");
       throw std::runtime_error("Mecab analyzer is not initialized");
     }
 
-    MecabTokenList tokens;
+    tokens.Reset(text);
 
     if (text.empty()) {
-      return tokens;
+      return;
     }
 
-    // Use sparse_tostr for simple string output
-    const char* result = mecab_sparse_tostr(m_Mecab, text.c_str());
+    Parser parser = AcquireParser();
+    auto release = [this](Parser* leased) { ReleaseParser(*leased); };
+    std::unique_ptr<Parser, decltype(release)> lease(&parser, release);
+
+    // The surfaces of the nodes point into text, the features into the lattice and are only valid until the
+    // parser goes back to the pool, so the features are copied into the token buffer
+    mecab_lattice_set_sentence2(parser.lattice, text.data(), text.size());
 
-    if (!result) {
-      AF_ERROR("Mecab analysis failed");
+    if (!mecab_parse_lattice(parser.tagger, parser.lattice)) {
+      const char* error = mecab_lattice_strerror(parser.lattice);
+      AF_ERROR("Mecab analysis failed: {}", error ? error : "Unknown error");
       throw std::runtime_error("Mecab morphological analysis failed");
     }
 
-    // Parse the result line by line
-    std::istringstream stream(result);
-    std::string line;
-
-    while (std::getline(stream, line)) {
-      // Skip empty lines and EOS marker
-      if (line.empty() || line == "EOS") {
+    for (const mecab_node_t* node = mecab_lattice_get_bos_node(parser.lattice); node; node = node->next) {
+      if (node->stat == MECAB_BOS_NODE || node->stat == MECAB_EOS_NODE) {
         continue;
       }
 
-      try {
-        tokens.push_back(ParseMecabNode(line));
-      } catch (const std::exception& e) {
-        AF_WARN("Failed to parse Mecab node: {}", e.what());
-        continue;
-      }
+      tokens.AddToken(node->surface - text.data(), node->length, node->feature ? node->feature : "");
     }
+  }
 
-    return tokens;
+  std::vector<TokenizedText> MecabAnalyzer::AnalyzeMany(std::span<const std::string_view> texts,
+                                                        Core::ThreadPool& pool)
+  {
+    std::vector<TokenizedText> results(texts.size());
+    if (texts.empty()) {
+      return results;
+    }
+
+    // One contiguous chunk per worker, so each of them mostly gets the same parser back from the pool
+    size_t chunks = std::min(texts.size(), std::max<size_t>(1, pool.GetThreadCount()));
+    size_t chunkSize = (texts.size() + chunks - 1) / chunks;
+
+    std::vector<std::future<void>> jobs;
+    jobs.reserve(chunks);
+    for (size_t begin = 0; begin < texts.size(); begin += chunkSize) {
+      size_t end = std::min(texts.size(), begin + chunkSize);
+      jobs.push_back(pool.Submit([this, texts, &results, begin, end]() {
+        for (size_t i = begin; i < end; ++i) {
+          Tokenize(texts[i], results[i]);
+        }
+      }));
+    }
+
+    // Every job writes into results, so all of them have to be done before an error is rethrown
+    for (auto& job : jobs) {
+      job.wait();
+    }
+    for (auto& job : jobs) {
+      job.get();
+    }
+
+    return results;
   }
 
   std::string MecabAnalyzer::GetDictionaryForm(const std::string& surface)
   {
-    if (!m_IsInitialized || !m_Mecab) {
+    if (!m_IsInitialized || !m_Model) {
       return "";
     }
 
     try {
-      auto tokens = Analyze(surface);
-      if (!tokens.empty()) {
-        return tokens[0].headword;
+      TokenizedText tokens;
+      Tokenize(surface, tokens);
+      if (!tokens.Empty()) {
+        return std::string(tokens.Headword(tokens[0]));
       }
     } catch (const std::exception& e) {
       AF_WARN("Error getting dictionary form for '{}': {}", surface, e.what());
@@ -129,14 +202,15 @@ namespace Video2Card::Language::Morphology
 
   std::string MecabAnalyzer::GetReading(const std::string& surface)
   {
-    if (!m_IsInitialized || !m_Mecab) {
+    if (!m_IsInitialized || !m_Model) {
       return "";
     }
 
     try {
-      auto tokens = Analyze(surface);
-      if (!tokens.empty()) {
-        return tokens[0].katakanaReading;
+      TokenizedText tokens;
+      Tokenize(surface, tokens);
+      if (!tokens.Empty()) {
+        return std::string(tokens.Reading(tokens[0]));
       }
     } catch (const std::exception& e) {
       AF_WARN("Error getting reading for '{}': {}", surface, e.what());
@@ -147,82 +221,7 @@ namespace Video2Card::Language::Morphology
 
   bool MecabAnalyzer::IsInitialized() const
   {
-    return m_IsInitialized && m_Mecab != nullptr;
-  }
-
-  std::vector<std::string> MecabAnalyzer::SplitFeatures(const std::string& features)
-  {
-    std::vector<std::string> result;
-    std::stringstream ss(features);
-    std::string item;
-
-    while (std::getline(ss, item, ',')) {
-      result.push_back(item);
-    }
-
-    return result;
-  }
-
-  MecabToken MecabAnalyzer::ParseNode(mecab_node_t* node) const
-  {
-    // This method is here for potential future use with the node API
-    // Currently, we use ParseMecabNode with string output instead
-    MecabToken token;
-    return token;
-  }
-
-  MecabToken MecabAnalyzer::ParseMecabNode(const std::string& line)
-  {
-    // Mecab output format: surface\tfeature1,feature2,...
-    // Features are: POS, POS subclass 1-3, inflection type, inflection form, base form, reading
-
-    size_t tabPos = line.find('\t');
-    if (tabPos == std::string::npos) {
-      throw std::runtime_error("Invalid Mecab output format: missing tab");
-    }
-
-    std::string surface = line.substr(0, tabPos);
-    std::string featureStr = line.substr(tabPos + 1);
-
-    auto features = SplitFeatures(featureStr);
-
-    // Standard Mecab output has at least 7-9 fields depending on dictionary
-    if (features.empty()) {
-      throw std::runtime_error("Invalid Mecab output format: no features");
-    }
-
-    MecabToken token;
-    token.surface = surface;
-
-    // Features layout (standard IPA dictionary):
-    // 0: POS (品詞)
-    // 1: POS subclass 1 (品詞細分類1)
-    // 2: POS subclass 2 (品詞細分類2)
-    // 3: POS subclass 3 (品詞細分類3)
-    // 4: Inflection type (活用型)
-    // 5: Inflection form (活用形)
-    // 6: Base form/dictionary form (基本形)
-    // 7: Reading in katakana (読み)
-    // 8: Pronunciation in katakana (発音)
-
-    token.partOfSpeech = features.size() > 0 ? features[0] : "";
-    token.posSubclass1 = features.size() > 1 ? features[1] : "";
-    token.posSubclass2 = features.size() > 2 ? features[2] : "";
-    token.posSubclass3 = features.size() > 3 ? features[3] : "";
-    token.inflectionType = features.size() > 4 ? features[4] : "";
-    token.inflectionForm = features.size() > 5 ? features[5] : "";
-    token.headword = features.size() > 6 ? features[6] : surface;
-    token.katakanaReading = features.size() > 7 ? features[7] : "";
-
-    // If any field is "*", replace with empty string or surface form as appropriate
-    if (token.headword == "*") {
-      token.headword = surface;
-    }
-    if (token.katakanaReading == "*") {
-      token.katakanaReading = "";
-    }
-
-    return token;
+    return m_IsInitialized && m_Model != nullptr;
   }
 
 } // namespace Video2Card::Language::Morphology
\ No newline at end of file
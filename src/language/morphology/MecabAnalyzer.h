@@ -1,14 +1,23 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "IMorphologicalAnalyzer.h"
 
 // Forward declare Mecab types to avoid including mecab.h in headers
 struct mecab_t;
-struct mecab_node_t;
+struct mecab_model_t;
+struct mecab_lattice_t;
+
+namespace Video2Card::Core
+{
+  class ThreadPool;
+}
 
 namespace Video2Card::Language::Morphology
 {
@@ -17,6 +26,8 @@ namespace Video2Card::Language::Morphology
  * Mecab-based morphological analyzer for Japanese text.
  * Uses the Mecab morphological analyzer to parse Japanese text
  * into tokens with dictionary forms, readings, and POS information.
+ * Thread-safe: the dictionary is loaded once into a shared model and every call parses with its own tagger and
+ * lattice, taken from a pool that grows to the number of threads analyzing at the same time.
  */
   class MecabAnalyzer final : public IMorphologicalAnalyzer
   {
@@ -35,9 +46,9 @@ public:
     MecabAnalyzer(const MecabAnalyzer&) = delete;
     MecabAnalyzer& operator=(const MecabAnalyzer&) = delete;
 
-    // Allow move operations
-    MecabAnalyzer(MecabAnalyzer&& other) noexcept;
-    MecabAnalyzer& operator=(MecabAnalyzer&& other) noexcept;
+    // Taggers handed out to other threads refer to the model, so it cannot move either
+    MecabAnalyzer(MecabAnalyzer&&) = delete;
+    MecabAnalyzer& operator=(MecabAnalyzer&&) = delete;
 
     /**
    * Analyze Japanese text and return morphological tokens.
@@ -47,6 +58,25 @@ public:
    */
     [[nodiscard]] MecabTokenList Analyze(const std::string& text) override;
 
+    /**
+   * Tokenize Japanese text by walking the Mecab nodes directly.
+   * @param text The Japanese text to analyze
+   * @param tokens Receives the tokens, reuse it across calls to avoid allocations
+   * @throws std::runtime_error if analysis fails
+   */
+    void Tokenize(std::string_view text, TokenizedText& tokens) override;
+
+    /**
+   * Tokenize many lines at once, spread across the workers of a pool.
+   * Must not be called from a job of the same pool, it waits for the jobs it queues.
+   * @param texts The lines to analyze, must stay valid until the call returns
+   * @param pool Runs the tokenization
+   * @return The tokens of each line, in the same order
+   * @throws std::runtime_error if the analysis of any line fails
+   */
+    [[nodiscard]] std::vector<TokenizedText> AnalyzeMany(std::span<const std::string_view> texts,
+                                                         Core::ThreadPool& pool);
+
     /**
    * Get the dictionary form of a word.
    * @param surface The surface form
@@ -69,29 +99,22 @@ public:
 
 private:
 
-    /**
-   * Parse a Mecab node and convert to MecabToken.
-   * @param node The Mecab node to parse
-   * @return MecabToken with extracted information
-   */
-    MecabToken ParseNode(mecab_node_t* node) const;
+    // A tagger and the lattice it parses into, used by one thread at a time
+    struct Parser
+    {
+      mecab_t* tagger = nullptr;
+      mecab_lattice_t* lattice = nullptr;
+    };
 
-    /**
-   * Parse a Mecab output line and convert to MecabToken.
-   * @param line A line from Mecab output (surface\tfeatures)
-   * @return MecabToken with extracted information
-   */
-    static MecabToken ParseMecabNode(const std::string& line);
+    Parser AcquireParser();
+    void ReleaseParser(Parser parser);
+    static void DestroyParser(Parser parser);
 
-    /**
-   * Split CSV-formatted Mecab output (feature column).
-   * @param features The CSV string from Mecab
-   * @return Vector of parsed features
-   */
-    static std::vector<std::string> SplitFeatures(const std::string& features);
-
-    mecab_t* m_Mecab;
+    mecab_model_t* m_Model;
     bool m_IsInitialized;
+
+    std::mutex m_ParserMutex;
+    std::vector<Parser> m_IdleParsers;
   };
 
 } // namespace Video2Card::Language::Morphology
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "TokenizedText.h"
+
+#include <array>
+#include <utility>
+
+namespace Video2Card::Language::Morphology
+{
+
+  namespace
+  {
+    // Feature layout of IPADIC:
+    // 0: POS, 1-3: POS subclasses, 4: inflection type, 5: inflection form, 6: base form, 7: reading, 8: pronunciation
+    constexpr size_t HEADWORD_COLUMN = 6;
+    constexpr size_t READING_COLUMN = 7;
+
+    constexpr std::array<std::pair<std::string_view, PartOfSpeech>, 19> PARTS_OF_SPEECH = {{
+        {"名詞", PartOfSpeech::Noun},
+        {"動詞", PartOfSpeech::Verb},
+        {"助詞", PartOfSpeech::Particle},
+        {"助動詞", PartOfSpeech::AuxiliaryVerb},
+        {"記号", PartOfSpeech::Symbol},
+        {"補助記号", PartOfSpeech::Symbol},
+        {"形容詞", PartOfSpeech::Adjective},
+        {"副詞", PartOfSpeech::Adverb},
+        {"代名詞", PartOfSpeech::Pronoun},
+        {"形状詞", PartOfSpeech::AdjectivalNoun},
+        {"連体詞", PartOfSpeech::Adnominal},
+        {"接続詞", PartOfSpeech::Conjunction},
+        {"感動詞", PartOfSpeech::Interjection},
+        {"接頭詞", PartOfSpeech::Prefix},
+        {"接頭辞", PartOfSpeech::Prefix},
+        {"接尾辞", PartOfSpeech::Suffix},
+        {"空白", PartOfSpeech::Whitespace},
+        {"フィラー", PartOfSpeech::Filler},
+        {"その他", PartOfSpeech::Other},
+    }};
+
+    /**
+     * Find one column of a CSV feature string, relative to its start
+     */
+    TextSpan FindColumn(std::string_view feature, size_t column)
+    {
+      size_t start = 0;
+      for (size_t i = 0; i < column; ++i) {
+        size_t comma = feature.find(',', start);
+        if (comma == std::string_view::npos)
+          return {(uint32_t) feature.size(), 0};
+        start = comma + 1;
+      }
+
+      size_t end = feature.find(',', start);
+      if (end == std::string_view::npos)
+        end = feature.size();
+      return {(uint32_t) start, (uint32_t) (end - start)};
+    }
+  } // namespace
+
+  PartOfSpeech ParsePartOfSpeech(std::string_view name)
+  {
+    for (const auto& [text, partOfSpeech] : PARTS_OF_SPEECH) {
+      if (name == text)
+        return partOfSpeech;
+    }
+    return PartOfSpeech::Other;
+  }
+
+  bool IsContentWord(PartOfSpeech partOfSpeech)
+  {
+    return partOfSpeech == PartOfSpeech::Noun || partOfSpeech == PartOfSpeech::Verb ||
+           partOfSpeech == PartOfSpeech::Adjective;
+  }
+
+  void TokenizedText::Reset(std::string_view text)
+  {
+    m_Buffer.assign(text);
+    m_TextLength = text.size();
+    m_Tokens.clear();
+  }
+
+  TextSpan TokenizedText::Append(std::string_view text)
+  {
+    TextSpan span{(uint32_t) m_Buffer.size(), (uint32_t) text.size()};
+    m_Buffer.append(text);
+    return span;
+  }
+
+  void TokenizedText::AddToken(size_t surfaceOffset, size_t surfaceLength, std::string_view feature)
+  {
+    Token token;
+    token.surface = {(uint32_t) surfaceOffset, (uint32_t) surfaceLength};
+    token.feature = Append(feature);
+
+    auto resolve = [&](TextSpan column) {
+      return TextSpan{token.feature.offset + column.offset, column.length};
+    };
+
+    token.partOfSpeech = ParsePartOfSpeech(feature.substr(0, FindColumn(feature, 0).length));
+
+    TextSpan headword = FindColumn(feature, HEADWORD_COLUMN);
+    std::string_view headwordText = feature.substr(headword.offset, headword.length);
+    token.headword = headwordText.empty() || headwordText == "*" ? token.surface : resolve(headword);
+
+    TextSpan reading = FindColumn(feature, READING_COLUMN);
+    std::string_view readingText = feature.substr(reading.offset, reading.length);
+    token.reading = readingText == "*" ? TextSpan{} : resolve(reading);
+
+    m_Tokens.push_back(token);
+  }
+
+  std::string_view TokenizedText::Feature(const Token& token, size_t column) const
+  {
+    std::string_view feature = View(token.feature);
+    TextSpan span = FindColumn(feature, column);
+    return feature.substr(span.offset, span.length);
+  }
+
+  MecabToken TokenizedText::ToMecabToken(const Token& token) const
+  {
+    MecabToken result(std::string(Surface(token)),
+                      std::string(Headword(token)),
+                      std::string(Reading(token)),
+                      std::string(Feature(token, 0)));
+    result.posSubclass1 = Feature(token, 1);
+    result.posSubclass2 = Feature(token, 2);
+    result.posSubclass3 = Feature(token, 3);
+    result.inflectionType = Feature(token, 4);
+    result.inflectionForm = Feature(token, 5);
+    return result;
+  }
+
+  MecabTokenList TokenizedText::ToMecabTokenList() const
+  {
+    MecabTokenList tokens;
+    tokens.reserve(m_Tokens.size());
+    for (const auto& token : m_Tokens) {
+      tokens.push_back(ToMecabToken(token));
+    }
+    return tokens;
+  }
+
+} // namespace Video2Card::Language::Morphology
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MecabToken.h"
+
+namespace Video2Card::Language::Morphology
+{
+
+  /**
+ * Part of speech of a token, the first feature column interned to an enum.
+ * Covers the top level categories of IPADIC and UniDic.
+ */
+  enum class PartOfSpeech : uint8_t
+  {
+    Other,
+    Noun,           // 名詞
+    Pronoun,        // 代名詞 (UniDic)
+    Verb,           // 動詞
+    Adjective,      // 形容詞
+    AdjectivalNoun, // 形状詞 (UniDic)
+    Adverb,         // 副詞
+    Adnominal,      // 連体詞
+    Conjunction,    // 接続詞
+    Interjection,   // 感動詞
+    Particle,       // 助詞
+    AuxiliaryVerb,  // 助動詞
+    Prefix,         // 接頭詞, 接頭辞 (UniDic)
+    Suffix,         // 接尾辞 (UniDic)
+    Symbol,         // 記号, 補助記号 (UniDic)
+    Whitespace,     // 空白 (UniDic)
+    Filler          // フィラー
+  };
+
+  /**
+   * Intern the name of a part of speech as the dictionary writes it.
+   * @param name First feature column, e.g. "名詞"
+   * @return The matching PartOfSpeech, Other if unknown
+   */
+  [[nodiscard]] PartOfSpeech ParsePartOfSpeech(std::string_view name);
+
+  /**
+   * Check if a part of speech is a word worth mining on its own (noun, verb or adjective).
+   */
+  [[nodiscard]] bool IsContentWord(PartOfSpeech partOfSpeech);
+
+  /**
+   * Byte range inside the buffer of a TokenizedText
+   */
+  struct TextSpan
+  {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+  };
+
+  /**
+   * A token of a TokenizedText, its strings are spans into the shared buffer
+   */
+  struct Token
+  {
+    TextSpan surface;  // Inside the analyzed text
+    TextSpan feature;  // The whole CSV feature string
+    TextSpan headword; // Dictionary form, the surface if the dictionary has none
+    TextSpan reading;  // Katakana reading, empty if unknown
+    PartOfSpeech partOfSpeech = PartOfSpeech::Other;
+  };
+
+  /**
+ * Result of tokenizing a text, without a string allocation per token.
+ * The analyzed text and the feature strings of all tokens are copied into a single buffer and the tokens
+ * only hold offsets into it. Reusing the same instance for many texts keeps the capacity of the buffers, so
+ * tokenizing a whole episode allocates almost nothing.
+ */
+  class TokenizedText
+  {
+public:
+
+    using const_iterator = std::vector<Token>::const_iterator;
+
+    /**
+     * Start over with a new text, keeping the allocated capacity.
+     * @param text The text that is about to be tokenized
+     */
+    void Reset(std::string_view text);
+
+    /**
+     * Append a token, called by the analyzer for each node in order.
+     * @param surfaceOffset Byte offset of the surface in the text given to Reset()
+     * @param surfaceLength Byte length of the surface
+     * @param feature CSV feature string of the dictionary, copied
+     */
+    void AddToken(size_t surfaceOffset, size_t surfaceLength, std::string_view feature);
+
+    [[nodiscard]] std::string_view Text() const { return std::string_view(m_Buffer).substr(0, m_TextLength); }
+
+    [[nodiscard]] size_t Size() const { return m_Tokens.size(); }
+    [[nodiscard]] bool Empty() const { return m_Tokens.empty(); }
+
+    [[nodiscard]] const Token& operator[](size_t index) const { return m_Tokens[index]; }
+    [[nodiscard]] const_iterator begin() const { return m_Tokens.begin(); }
+    [[nodiscard]] const_iterator end() const { return m_Tokens.end(); }
+
+    /**
+     * Resolve a span of this buffer. Views are invalidated by the next Reset() or AddToken().
+     */
+    [[nodiscard]] std::string_view View(TextSpan span) const
+    {
+      return std::string_view(m_Buffer).substr(span.offset, span.length);
+    }
+
+    [[nodiscard]] std::string_view Surface(const Token& token) const { return View(token.surface); }
+    [[nodiscard]] std::string_view Headword(const Token& token) const { return View(token.headword); }
+    [[nodiscard]] std::string_view Reading(const Token& token) const { return View(token.reading); }
+
+    /**
+     * Get one column of the feature string of a token.
+     * @param token The token
+     * @param column Zero based column, 0 is the part of speech
+     * @return The column, empty if the feature string is shorter
+     */
+    [[nodiscard]] std::string_view Feature(const Token& token, size_t column) const;
+
+    /**
+     * Copy a token into the string based MecabToken.
+     */
+    [[nodiscard]] MecabToken ToMecabToken(const Token& token) const;
+
+    /**
+     * Copy all tokens into a MecabTokenList.
+     */
+    [[nodiscard]] MecabTokenList ToMecabTokenList() const;
+
+private:
+
+    TextSpan Append(std::string_view text);
+
+    std::string m_Buffer; // Analyzed text followed by the feature strings
+    size_t m_TextLength = 0;
+    std::vector<Token> m_Tokens;
+  };
+
+} // namespace Video2Card::Language::Morphology
@@ -11,8 +11,21 @@ namespace Video2Card::Language::Services
 {
 
   /**
- * DeepL translation service wrapper with UI configuration support.
- * Wraps the DeepLTranslator and provides UI configuration interface.
+   * User settings of the DeepL service
+   */
+  struct DeepLSettings
+  {
+    std::string apiKey;
+    bool useFreeAPI = true;
+    std::string sourceLang = "JA";
+    std::string targetLang = "EN-US";
+    std::string formality = "default";
+    int timeoutSeconds = 10;
+  };
+
+  /**
+ * DeepL translation service wrapper.
+ * Wraps the DeepLTranslator and keeps the settings it is created from.
  */
   class DeepLService : public ILanguageService
   {
@@ -27,7 +40,6 @@ public:
     [[nodiscard]] std::string GetType() const override;
     [[nodiscard]] bool IsAvailable() const override;
 
-    bool RenderConfigurationUI() override;
     void LoadConfig(const nlohmann::json& config) override;
     [[nodiscard]] nlohmann::json SaveConfig() const override;
 
@@ -44,17 +56,16 @@ public:
    */
     bool InitializeTranslator();
 
+    /**
+   * Settings for the configuration UI to edit in place.
+   * Changes are picked up the next time InitializeTranslator() runs.
+   */
+    DeepLSettings& GetSettings() { return m_Settings; }
+
 private:
 
     std::shared_ptr<Translation::DeepLTranslator> m_Translator;
-
-    // Configuration
-    std::string m_ApiKey;
-    bool m_UseFreeAPI;
-    std::string m_SourceLang;
-    std::string m_TargetLang;
-    std::string m_Formality;
-    int m_TimeoutSeconds;
+    DeepLSettings m_Settings;
   };
 
 } // namespace Video2Card::Language::Services
\ No newline at end of file
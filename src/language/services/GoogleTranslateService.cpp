@@ -30,14 +30,7 @@ namespace Video2Card::Language::Services
 
   bool GoogleTranslateService::IsAvailable() const
   {
-    bool available = m_Translator && m_Translator->IsAvailable();
-    AF_DEBUG("GoogleTranslateService::IsAvailable() = {}", available);
-    return available;
-  }
-
-  bool GoogleTranslateService::RenderConfigurationUI()
-  {
-    return false;
+    return m_Translator && m_Translator->IsAvailable();
   }
 
   void GoogleTranslateService::LoadConfig(const nlohmann::json& config)
@@ -21,8 +21,6 @@ public:
     [[nodiscard]] std::string GetType() const override;
     [[nodiscard]] bool IsAvailable() const override;
 
-    bool RenderConfigurationUI() override;
-
     void LoadConfig(const nlohmann::json& config) override;
     [[nodiscard]] nlohmann::json SaveConfig() const override;
 
@@ -7,8 +7,9 @@ namespace Video2Card::Language::Services
 {
 
   /**
- * Base interface for language services that can be configured via UI.
+ * Base interface for configurable language services.
  * This includes dictionaries, translators, and other language tools.
+ * Their settings UI lives with the GUI (see UI::ConfigurationSection) so the services build without it.
  */
   class ILanguageService
   {
@@ -40,12 +41,6 @@ public:
    */
     [[nodiscard]] virtual bool IsAvailable() const = 0;
 
-    /**
-   * Render ImGui configuration UI for this service.
-   * @return true if configuration was changed and should be saved
-   */
-    virtual bool RenderConfigurationUI() = 0;
-
     /**
    * Load configuration from JSON.
    * @param config The configuration JSON object
@@ -0,0 +1,98 @@
+#include "CachingTranslator.h"
+
+#include <unordered_map>
+#include <utility>
+
+#include "TranslationCache.h"
+
+namespace Video2Card::Language::Translation
+{
+
+  CachingTranslator::CachingTranslator(std::shared_ptr<ITranslator> translator,
+                                       std::shared_ptr<TranslationCache> cache)
+      : m_Translator(std::move(translator))
+      , m_Cache(std::move(cache))
+  {}
+
+  std::string CachingTranslator::Translate(const std::string& text)
+  {
+    std::string scope = m_Translator->GetCacheScope();
+    if (!m_Cache || scope.empty() || text.empty()) {
+      return m_Translator->Translate(text);
+    }
+
+    if (auto cached = m_Cache->Find(scope, text)) {
+      return *cached;
+    }
+
+    std::string translation = m_Translator->Translate(text);
+
+    // The translators hand back the input or nothing when the request failed, that is not worth keeping
+    if (!translation.empty() && translation != text) {
+      m_Cache->Store(scope, text, translation);
+    }
+
+    return translation;
+  }
+
+  std::vector<std::string> CachingTranslator::TranslateBatch(std::span<const std::string_view> texts)
+  {
+    std::string scope = m_Translator->GetCacheScope();
+    if (!m_Cache || scope.empty()) {
+      return m_Translator->TranslateBatch(texts);
+    }
+
+    std::vector<std::string> translations(texts.size());
+
+    // Lines repeat within an episode too, a text missing from the cache is sent once for all its lines
+    std::vector<std::string_view> misses;
+    std::unordered_map<std::string_view, std::vector<size_t>> missingLines;
+    for (size_t i = 0; i < texts.size(); ++i) {
+      if (texts[i].empty()) {
+        continue;
+      }
+
+      auto pending = missingLines.find(texts[i]);
+      if (pending != missingLines.end()) {
+        pending->second.push_back(i);
+      } else if (auto cached = m_Cache->Find(scope, texts[i])) {
+        translations[i] = std::move(*cached);
+      } else {
+        misses.push_back(texts[i]);
+        missingLines[texts[i]].push_back(i);
+      }
+    }
+
+    if (misses.empty()) {
+      return translations;
+    }
+
+    std::vector<std::string> received = m_Translator->TranslateBatch(misses);
+    for (size_t i = 0; i < misses.size() && i < received.size(); ++i) {
+      if (!received[i].empty() && received[i] != misses[i]) {
+        m_Cache->Store(scope, misses[i], received[i]);
+      }
+      for (size_t line : missingLines[misses[i]]) {
+        translations[line] = received[i];
+      }
+    }
+
+    return translations;
+  }
+
+  bool CachingTranslator::IsAvailable() const
+  {
+    return m_Translator->IsAvailable();
+  }
+
+  bool CachingTranslator::Probe() const
+  {
+    return m_Translator->Probe();
+  }
+
+  std::string CachingTranslator::GetCacheScope() const
+  {
+    return m_Translator->GetCacheScope();
+  }
+
+} // namespace Video2Card::Language::Translation
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ITranslator.h"
+
+namespace Video2Card::Language::Translation
+{
+
+  class TranslationCache;
+
+  /**
+ * Translator that answers from a TranslationCache and only asks the wrapped translator on a miss.
+ * Translators with an empty cache scope are passed through.
+ */
+  class CachingTranslator final : public ITranslator
+  {
+public:
+
+    CachingTranslator(std::shared_ptr<ITranslator> translator, std::shared_ptr<TranslationCache> cache);
+
+    [[nodiscard]] std::string Translate(const std::string& text) override;
+
+    /**
+   * Translate many lines, only the ones missing from the cache reach the wrapped translator, each of them once.
+   */
+    [[nodiscard]] std::vector<std::string> TranslateBatch(std::span<const std::string_view> texts) override;
+
+    [[nodiscard]] bool IsAvailable() const override;
+
+    [[nodiscard]] bool Probe() const override;
+
+    [[nodiscard]] std::string GetCacheScope() const override;
+
+private:
+
+    std::shared_ptr<ITranslator> m_Translator;
+    std::shared_ptr<TranslationCache> m_Cache;
+  };
+
+} // namespace Video2Card::Language::Translation
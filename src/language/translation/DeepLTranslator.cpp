@@ -1,6 +1,7 @@
 #include "DeepLTranslator.h"
 
 #include <exception>
+#include <format>
 #include <httplib.h>
 #include <iomanip>
 #include <nlohmann/json.hpp>
@@ -12,6 +13,13 @@
 namespace Video2Card::Language::Translation
 {
 
+  namespace
+  {
+    // Limits of a /v2/translate request
+    constexpr size_t MAX_TEXTS_PER_REQUEST = 50;
+    constexpr size_t MAX_REQUEST_BYTES = 128 * 1024;
+  } // namespace
+
   DeepLTranslator::DeepLTranslator(std::string apiKey, bool useFreeAPI, int timeoutSeconds) noexcept
       : m_ApiKey(std::move(apiKey))
       , m_UseFreeAPI(useFreeAPI)
@@ -49,20 +57,14 @@ namespace Video2Card::Language::Translation
       cli.set_write_timeout(m_TimeoutSeconds, 0);
 
       // Build request body
-      std::stringstream body;
-      body << "auth_key=" << UrlEncode(m_ApiKey) << "&text=" << UrlEncode(text)
-           << "&source_lang=" << UrlEncode(m_SourceLang) << "&target_lang=" << UrlEncode(m_TargetLang);
-
-      if (m_Formality != "default") {
-        body << "&formality=" << UrlEncode(m_Formality);
-      }
+      std::string body = BuildRequestParameters() + "&text=" + UrlEncode(text);
 
       // Set headers
       httplib::Headers headers = {{"Content-Type", "application/x-www-form-urlencoded"}};
 
       AF_DEBUG("Sending translation request to DeepL for text: {}", text.substr(0, 50));
 
-      auto res = cli.Post("/v2/translate", headers, body.str(), "application/x-www-form-urlencoded");
+      auto res = cli.Post("/v2/translate", headers, body, "application/x-www-form-urlencoded");
 
       if (!res) {
         AF_WARN("DeepL API request failed: no response - returning original text");
@@ -85,7 +87,91 @@ namespace Video2Card::Language::Translation
     }
   }
 
+  std::vector<std::string> DeepLTranslator::TranslateBatch(std::span<const std::string_view> texts)
+  {
+    // Same results as Translate(): nothing for empty lines, the original text when a request fails
+    std::vector<std::string> translations(texts.begin(), texts.end());
+
+    if (m_ApiKey.empty()) {
+      AF_DEBUG("DeepL API not configured - returning original text");
+      return translations;
+    }
+
+    std::string host = m_UseFreeAPI ? "api-free.deepl.com" : "api.deepl.com";
+    httplib::SSLClient cli(host);
+    cli.set_connection_timeout(m_TimeoutSeconds, 0);
+    cli.set_read_timeout(m_TimeoutSeconds, 0);
+    cli.set_write_timeout(m_TimeoutSeconds, 0);
+    cli.set_keep_alive(true);
+
+    httplib::Headers headers = {{"Content-Type", "application/x-www-form-urlencoded"}};
+    std::string parameters = BuildRequestParameters();
+
+    size_t next = 0;
+    size_t requests = 0;
+    while (next < texts.size()) {
+      // Fill a request up to the limits, a text too large for them on its own still goes out alone
+      std::string body = parameters;
+      std::vector<size_t> indices;
+      while (next < texts.size() && indices.size() < MAX_TEXTS_PER_REQUEST) {
+        if (texts[next].empty()) {
+          ++next;
+          continue;
+        }
+
+        std::string parameter = "&text=" + UrlEncode(std::string(texts[next]));
+        if (!indices.empty() && body.size() + parameter.size() > MAX_REQUEST_BYTES) {
+          break;
+        }
+
+        body += parameter;
+        indices.push_back(next++);
+      }
+
+      if (indices.empty()) {
+        continue;
+      }
+
+      ++requests;
+      try {
+        auto res = cli.Post("/v2/translate", headers, body, "application/x-www-form-urlencoded");
+
+        if (!res) {
+          AF_WARN("DeepL API request for {} lines failed: no response - returning original text", indices.size());
+          continue;
+        }
+
+        if (res->status != 200) {
+          AF_WARN("DeepL API returned status {} for {} lines - returning original text", res->status, indices.size());
+          continue;
+        }
+
+        std::vector<std::string> received = ParseTranslationResponses(res->body);
+        if (received.size() != indices.size()) {
+          AF_WARN("DeepL returned {} translations for {} lines - returning original text",
+                  received.size(),
+                  indices.size());
+          continue;
+        }
+
+        for (size_t i = 0; i < indices.size(); ++i) {
+          translations[indices[i]] = std::move(received[i]);
+        }
+      } catch (const std::exception& e) {
+        AF_WARN("DeepL translation of {} lines failed: {} - returning original text", indices.size(), e.what());
+      }
+    }
+
+    AF_DEBUG("Translated {} lines with {} DeepL requests", texts.size(), requests);
+    return translations;
+  }
+
   bool DeepLTranslator::IsAvailable() const
+  {
+    return IsConfigured();
+  }
+
+  bool DeepLTranslator::Probe() const
   {
     // Not available if API key is not configured
     if (m_ApiKey.empty()) {
@@ -108,6 +194,14 @@ namespace Video2Card::Language::Translation
     }
   }
 
+  std::string DeepLTranslator::GetCacheScope() const
+  {
+    if (m_ApiKey.empty()) {
+      return "";
+    }
+    return std::format("deepl:{}:{}:{}", m_SourceLang, m_TargetLang, m_Formality);
+  }
+
   bool DeepLTranslator::IsConfigured() const noexcept
   {
     return !m_ApiKey.empty();
@@ -155,7 +249,30 @@ namespace Video2Card::Language::Translation
     return url.str();
   }
 
+  std::string DeepLTranslator::BuildRequestParameters() const
+  {
+    std::stringstream parameters;
+    parameters << "auth_key=" << UrlEncode(m_ApiKey) << "&source_lang=" << UrlEncode(m_SourceLang)
+               << "&target_lang=" << UrlEncode(m_TargetLang);
+
+    if (m_Formality != "default") {
+      parameters << "&formality=" << UrlEncode(m_Formality);
+    }
+
+    return parameters.str();
+  }
+
   std::string DeepLTranslator::ParseTranslationResponse(const std::string& json)
+  {
+    std::vector<std::string> translations = ParseTranslationResponses(json);
+    if (translations.empty()) {
+      throw std::runtime_error("DeepL returned empty translations array");
+    }
+
+    return std::move(translations[0]);
+  }
+
+  std::vector<std::string> DeepLTranslator::ParseTranslationResponses(const std::string& json)
   {
     try {
       auto parsed = nlohmann::json::parse(json);
@@ -164,17 +281,16 @@ namespace Video2Card::Language::Translation
         throw std::runtime_error("Invalid DeepL response format: missing translations array");
       }
 
-      auto& translations = parsed["translations"];
-      if (translations.empty()) {
-        throw std::runtime_error("DeepL returned empty translations array");
-      }
-
-      auto& firstTranslation = translations[0];
-      if (!firstTranslation.contains("text")) {
-        throw std::runtime_error("DeepL translation missing 'text' field");
+      std::vector<std::string> translations;
+      translations.reserve(parsed["translations"].size());
+      for (const auto& translation : parsed["translations"]) {
+        if (!translation.contains("text")) {
+          throw std::runtime_error("DeepL translation missing 'text' field");
+        }
+        translations.push_back(translation["text"].get<std::string>());
       }
 
-      return firstTranslation["text"].get<std::string>();
+      return translations;
 
     } catch (const nlohmann::json::exception& e) {
       throw std::runtime_error(std::string("Failed to parse DeepL response: ") + e.what());
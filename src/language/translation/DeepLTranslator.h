@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "ITranslator.h"
 
@@ -42,14 +43,34 @@ public:
    */
     [[nodiscard]] std::string Translate(const std::string& text) override;
 
+    /**
+   * Translate many lines with as few requests as DeepL's limits allow.
+   * Each request carries up to 50 texts and 128 KiB, over a single connection.
+   * @param texts The Japanese texts to translate
+   * @return One translation per text, the original text for the lines of a request that failed
+   */
+    [[nodiscard]] std::vector<std::string> TranslateBatch(std::span<const std::string_view> texts) override;
+
     /**
    * Check if DeepL API is available.
-   * Tests connectivity to the API endpoint.
    * Returns false if API key is not configured.
-   * @return true if the API is accessible and configured
+   * @return true if the API is configured
    */
     [[nodiscard]] bool IsAvailable() const override;
 
+    /**
+   * Check that the DeepL API accepts the key.
+   * Tests connectivity to the usage endpoint.
+   * @return true if the API is accessible and configured
+   */
+    [[nodiscard]] bool Probe() const override;
+
+    /**
+   * Languages and formality the translations depend on.
+   * @return The cache scope, empty if the API key is not configured
+   */
+    [[nodiscard]] std::string GetCacheScope() const override;
+
     /**
    * Check if the translator is configured (has an API key).
    * @return true if API key is set
@@ -89,6 +110,12 @@ private:
    */
     [[nodiscard]] std::string BuildRequestUrl(const std::string& text) const;
 
+    /**
+   * Build the parameters every translation request carries, without any text.
+   * @return URL-encoded form parameters
+   */
+    [[nodiscard]] std::string BuildRequestParameters() const;
+
     /**
    * Parse the JSON response from DeepL API.
    * @param json The JSON response string
@@ -97,6 +124,14 @@ private:
    */
     [[nodiscard]] static std::string ParseTranslationResponse(const std::string& json);
 
+    /**
+   * Parse the JSON response of a request with several texts.
+   * @param json The JSON response string
+   * @return The translated texts, in the order of the request
+   * @throws std::runtime_error if parsing fails
+   */
+    [[nodiscard]] static std::vector<std::string> ParseTranslationResponses(const std::string& json);
+
     /**
    * URL-encode a string for use in HTTP requests.
    * @param value The string to encode
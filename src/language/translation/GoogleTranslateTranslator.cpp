@@ -1,6 +1,10 @@
 #include "GoogleTranslateTranslator.h"
 
+#include <algorithm>
+#include <atomic>
 #include <exception>
+#include <format>
+#include <future>
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 #include <sstream>
@@ -11,6 +15,12 @@
 namespace Video2Card::Language::Translation
 {
 
+  namespace
+  {
+    // Requests in flight at once during a batch, enough to hide the round trips without getting throttled
+    constexpr size_t MAX_CONCURRENT_REQUESTS = 4;
+  } // namespace
+
   GoogleTranslateTranslator::GoogleTranslateTranslator(std::string sourceLang,
                                                        std::string targetLang,
                                                        int timeoutSeconds)
@@ -108,10 +118,43 @@ namespace Video2Card::Language::Translation
     }
   }
 
-  bool GoogleTranslateTranslator::IsAvailable() const
+  std::vector<std::string> GoogleTranslateTranslator::TranslateBatch(std::span<const std::string_view> texts)
+  {
+    std::vector<std::string> translations(texts.size());
+    std::atomic<size_t> next{0};
+
+    auto worker = [&]() {
+      for (size_t index = next++; index < texts.size(); index = next++) {
+        if (!texts[index].empty()) {
+          translations[index] = Translate(std::string(texts[index]));
+        }
+      }
+    };
+
+    size_t workers = std::min(texts.size(), MAX_CONCURRENT_REQUESTS);
+    std::vector<std::future<void>> requests;
+    for (size_t i = 1; i < workers; ++i) {
+      requests.push_back(std::async(std::launch::async, worker));
+    }
+    if (workers > 0) {
+      worker();
+    }
+    for (auto& request : requests) {
+      request.get();
+    }
+
+    return translations;
+  }
+
+  std::string GoogleTranslateTranslator::GetCacheScope() const
+  {
+    return std::format("google_translate:{}:{}", m_SourceLang, m_TargetLang);
+  }
+
+  bool GoogleTranslateTranslator::Probe() const
   {
     try {
-      AF_DEBUG("GoogleTranslateTranslator::IsAvailable - Checking connectivity to translate.google.com");
+      AF_DEBUG("GoogleTranslateTranslator::Probe - Checking connectivity to translate.google.com");
       httplib::Client cli("https://translate.google.com");
       cli.set_connection_timeout(3, 0);
       cli.set_read_timeout(3, 0);
@@ -127,10 +170,10 @@ namespace Video2Card::Language::Translation
 
       return available;
     } catch (const std::exception& e) {
-      AF_ERROR("GoogleTranslateTranslator::IsAvailable - Exception: {}", e.what());
+      AF_ERROR("GoogleTranslateTranslator::Probe - Exception: {}", e.what());
       return false;
     } catch (...) {
-      AF_ERROR("GoogleTranslateTranslator::IsAvailable - Unknown exception");
+      AF_ERROR("GoogleTranslateTranslator::Probe - Unknown exception");
       return false;
     }
   }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "language/translation/ITranslator.h"
 
@@ -18,7 +19,14 @@ public:
 
     [[nodiscard]] std::string Translate(const std::string& text) override;
 
-    [[nodiscard]] bool IsAvailable() const override;
+    // One text per request, so a batch runs a few requests at a time instead
+    [[nodiscard]] std::vector<std::string> TranslateBatch(std::span<const std::string_view> texts) override;
+
+    [[nodiscard]] bool IsAvailable() const override { return true; }
+
+    [[nodiscard]] bool Probe() const override;
+
+    [[nodiscard]] std::string GetCacheScope() const override;
 
     void SetSourceLang(const std::string& lang) { m_SourceLang = lang; }
     void SetTargetLang(const std::string& lang) { m_TargetLang = lang; }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace Video2Card::Language::Translation
 {
@@ -21,11 +24,42 @@ public:
    */
     [[nodiscard]] virtual std::string Translate(const std::string& text) = 0;
 
+    /**
+   * Translate many lines, e.g. every line of an episode.
+   * Translators that can send several texts per request override this, the default translates one after the other.
+   * @param texts The Japanese texts to translate
+   * @return One translation per text, in the same order, with the same failure results as Translate()
+   */
+    [[nodiscard]] virtual std::vector<std::string> TranslateBatch(std::span<const std::string_view> texts)
+    {
+      std::vector<std::string> translations;
+      translations.reserve(texts.size());
+      for (std::string_view text : texts) {
+        translations.push_back(Translate(std::string(text)));
+      }
+      return translations;
+    }
+
     /**
    * Check if translator is available.
+   * Cheap, without network access: whether the translator is configured.
    * @return true if translator is ready to use
    */
     [[nodiscard]] virtual bool IsAvailable() const = 0;
+
+    /**
+   * Check that the provider can be reached.
+   * A network round trip, meant for TranslatorHealthMonitor rather than before each translation.
+   * @return true if the provider answered
+   */
+    [[nodiscard]] virtual bool Probe() const { return IsAvailable(); }
+
+    /**
+   * Describe everything besides the text that the translation depends on (provider, languages, formality).
+   * Translations are cached under it, see CachingTranslator.
+   * @return The scope, or empty if translations must not be cached
+   */
+    [[nodiscard]] virtual std::string GetCacheScope() const { return ""; }
   };
 
 } // namespace Video2Card::Language::Translation
\ No newline at end of file
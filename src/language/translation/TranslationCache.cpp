@@ -0,0 +1,352 @@
+#include "TranslationCache.h"
+
+#include <sqlite3.h>
+#include <stdexcept>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Language::Translation
+{
+
+  namespace
+  {
+    // Separates the scope from the text in a key, neither of them contains it
+    constexpr char KEY_SEPARATOR = '\x1f';
+
+    // Evict down to this share of the limit, so the eviction does not run again on the next store
+    constexpr int64_t EVICTION_TARGET_PERCENT = 75;
+
+    /**
+     * Length of the whitespace character at the start of text, 0 if there is none.
+     * Covers ASCII whitespace and the ideographic space (U+3000) of Japanese subtitles.
+     */
+    size_t WhitespaceLength(std::string_view text)
+    {
+      switch (text[0]) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case '\f':
+        case '\v':
+          return 1;
+        default:
+          break;
+      }
+
+      if (text.starts_with("\xE3\x80\x80"))
+        return 3;
+      return 0;
+    }
+
+    std::string BuildKey(std::string_view scope, const std::string& normalizedText)
+    {
+      std::string key;
+      key.reserve(scope.size() + 1 + normalizedText.size());
+      key.append(scope);
+      key.push_back(KEY_SEPARATOR);
+      key.append(normalizedText);
+      return key;
+    }
+  } // namespace
+
+  TranslationCache::TranslationCache(const std::string& dbPath)
+      : TranslationCache(dbPath, Options{})
+  {}
+
+  TranslationCache::TranslationCache(const std::string& dbPath, Options options)
+      : m_Database(nullptr)
+      , m_Options(options)
+  {
+    int result = sqlite3_open_v2(dbPath.c_str(),
+                                 &m_Database,
+                                 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX,
+                                 nullptr);
+
+    if (result != SQLITE_OK) {
+      std::string error = sqlite3_errmsg(m_Database);
+      sqlite3_close(m_Database);
+      m_Database = nullptr;
+      throw std::runtime_error("Failed to open translation cache: " + error);
+    }
+
+    const char* schema = R"(
+      PRAGMA journal_mode = WAL;
+      PRAGMA synchronous = NORMAL;
+      CREATE TABLE IF NOT EXISTS translations (
+        hash INTEGER PRIMARY KEY,
+        key TEXT NOT NULL,
+        translation TEXT NOT NULL,
+        size INTEGER NOT NULL,
+        last_used INTEGER NOT NULL
+      );
+      CREATE INDEX IF NOT EXISTS translations_last_used ON translations(last_used);
+    )";
+
+    char* errorMessage = nullptr;
+    if (sqlite3_exec(m_Database, schema, nullptr, nullptr, &errorMessage) != SQLITE_OK) {
+      std::string error = errorMessage ? errorMessage : "Unknown error";
+      sqlite3_free(errorMessage);
+      sqlite3_close(m_Database);
+      m_Database = nullptr;
+      throw std::runtime_error("Failed to create translation cache: " + error);
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    const char* totals = "SELECT COALESCE(SUM(size), 0), COALESCE(MAX(last_used), 0) FROM translations";
+    if (sqlite3_prepare_v2(m_Database, totals, -1, &stmt, nullptr) == SQLITE_OK) {
+      if (sqlite3_step(stmt) == SQLITE_ROW) {
+        m_DiskBytes = sqlite3_column_int64(stmt, 0);
+        m_UseCounter = sqlite3_column_int64(stmt, 1);
+      }
+    }
+    sqlite3_finalize(stmt);
+
+    AF_INFO("Translation cache opened from: {} ({} KiB)", dbPath, m_DiskBytes / 1024);
+  }
+
+  TranslationCache::~TranslationCache()
+  {
+    if (m_Database) {
+      FlushTouches();
+      sqlite3_close(m_Database);
+      m_Database = nullptr;
+    }
+  }
+
+  std::optional<std::string> TranslationCache::Find(std::string_view scope, std::string_view text)
+  {
+    std::string key = BuildKey(scope, NormalizeText(text));
+    uint64_t hash = HashKey(key);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    auto recent = m_RecentByHash.find(hash);
+    if (recent != m_RecentByHash.end() && recent->second->key == key) {
+      m_Recent.splice(m_Recent.begin(), m_Recent, recent->second);
+      m_PendingTouches[hash] = ++m_UseCounter;
+      return recent->second->translation;
+    }
+
+    const char* sql = "SELECT key, translation FROM translations WHERE hash = ?";
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(m_Database, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+      AF_ERROR("Failed to prepare translation cache lookup: {}", sqlite3_errmsg(m_Database));
+      return std::nullopt;
+    }
+
+    sqlite3_bind_int64(stmt, 1, (sqlite3_int64) hash);
+
+    std::optional<std::string> translation;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+      const char* storedKey = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+      const char* storedTranslation = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+
+      // Two keys with the same hash, the stored one belongs to the other key
+      if (storedKey && storedTranslation && key == storedKey) {
+        translation = storedTranslation;
+      }
+    }
+    sqlite3_finalize(stmt);
+
+    if (translation) {
+      m_PendingTouches.erase(hash);
+      Touch(hash, ++m_UseCounter);
+      Remember(hash, key, *translation);
+    }
+
+    return translation;
+  }
+
+  void TranslationCache::Store(std::string_view scope, std::string_view text, const std::string& translation)
+  {
+    std::string key = BuildKey(scope, NormalizeText(text));
+    uint64_t hash = HashKey(key);
+    int64_t size = (int64_t) (key.size() + translation.size());
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // Before a possible eviction, so lines answered from memory are not taken for unused ones
+    m_PendingTouches.erase(hash);
+    FlushTouches();
+
+    Remember(hash, key, translation);
+
+    // The size of the entry this one replaces, if any, so the total stays right
+    int64_t replacedSize = 0;
+    bool collision = false;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(m_Database, "SELECT key, size FROM translations WHERE hash = ?", -1, &stmt, nullptr) ==
+        SQLITE_OK)
+    {
+      sqlite3_bind_int64(stmt, 1, (sqlite3_int64) hash);
+      if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* storedKey = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        collision = storedKey && key != storedKey;
+        replacedSize = sqlite3_column_int64(stmt, 1);
+      }
+    }
+    sqlite3_finalize(stmt);
+
+    // Two keys with the same hash, the stored one stays and this one is only kept in memory
+    if (collision) {
+      AF_DEBUG("Translation cache hash collision, not storing the new entry on disk");
+      return;
+    }
+
+    const char* sql = R"(
+      INSERT OR REPLACE INTO translations (hash, key, translation, size, last_used)
+      VALUES (?, ?, ?, ?, ?)
+    )";
+
+    stmt = nullptr;
+    if (sqlite3_prepare_v2(m_Database, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+      AF_ERROR("Failed to prepare translation cache insert: {}", sqlite3_errmsg(m_Database));
+      return;
+    }
+
+    sqlite3_bind_int64(stmt, 1, (sqlite3_int64) hash);
+    sqlite3_bind_text(stmt, 2, key.data(), (int) key.size(), SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, translation.data(), (int) translation.size(), SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 4, size);
+    sqlite3_bind_int64(stmt, 5, ++m_UseCounter);
+
+    if (sqlite3_step(stmt) == SQLITE_DONE) {
+      m_DiskBytes += size - replacedSize;
+    } else {
+      AF_WARN("Failed to store translation in the cache: {}", sqlite3_errmsg(m_Database));
+    }
+    sqlite3_finalize(stmt);
+
+    if (m_DiskBytes > (int64_t) m_Options.maxDiskBytes) {
+      EvictFromDisk();
+    }
+  }
+
+  std::string TranslationCache::NormalizeText(std::string_view text)
+  {
+    std::string normalized;
+    normalized.reserve(text.size());
+
+    bool pendingSpace = false;
+    size_t i = 0;
+    while (i < text.size()) {
+      size_t whitespace = WhitespaceLength(text.substr(i));
+      if (whitespace > 0) {
+        pendingSpace = !normalized.empty();
+        i += whitespace;
+        continue;
+      }
+
+      if (pendingSpace) {
+        normalized.push_back(' ');
+        pendingSpace = false;
+      }
+      normalized.push_back(text[i]);
+      ++i;
+    }
+
+    return normalized;
+  }
+
+  uint64_t TranslationCache::HashKey(std::string_view key)
+  {
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+      hash ^= c;
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  void TranslationCache::Remember(uint64_t hash, const std::string& key, const std::string& translation)
+  {
+    auto existing = m_RecentByHash.find(hash);
+    if (existing != m_RecentByHash.end()) {
+      m_Recent.erase(existing->second);
+      m_RecentByHash.erase(existing);
+    }
+
+    m_Recent.push_front({hash, key, translation});
+    m_RecentByHash[hash] = m_Recent.begin();
+
+    while (m_Recent.size() > m_Options.memoryEntries) {
+      m_RecentByHash.erase(m_Recent.back().hash);
+      m_Recent.pop_back();
+    }
+  }
+
+  void TranslationCache::Touch(uint64_t hash, int64_t useCounter)
+  {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(m_Database, "UPDATE translations SET last_used = ? WHERE hash = ?", -1, &stmt, nullptr) !=
+        SQLITE_OK)
+    {
+      return;
+    }
+
+    sqlite3_bind_int64(stmt, 1, useCounter);
+    sqlite3_bind_int64(stmt, 2, (sqlite3_int64) hash);
+    sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+  }
+
+  void TranslationCache::FlushTouches()
+  {
+    if (m_PendingTouches.empty()) {
+      return;
+    }
+
+    // One transaction for all of them instead of a commit per row
+    sqlite3_exec(m_Database, "BEGIN", nullptr, nullptr, nullptr);
+    for (const auto& [hash, useCounter] : m_PendingTouches) {
+      Touch(hash, useCounter);
+    }
+    sqlite3_exec(m_Database, "COMMIT", nullptr, nullptr, nullptr);
+    m_PendingTouches.clear();
+  }
+
+  void TranslationCache::EvictFromDisk()
+  {
+    int64_t target = (int64_t) m_Options.maxDiskBytes * EVICTION_TARGET_PERCENT / 100;
+
+    // Walk the entries from the least recently used one until enough of them are gone, then delete them at once
+    const char* sql = "SELECT size, last_used FROM translations ORDER BY last_used";
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(m_Database, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+      AF_ERROR("Failed to prepare translation cache eviction: {}", sqlite3_errmsg(m_Database));
+      return;
+    }
+
+    int64_t remaining = m_DiskBytes;
+    int64_t cutoff = -1;
+    while (remaining > target && sqlite3_step(stmt) == SQLITE_ROW) {
+      remaining -= sqlite3_column_int64(stmt, 0);
+      cutoff = sqlite3_column_int64(stmt, 1);
+    }
+    sqlite3_finalize(stmt);
+
+    if (cutoff < 0) {
+      return;
+    }
+
+    stmt = nullptr;
+    if (sqlite3_prepare_v2(m_Database, "DELETE FROM translations WHERE last_used <= ?", -1, &stmt, nullptr) !=
+        SQLITE_OK)
+    {
+      AF_ERROR("Failed to prepare translation cache eviction: {}", sqlite3_errmsg(m_Database));
+      return;
+    }
+
+    sqlite3_bind_int64(stmt, 1, cutoff);
+    if (sqlite3_step(stmt) == SQLITE_DONE) {
+      AF_DEBUG("Evicted {} KiB of old translations from the cache", (m_DiskBytes - remaining) / 1024);
+      m_DiskBytes = remaining;
+    }
+    sqlite3_finalize(stmt);
+  }
+
+} // namespace Video2Card::Language::Translation
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+struct sqlite3;
+
+namespace Video2Card::Language::Translation
+{
+
+  /**
+ * Translations that were already paid for, kept across sessions in an SQLite database.
+ * Entries are keyed by a hash of the translator's cache scope (provider, languages, formality) and the normalized
+ * text. The most recently used entries are also kept in memory, so a repeated line is answered without touching the
+ * disk. The database is bounded in size, the least recently used entries go first.
+ * Thread-safe.
+ */
+  class TranslationCache
+  {
+public:
+
+    struct Options
+    {
+      size_t memoryEntries = 1024;            // Entries kept in memory
+      size_t maxDiskBytes = 32 * 1024 * 1024; // Text stored on disk before the oldest entries are evicted
+    };
+
+    /**
+   * Open or create the cache database.
+   * @param dbPath Path of the database, e.g. in FileUtils::GetCachePath()
+   * @param options Size limits
+   * @throws std::runtime_error if the database cannot be opened
+   */
+    explicit TranslationCache(const std::string& dbPath);
+    TranslationCache(const std::string& dbPath, Options options);
+    ~TranslationCache();
+
+    TranslationCache(const TranslationCache&) = delete;
+    TranslationCache& operator=(const TranslationCache&) = delete;
+    TranslationCache(TranslationCache&&) = delete;
+    TranslationCache& operator=(TranslationCache&&) = delete;
+
+    /**
+   * Look up a translation.
+   * @param scope Cache scope of the translator
+   * @param text The text to translate
+   * @return The cached translation, if any
+   */
+    [[nodiscard]] std::optional<std::string> Find(std::string_view scope, std::string_view text);
+
+    /**
+   * Store a translation.
+   * @param scope Cache scope of the translator
+   * @param text The translated text
+   * @param translation Its translation
+   */
+    void Store(std::string_view scope, std::string_view text, const std::string& translation);
+
+    /**
+   * Collapse the whitespace of a subtitle line, so line breaks and padding do not make a new entry.
+   * @param text The text
+   * @return The text without leading and trailing whitespace, inner runs replaced by a single space
+   */
+    [[nodiscard]] static std::string NormalizeText(std::string_view text);
+
+private:
+
+    struct MemoryEntry
+    {
+      uint64_t hash;
+      std::string key;
+      std::string translation;
+    };
+
+    /**
+   * Stable across runs and platforms, unlike std::hash, since the hashes are stored on disk.
+   */
+    [[nodiscard]] static uint64_t HashKey(std::string_view key);
+
+    void Remember(uint64_t hash, const std::string& key, const std::string& translation);
+    void Touch(uint64_t hash, int64_t useCounter);
+    void FlushTouches();
+    void EvictFromDisk();
+
+    sqlite3* m_Database;
+    Options m_Options;
+
+    std::mutex m_Mutex;
+    std::list<MemoryEntry> m_Recent; // Most recently used first
+    std::unordered_map<uint64_t, std::list<MemoryEntry>::iterator> m_RecentByHash;
+    // Use of entries answered from memory, written to disk with the next store so hits stay off the disk
+    std::unordered_map<uint64_t, int64_t> m_PendingTouches;
+    int64_t m_DiskBytes = 0;
+    int64_t m_UseCounter = 0;
+  };
+
+} // namespace Video2Card::Language::Translation
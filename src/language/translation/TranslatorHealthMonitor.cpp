@@ -0,0 +1,154 @@
+#include "TranslatorHealthMonitor.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Language::Translation
+{
+
+  TranslatorHealthMonitor::TranslatorHealthMonitor()
+      : TranslatorHealthMonitor(Options{})
+  {}
+
+  TranslatorHealthMonitor::TranslatorHealthMonitor(Options options)
+      : m_Options(options)
+  {
+    m_Worker = std::thread([this]() { WorkerMain(); });
+  }
+
+  TranslatorHealthMonitor::~TranslatorHealthMonitor()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_StopRequested = true;
+    }
+    m_Condition.notify_all();
+
+    // A probe that is already running finishes first, its client has its own timeout
+    if (m_Worker.joinable())
+      m_Worker.join();
+  }
+
+  void TranslatorHealthMonitor::Register(const std::string& id, Probe probe)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      Provider& provider = m_Providers[id];
+      provider.probe = std::move(probe);
+      provider.nextCheck = Clock::now();
+    }
+    m_Condition.notify_all();
+  }
+
+  bool TranslatorHealthMonitor::IsAvailable(const std::string& id) const
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Providers.find(id);
+    return it == m_Providers.end() || !it->second.open;
+  }
+
+  void TranslatorHealthMonitor::ReportSuccess(const std::string& id)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Providers.find(id);
+    if (it == m_Providers.end())
+      return;
+
+    if (it->second.open)
+      AF_INFO("Translator '{}' is back", id);
+    it->second.open = false;
+    it->second.consecutiveFailures = 0;
+  }
+
+  void TranslatorHealthMonitor::ReportFailure(const std::string& id)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      auto it = m_Providers.find(id);
+      if (it == m_Providers.end())
+        return;
+
+      Provider& provider = it->second;
+      provider.consecutiveFailures++;
+      if (provider.open || provider.consecutiveFailures < m_Options.failureThreshold)
+        return;
+
+      AF_WARN("Translator '{}' failed {} times in a row, skipping it until it answers again",
+              id,
+              provider.consecutiveFailures);
+      provider.open = true;
+      provider.nextCheck = Clock::now() + m_Options.retryInterval;
+    }
+    m_Condition.notify_all();
+  }
+
+  void TranslatorHealthMonitor::Recheck(const std::string& id)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      auto it = m_Providers.find(id);
+      if (it == m_Providers.end())
+        return;
+      it->second.nextCheck = Clock::now();
+    }
+    m_Condition.notify_all();
+  }
+
+  void TranslatorHealthMonitor::WorkerMain()
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (!m_StopRequested) {
+      // The provider that is due first
+      auto due = m_Providers.end();
+      for (auto it = m_Providers.begin(); it != m_Providers.end(); ++it) {
+        if (due == m_Providers.end() || it->second.nextCheck < due->second.nextCheck)
+          due = it;
+      }
+
+      if (due == m_Providers.end()) {
+        m_Condition.wait(lock);
+        continue;
+      }
+
+      if (due->second.nextCheck > Clock::now()) {
+        m_Condition.wait_until(lock, due->second.nextCheck);
+        continue;
+      }
+
+      std::string id = due->first;
+      Probe probe = due->second.probe;
+      // Not due again while the probe runs, a Recheck() in the meantime moves it forward
+      due->second.nextCheck = Clock::now() + m_Options.ttl;
+
+      lock.unlock();
+      bool healthy = false;
+      try {
+        healthy = probe && probe();
+      } catch (const std::exception& e) {
+        AF_WARN("Health check of translator '{}' failed: {}", id, e.what());
+      }
+      lock.lock();
+
+      auto it = m_Providers.find(id);
+      if (it == m_Providers.end())
+        continue;
+
+      Provider& provider = it->second;
+      if (healthy) {
+        if (provider.open)
+          AF_INFO("Translator '{}' is back", id);
+        provider.open = false;
+        provider.consecutiveFailures = 0;
+      } else {
+        if (!provider.open)
+          AF_WARN("Translator '{}' is not reachable, skipping it until it answers again", id);
+        provider.open = true;
+        provider.nextCheck = std::min(provider.nextCheck, Clock::now() + m_Options.retryInterval);
+      }
+    }
+  }
+
+} // namespace Video2Card::Language::Translation
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Video2Card::Language::Translation
+{
+
+  /**
+ * Availability of the translation providers, kept up to date on a background thread.
+ * IsAvailable() only reads the last known state, so a translation never waits on a health check. Each provider
+ * is probed when it is registered and again once the result is older than the TTL. A failed probe, or enough
+ * failed translations in a row, opens the circuit: the provider is skipped right away instead of waiting out its
+ * timeouts, until a probe succeeds again.
+ */
+  class TranslatorHealthMonitor
+  {
+public:
+
+    using Probe = std::function<bool()>;
+
+    struct Options
+    {
+      std::chrono::seconds ttl{300};          // Re-probe a healthy provider after this long
+      std::chrono::seconds retryInterval{30}; // Probe a failed provider again after this long
+      int failureThreshold = 3;               // Failed translations in a row that open the circuit
+    };
+
+    TranslatorHealthMonitor();
+    explicit TranslatorHealthMonitor(Options options);
+    ~TranslatorHealthMonitor();
+
+    TranslatorHealthMonitor(const TranslatorHealthMonitor&) = delete;
+    TranslatorHealthMonitor& operator=(const TranslatorHealthMonitor&) = delete;
+
+    /**
+     * Start watching a provider, it is probed right away
+     * @param id Identifier of the provider, e.g. "deepl"
+     * @param probe Network check of the provider, called on the monitor's thread
+     */
+    void Register(const std::string& id, Probe probe);
+
+    /**
+     * Check the last known state of a provider, without any network access
+     * @return false while the circuit of the provider is open, true for providers that are not registered
+     */
+    [[nodiscard]] bool IsAvailable(const std::string& id) const;
+
+    /**
+     * Report a translation that went through, closes the circuit
+     */
+    void ReportSuccess(const std::string& id);
+
+    /**
+     * Report a failed translation, counts towards opening the circuit
+     */
+    void ReportFailure(const std::string& id);
+
+    /**
+     * Probe a provider again as soon as possible, e.g. after its settings changed
+     */
+    void Recheck(const std::string& id);
+
+private:
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Provider
+    {
+      Probe probe;
+      bool open = false; // Circuit open, the provider is skipped
+      int consecutiveFailures = 0;
+      Clock::time_point nextCheck;
+    };
+
+    void WorkerMain();
+
+    Options m_Options;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::map<std::string, Provider> m_Providers;
+    bool m_StopRequested = false;
+
+    std::thread m_Worker;
+  };
+
+} // namespace Video2Card::Language::Translation
@@ -149,6 +149,17 @@ namespace Video2Card::UI
     }
   }
 
+  void AnkiCardSettingsSection::SetFieldByTool(int toolIndex, const Utils::RawImage& image, const std::string& filename)
+  {
+    for (auto& field : m_Fields) {
+      if (field->IsToolEnabled() && field->GetSelectedToolIndex() == toolIndex) {
+        AF_INFO("Auto-filling field '{}' with tool index {} (image)", field->GetName(), toolIndex);
+        field->SetType(CardFieldType::Image);
+        field->SetRawImage(image, filename);
+      }
+    }
+  }
+
   AnkiCardSettingsSection::~AnkiCardSettingsSection() {}
 
   void AnkiCardSettingsSection::Render()
@@ -375,26 +386,48 @@ namespace Video2Card::UI
     std::string modelName = m_NoteTypes[m_SelectedNoteTypeIndex];
     std::map<std::string, std::string> fieldsMap;
 
+    const auto& imageProfile = m_ConfigManager
+                                   ? Utils::WebPEncoder::GetProfile(m_ConfigManager->GetConfig().ImageEncoderProfile)
+                                   : Utils::WebPEncoder::GetDefaultProfile();
+
     for (const auto& field : m_Fields) {
       std::string fieldValue = field->GetValue();
       const auto& binaryData = field->GetBinaryData();
+      const auto& rawImage = field->GetRawImage();
+      bool hasRawImage = field->GetType() == CardFieldType::Image && !rawImage.IsEmpty();
 
-      if (!binaryData.empty()) {
+      if (!binaryData.empty() || hasRawImage) {
         auto now = std::chrono::system_clock::now();
         auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
         std::string uniqueFilename = std::to_string(timestamp) + "_" + fieldValue;
 
         // Process binary data based on field type
         std::vector<unsigned char> processedData = binaryData;
+        bool isWebP = false;
 
-        if (field->GetType() == CardFieldType::Image) {
+        if (hasRawImage) {
+          // Snapshots stay uncompressed until now, so this is the only encode they go through
+          processedData = Utils::ImageProcessor::EncodeToWebP(rawImage, 320, 320, imageProfile);
+          if (processedData.empty()) {
+            AF_ERROR("Failed to encode image for field '{}'", field->GetName());
+            continue;
+          }
+          isWebP = true;
+          AF_INFO("Image encoded: {}x{} -> {} bytes", rawImage.width, rawImage.height, processedData.size());
+        } else if (field->GetType() == CardFieldType::Image) {
           // Compress image to WebP format, scaling to fit 320x320
           AF_INFO("Compressing image to WebP format (max 320x320)...");
-          processedData = Utils::ImageProcessor::ScaleAndCompressToWebP(binaryData, 320, 320, 75);
+          processedData = Utils::ImageProcessor::ScaleAndCompressToWebP(binaryData, 320, 320, imageProfile);
           if (processedData.empty()) {
             AF_WARN("Failed to compress image, using original");
             processedData = binaryData;
+          } else {
+            isWebP = true;
           }
+          AF_INFO("Image compressed: {} bytes -> {} bytes", binaryData.size(), processedData.size());
+        }
+
+        if (isWebP) {
           // Update filename extension for WebP
           size_t dotPos = uniqueFilename.find_last_of(".");
           if (dotPos != std::string::npos) {
@@ -402,7 +435,6 @@ namespace Video2Card::UI
           } else {
             uniqueFilename += ".webp";
           }
-          AF_INFO("Image compressed: {} bytes -> {} bytes", binaryData.size(), processedData.size());
         }
 
         std::string base64Data = Video2Card::Utils::Base64Utils::Encode(processedData);
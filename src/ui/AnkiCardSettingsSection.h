@@ -37,6 +37,7 @@ public:
     void SetField(const std::string& name, const std::string& value);
     void SetFieldByTool(int toolIndex, const std::string& value);
     void SetFieldByTool(int toolIndex, const std::vector<unsigned char>& data, const std::string& filename);
+    void SetFieldByTool(int toolIndex, const Utils::RawImage& image, const std::string& filename);
 
     void SetOnStatusMessageCallback(std::function<void(const std::string&)> callback) { m_OnStatusMessage = callback; }
 
@@ -0,0 +1,154 @@
+#include "ui/BatchMiningSection.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <string>
+
+#include "IconsFontAwesome6.h"
+#include "core/BatchMiner.h"
+
+namespace Video2Card::UI
+{
+
+  namespace
+  {
+    template <typename T>
+    bool IsResolved(const std::shared_future<T>& future)
+    {
+      return !future.valid() || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    std::string FormatTime(double seconds)
+    {
+      int total = std::max(0, (int) seconds);
+      if (total >= 3600)
+        return std::format("{}:{:02d}:{:02d}", total / 3600, total / 60 % 60, total % 60);
+      return std::format("{:02d}:{:02d}", total / 60, total % 60);
+    }
+  } // namespace
+
+  BatchMiningSection::BatchMiningSection(Core::BatchMiner* miner)
+      : m_Miner(miner)
+  {}
+
+  BatchMiningSection::~BatchMiningSection() {}
+
+  void BatchMiningSection::SetCandidates(std::vector<Core::PreparedCue> candidates)
+  {
+    m_Candidates = std::move(candidates);
+    m_Ready.assign(m_Candidates.size(), false);
+    m_Extracted.assign(m_Candidates.size(), false);
+    m_ReadyCount = 0;
+  }
+
+  void BatchMiningSection::Clear()
+  {
+    SetCandidates({});
+  }
+
+  bool BatchMiningSection::IsBusy() const
+  {
+    return (m_Miner && m_Miner->IsRunning()) || m_ReadyCount < m_Candidates.size();
+  }
+
+  void BatchMiningSection::UpdateReadyState()
+  {
+    // A resolved line stays resolved, only the pending ones are polled
+    for (size_t i = 0; i < m_Candidates.size(); ++i) {
+      if (m_Ready[i])
+        continue;
+
+      const auto& candidate = m_Candidates[i];
+      if (IsResolved(candidate.image) && IsResolved(candidate.audio) && IsResolved(candidate.analysis)) {
+        m_Ready[i] = true;
+        ++m_ReadyCount;
+      }
+    }
+  }
+
+  void BatchMiningSection::Render()
+  {
+    ImGui::Begin("Batch Mining", nullptr, ImGuiWindowFlags_NoCollapse);
+
+    UpdateReadyState();
+
+    bool running = m_Miner && m_Miner->IsRunning();
+    if (running) {
+      if (ImGui::Button(ICON_FA_XMARK " Cancel", ImVec2(140, 0))) {
+        m_Miner->Cancel();
+      }
+    } else if (ImGui::Button(ICON_FA_LAYER_GROUP " Mine Episode", ImVec2(140, 0))) {
+      if (m_OnMineCallback)
+        m_OnMineCallback();
+    }
+
+    if (!m_Candidates.empty()) {
+      ImGui::SameLine();
+      std::string progress = std::format("{}/{} lines ready", m_ReadyCount, m_Candidates.size());
+      float fraction = running ? m_Miner->GetProgress() : (float) m_ReadyCount / m_Candidates.size();
+      ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), progress.c_str());
+    }
+
+    if (m_Candidates.empty()) {
+      ImGui::TextDisabled("Prepares a card for every subtitle line of the video in one pass.");
+    } else {
+      RenderCandidates();
+    }
+
+    ImGui::End();
+  }
+
+  void BatchMiningSection::RenderCandidates()
+  {
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerH | ImGuiTableFlags_ScrollY;
+    if (!ImGui::BeginTable("Candidates", 4, flags))
+      return;
+
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Time", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Sentence", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableHeadersRow();
+
+    // A season episode has several hundred lines, only the visible rows are laid out
+    ImGuiListClipper clipper;
+    clipper.Begin((int) m_Candidates.size());
+    while (clipper.Step()) {
+      for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+        const auto& candidate = m_Candidates[row];
+        ImGui::PushID(row);
+        ImGui::TableNextRow();
+
+        ImGui::TableNextColumn();
+        if (ImGui::SmallButton(FormatTime(candidate.start).c_str()) && m_OnSeekCallback) {
+          m_OnSeekCallback(candidate.start);
+        }
+
+        ImGui::TableNextColumn();
+        if (m_Extracted[row]) {
+          ImGui::TextDisabled("%s", candidate.sentence.c_str());
+        } else {
+          ImGui::TextUnformatted(candidate.sentence.c_str());
+        }
+
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(m_Ready[row] ? ICON_FA_CHECK : ICON_FA_HOURGLASS);
+
+        ImGui::TableNextColumn();
+        if (ImGui::SmallButton(ICON_FA_CROP " Extract") && m_OnExtractCallback) {
+          m_Extracted[row] = true;
+          m_OnExtractCallback(candidate);
+        }
+
+        ImGui::PopID();
+      }
+    }
+
+    ImGui::EndTable();
+  }
+
+} // namespace Video2Card::UI
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "core/PreparedCue.h"
+#include "ui/UIComponent.h"
+
+namespace Video2Card::Core
+{
+  class BatchMiner;
+}
+
+namespace Video2Card::UI
+{
+
+  /**
+   * Review list for a mined episode
+   * Shows every line of the last batch run with whether its image, audio and analysis are ready. A line goes
+   * into the regular Extract dialog from here, with everything the run prepared for it.
+   */
+  class BatchMiningSection : public UIComponent
+  {
+public:
+
+    explicit BatchMiningSection(Core::BatchMiner* miner);
+    ~BatchMiningSection() override;
+
+    void Render() override;
+
+    // Called when the user asks to mine the loaded video
+    void SetOnMineCallback(std::function<void()> callback) { m_OnMineCallback = callback; }
+    void SetOnExtractCallback(std::function<void(const Core::PreparedCue&)> callback)
+    {
+      m_OnExtractCallback = callback;
+    }
+    void SetOnSeekCallback(std::function<void(double)> callback) { m_OnSeekCallback = callback; }
+
+    void SetCandidates(std::vector<Core::PreparedCue> candidates);
+    void Clear();
+
+    // True while lines are still being prepared
+    bool IsBusy() const;
+
+private:
+
+    void UpdateReadyState();
+    void RenderCandidates();
+
+    Core::BatchMiner* m_Miner;
+
+    std::vector<Core::PreparedCue> m_Candidates;
+    std::vector<bool> m_Ready;     // Image, audio and analysis all resolved
+    std::vector<bool> m_Extracted; // Already sent to the Extract dialog
+    size_t m_ReadyCount = 0;
+
+    std::function<void()> m_OnMineCallback;
+    std::function<void(const Core::PreparedCue&)> m_OnExtractCallback;
+    std::function<void(double)> m_OnSeekCallback;
+  };
+
+} // namespace Video2Card::UI
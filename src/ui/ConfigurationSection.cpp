@@ -3,13 +3,17 @@
 #include <imgui.h>
 #include <imgui_stdlib.h>
 
+#include <cstdlib>
 #include <thread>
 
 #include "api/AnkiConnectClient.h"
+#include "audio/AudioClipEncoder.h"
 #include "config/ConfigManager.h"
 #include "core/Logger.h"
 #include "language/ILanguage.h"
+#include "language/services/DeepLService.h"
 #include "language/services/ILanguageService.h"
+#include "utils/WebPEncoder.h"
 
 namespace Video2Card::UI
 {
@@ -78,6 +82,58 @@ namespace Video2Card::UI
     if (!m_AnkiConnectError.empty()) {
       ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "%s", m_AnkiConnectError.c_str());
     }
+
+    ImGui::Spacing();
+    ImGui::Text("Card Media");
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    const auto& currentProfile = Utils::WebPEncoder::GetProfile(config.ImageEncoderProfile);
+    if (ImGui::BeginCombo("Image Encoding", currentProfile.name.data())) {
+      for (const auto& profile : Utils::WebPEncoder::GetProfiles()) {
+        bool isSelected = profile.id == currentProfile.id;
+        if (ImGui::Selectable(profile.name.data(), isSelected)) {
+          config.ImageEncoderProfile = profile.id;
+          m_ConfigManager->Save();
+        }
+        if (isSelected) {
+          ImGui::SetItemDefaultFocus();
+        }
+      }
+      ImGui::EndCombo();
+    }
+
+    const auto& currentAudioProfile = Audio::AudioClipEncoder::GetProfile(config.AudioEncoderProfile);
+    if (ImGui::BeginCombo("Audio Encoding", currentAudioProfile.name.data())) {
+      for (const auto& profile : Audio::AudioClipEncoder::GetProfiles()) {
+        bool isSelected = profile.id == currentAudioProfile.id;
+        if (ImGui::Selectable(profile.name.data(), isSelected)) {
+          config.AudioEncoderProfile = profile.id;
+          m_ConfigManager->Save();
+        }
+        if (isSelected) {
+          ImGui::SetItemDefaultFocus();
+        }
+      }
+      ImGui::EndCombo();
+    }
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("Used whenever the sentence audio is re-encoded");
+    }
+
+    if (ImGui::Checkbox("Copy sentence audio without re-encoding", &config.AudioStreamCopy)) {
+      m_ConfigManager->Save();
+    }
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("AAC, Opus, Vorbis and MP3 tracks are cut on packet boundaries and kept as they are");
+    }
+
+    if (ImGui::Checkbox("Sample-accurate audio cuts", &config.AudioSampleAccurate)) {
+      m_ConfigManager->Save();
+    }
+    if (ImGui::IsItemHovered()) {
+      ImGui::SetTooltip("Cuts at the exact subtitle timing, the clip is always re-encoded");
+    }
   }
 
   void ConfigurationSection::RenderLanguageServicesTab()
@@ -134,7 +190,12 @@ namespace Video2Card::UI
 
       // Render selected translator's configuration
       if (selectedTranslator) {
-        if (selectedTranslator->RenderConfigurationUI()) {
+        bool configChanged = false;
+        if (auto* deeplService = dynamic_cast<Language::Services::DeepLService*>(selectedTranslator)) {
+          configChanged = RenderDeepLConfiguration(*deeplService);
+        }
+
+        if (configChanged) {
           // Save config for this service
           auto serviceConfig = selectedTranslator->SaveConfig();
 
@@ -155,4 +216,118 @@ namespace Video2Card::UI
     }
   }
 
+  bool ConfigurationSection::RenderDeepLConfiguration(Language::Services::DeepLService& service)
+  {
+    auto& settings = service.GetSettings();
+    bool configChanged = false;
+
+    // API Key input
+    if (ImGui::InputText("API Key", &settings.apiKey, ImGuiInputTextFlags_Password)) {
+      configChanged = true;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Get API Key")) {
+// Open DeepL API page in browser
+#ifdef __APPLE__
+      system("open https://www.deepl.com/pro-api");
+#elif defined(_WIN32)
+      system("start https://www.deepl.com/pro-api");
+#else
+      system("xdg-open https://www.deepl.com/pro-api");
+#endif
+    }
+
+    ImGui::Spacing();
+
+    // API tier selection
+    if (ImGui::Checkbox("Use Free API (free tier)", &settings.useFreeAPI)) {
+      configChanged = true;
+    }
+    ImGui::TextWrapped("Free API has a 500,000 character/month limit. Pro API requires a paid subscription.");
+
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // Language settings
+    ImGui::Text("Language Settings");
+
+    const char* sourceLangs[] = {"JA", "EN", "DE", "FR", "ES", "IT", "NL", "PL", "PT", "RU", "ZH"};
+    int currentSource = 0;
+    for (int i = 0; i < IM_ARRAYSIZE(sourceLangs); i++) {
+      if (settings.sourceLang == sourceLangs[i]) {
+        currentSource = i;
+        break;
+      }
+    }
+
+    if (ImGui::Combo("Source Language", &currentSource, sourceLangs, IM_ARRAYSIZE(sourceLangs))) {
+      settings.sourceLang = sourceLangs[currentSource];
+      configChanged = true;
+    }
+
+    const char* targetLangs[] = {"EN-US", "EN-GB", "DE", "FR", "ES", "IT", "NL", "PL", "PT-BR", "PT-PT", "RU", "ZH"};
+    int currentTarget = 0;
+    for (int i = 0; i < IM_ARRAYSIZE(targetLangs); i++) {
+      if (settings.targetLang == targetLangs[i]) {
+        currentTarget = i;
+        break;
+      }
+    }
+
+    if (ImGui::Combo("Target Language", &currentTarget, targetLangs, IM_ARRAYSIZE(targetLangs))) {
+      settings.targetLang = targetLangs[currentTarget];
+      configChanged = true;
+    }
+
+    ImGui::Spacing();
+
+    // Formality setting
+    const char* formalityLevels[] = {"default", "more", "less"};
+    int currentFormality = 0;
+    for (int i = 0; i < IM_ARRAYSIZE(formalityLevels); i++) {
+      if (settings.formality == formalityLevels[i]) {
+        currentFormality = i;
+        break;
+      }
+    }
+
+    if (ImGui::Combo("Formality", &currentFormality, formalityLevels, IM_ARRAYSIZE(formalityLevels))) {
+      settings.formality = formalityLevels[currentFormality];
+      configChanged = true;
+    }
+    ImGui::TextWrapped("Controls the formality level of the translation.");
+
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+
+    // Timeout setting
+    if (ImGui::SliderInt("Timeout (seconds)", &settings.timeoutSeconds, 5, 30)) {
+      configChanged = true;
+    }
+
+    ImGui::Spacing();
+
+    // Initialize/Test button
+    if (ImGui::Button("Initialize Translator")) {
+      if (service.InitializeTranslator()) {
+        AF_INFO("DeepL translator initialized successfully");
+      } else {
+        AF_ERROR("Failed to initialize DeepL translator");
+      }
+    }
+
+    ImGui::SameLine();
+
+    // Status indicator
+    if (service.IsAvailable()) {
+      ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f), "Ready");
+    } else {
+      ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Not Initialized");
+    }
+
+    return configChanged;
+  }
+
 } // namespace Video2Card::UI
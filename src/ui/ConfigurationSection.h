@@ -19,6 +19,7 @@ namespace Video2Card::Config
 namespace Video2Card::Language::Services
 {
   class ILanguageService;
+  class DeepLService;
 }
 
 namespace Video2Card::Language
@@ -54,6 +55,12 @@ public:
 
 private:
 
+    /**
+     * Settings of the DeepL translator
+     * @return true if they changed and should be saved
+     */
+    bool RenderDeepLConfiguration(Language::Services::DeepLService& service);
+
     // AnkiConnect State
     bool m_AnkiConnectConnected = false;
     std::string m_AnkiConnectError;
@@ -2,6 +2,9 @@
 
 #include <imgui.h>
 
+#include <algorithm>
+#include <format>
+
 namespace Video2Card::UI
 {
 
@@ -19,6 +22,17 @@ namespace Video2Card::UI
       ImGui::SameLine();
     }
     ImGui::Text("%s", m_StatusMessage.c_str());
+
+    if (!m_FrameMode.empty()) {
+      std::string frameInfo = std::format("{} | {:.1f} fps | {:.1f} ms (max {:.1f})",
+                                          m_FrameMode,
+                                          m_FrameStats.framesPerSecond,
+                                          m_FrameStats.averageFrameMs,
+                                          m_FrameStats.maxFrameMs);
+      float textWidth = ImGui::CalcTextSize(frameInfo.c_str()).x;
+      ImGui::SameLine(std::max(ImGui::GetCursorPosX(), ImGui::GetWindowContentRegionMax().x - textWidth));
+      ImGui::TextDisabled("%s", frameInfo.c_str());
+    }
     ImGui::End();
   }
 
@@ -32,4 +46,10 @@ namespace Video2Card::UI
     m_Progress = progress;
   }
 
+  void StatusSection::SetFrameStats(std::string_view mode, const Core::FrameStats& stats)
+  {
+    m_FrameMode = mode;
+    m_FrameStats = stats;
+  }
+
 } // namespace Video2Card::UI
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
+#include "core/FrameScheduler.h"
 #include "ui/UIComponent.h"
 
 namespace Video2Card::UI
@@ -18,11 +20,15 @@ public:
 
     void SetStatus(const std::string& status);
     void SetProgress(float progress);
+    void SetFrameStats(std::string_view mode, const Core::FrameStats& stats);
 
 private:
 
     std::string m_StatusMessage;
     float m_Progress = -1.0f;
+
+    std::string m_FrameMode;
+    Core::FrameStats m_FrameStats;
   };
 
 } // namespace Video2Card::UI
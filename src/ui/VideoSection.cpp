@@ -9,33 +9,52 @@
 #include <mpv/render.h>
 
 #include "IconsFontAwesome6.h"
+#include "audio/AudioExtractionSession.h"
 #include "config/ConfigManager.h"
 #include "core/Logger.h"
 #include "language/ILanguage.h"
 #include "utils/LastVideoPath.h"
 #include "utils/VideoState.h"
-
-extern "C" {
-#include <libavcodec/avcodec.h>
-#include <libavformat/avformat.h>
-#include <libavutil/audio_fifo.h>
-#include <libavutil/avutil.h>
-#include <libavutil/imgutils.h>
-#include <libswresample/swresample.h>
-#include <libswscale/swscale.h>
-}
+#include "video/MpvDriver.h"
+#include "video/SnapshotService.h"
+#include "video/SubtitleIndex.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstring>
 #include <iostream>
-#include <webp/encode.h>
 
 namespace Video2Card::UI
 {
 
-  static void* get_proc_address_mpv(void* fn_ctx, const char* name)
+  // SDL byte-order formats paired with the mpv software renderer format that has the same memory layout.
+  // Listed in order of preference: the padded formats are the ones mpv guarantees to support.
+  static constexpr VideoPixelFormat VIDEO_PIXEL_FORMATS[] = {
+      {SDL_PIXELFORMAT_BGRX32, "bgr0"},
+      {SDL_PIXELFORMAT_RGBX32, "rgb0"},
+      {SDL_PIXELFORMAT_BGRA32, "bgra"},
+      {SDL_PIXELFORMAT_RGBA32, "rgba"},
+  };
+
+  static VideoPixelFormat NegotiateVideoPixelFormat(SDL_Renderer* renderer)
   {
-    return nullptr; // For SW render we don't need GL proc address
+    SDL_PropertiesID props = SDL_GetRendererProperties(renderer);
+    const auto* supported = static_cast<const SDL_PixelFormat*>(
+        SDL_GetPointerProperty(props, SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, nullptr));
+
+    if (supported) {
+      for (const auto& candidate : VIDEO_PIXEL_FORMATS) {
+        for (const SDL_PixelFormat* format = supported; *format != SDL_PIXELFORMAT_UNKNOWN; ++format) {
+          if (*format == candidate.sdlFormat) {
+            return candidate;
+          }
+        }
+      }
+    }
+
+    // Every SDL renderer accepts RGBA32, converting internally if it has to
+    return VIDEO_PIXEL_FORMATS[3];
   }
 
   VideoSection::VideoSection(SDL_Renderer* renderer,
@@ -48,6 +67,8 @@ namespace Video2Card::UI
       , m_ActiveLanguage(activeLanguage)
   {
     InitializeMPV();
+    m_SnapshotService = std::make_unique<Video::SnapshotService>();
+    m_AudioSession = std::make_unique<Audio::AudioExtractionSession>();
   }
 
   VideoSection::~VideoSection()
@@ -60,47 +81,30 @@ namespace Video2Card::UI
 
   void VideoSection::InitializeMPV()
   {
-    m_mpv = mpv_create();
-    if (!m_mpv) {
-      AF_ERROR("Failed to create mpv context");
-      return;
-    }
-
-    mpv_set_option_string(m_mpv, "config", "no");
-    mpv_set_option_string(m_mpv, "terminal", "yes");
-    mpv_set_option_string(m_mpv, "msg-level", "all=warn,fatal");
-    mpv_set_option_string(m_mpv, "vd-lavc-threads", "4");
-    mpv_set_option_string(m_mpv, "vo", "libmpv");
-    mpv_set_option_string(m_mpv, "sub-font-color", "white");
+    m_PixelFormat = NegotiateVideoPixelFormat(m_Renderer);
+    AF_INFO("Video frames use mpv format {}", m_PixelFormat.mpvFormat);
 
-    if (mpv_initialize(m_mpv) < 0) {
-      AF_ERROR("Failed to initialize mpv");
+    m_Driver = std::make_unique<Video::MpvDriver>();
+    if (!m_Driver->Start(m_PixelFormat.mpvFormat)) {
+      m_Driver.reset();
       return;
     }
-
-    mpv_render_param params[] = {{MPV_RENDER_PARAM_API_TYPE, const_cast<char*>(MPV_RENDER_API_TYPE_SW)},
-                                 {MPV_RENDER_PARAM_INVALID, nullptr}};
-
-    if (mpv_render_context_create(&m_mpv_render, m_mpv, params) < 0) {
-      std::cerr << "Failed to create mpv render context" << std::endl;
-    }
-
-    mpv_observe_property(m_mpv, 0, "time-pos", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(m_mpv, 0, "duration", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(m_mpv, 0, "pause", MPV_FORMAT_FLAG);
-    mpv_observe_property(m_mpv, 0, "width", MPV_FORMAT_INT64);
-    mpv_observe_property(m_mpv, 0, "height", MPV_FORMAT_INT64);
+    m_mpv = m_Driver->GetHandle();
   }
 
   void VideoSection::DestroyMPV()
   {
-    if (m_mpv_render) {
-      mpv_render_context_free(m_mpv_render);
-      m_mpv_render = nullptr;
+    m_mpv = nullptr;
+    if (m_Driver) {
+      m_Driver->Shutdown();
+      m_Driver.reset();
     }
-    if (m_mpv) {
-      mpv_terminate_destroy(m_mpv);
-      m_mpv = nullptr;
+  }
+
+  void VideoSection::SetOnFrameReadyCallback(std::function<void()> callback)
+  {
+    if (m_Driver) {
+      m_Driver->SetOnPublishCallback(std::move(callback));
     }
   }
 
@@ -112,26 +116,24 @@ namespace Video2Card::UI
     AF_INFO("Loading video file: {}", path);
     m_CurrentVideoPath = path;
     m_FileLoadedSuccessfully = false;
-    m_PendingSeekPosition = -1.0;
 
+    // The driver seeks once the file has been opened
+    double startPosition = -1.0;
     uint64_t savedPosition = Utils::VideoState::LoadPlaybackPosition(path);
     if (savedPosition > 0) {
-      m_PendingSeekPosition = savedPosition / 1000.0;
-      AF_DEBUG("Deferred seek position set to: {} seconds", m_PendingSeekPosition);
+      startPosition = savedPosition / 1000.0;
+      AF_DEBUG("Deferred seek position set to: {} seconds", startPosition);
     }
 
     // Save the last loaded video path for restoration on next startup
     Utils::LastVideoPath::Save(path);
 
-    const char* cmd[] = {"loadfile", path.c_str(), nullptr};
-    int res = mpv_command_async(m_mpv, 0, cmd);
-    if (res < 0) {
-      AF_ERROR("Failed to send loadfile command: {}", mpv_error_string(res));
-    }
+    m_SnapshotService->Open(path);
+    m_AudioSession->Open(path);
+
+    m_Driver->LoadFile(path, startPosition);
 
     m_IsPlaying = true;
-    int pause = 0;
-    mpv_set_property_async(m_mpv, 0, "pause", MPV_FORMAT_FLAG, &pause);
     m_LastSaveTime = 0.0;
   }
 
@@ -155,9 +157,12 @@ namespace Video2Card::UI
         mpv_command_async(m_mpv, 0, cmd);
       }
       m_CurrentVideoPath.clear();
+      m_SnapshotService->Close();
+      m_AudioSession->Close();
       m_IsPlaying = false;
       m_Duration = 0.0;
       m_CurrentTime = 0.0;
+      m_Subtitle = {};
 
       if (m_VideoTexture) {
         SDL_DestroyTexture(m_VideoTexture);
@@ -165,11 +170,17 @@ namespace Video2Card::UI
       }
       m_VideoWidth = 0;
       m_VideoHeight = 0;
-      m_FrameBuffer.clear();
+      m_TextureWidth = 0;
+      m_TextureHeight = 0;
+      m_RenderWidth = 0;
+      m_RenderHeight = 0;
+      m_PendingTextureWidth = 0;
+      m_PendingTextureHeight = 0;
       m_ShouldClearVideo = false;
     }
 
-    HandleMPVEvents();
+    ApplyPlaybackState();
+    UpdateSubtitleIndex();
     UpdateVideoTexture();
 
     // Periodically save playback position to avoid excessive disk writes
@@ -182,123 +193,194 @@ namespace Video2Card::UI
     }
   }
 
-  void VideoSection::HandleMPVEvents()
+  void VideoSection::ApplyPlaybackState()
   {
-    if (!m_mpv)
+    if (!m_Driver || !m_Driver->ConsumeState())
       return;
 
-    while (true) {
-      mpv_event* event = mpv_wait_event(m_mpv, 0);
-      if (event->event_id == MPV_EVENT_NONE)
-        break;
-
-      if (event->event_id == MPV_EVENT_FILE_LOADED) {
-        m_FileLoadedSuccessfully = true;
-        AF_DEBUG("File loaded event received");
-        if (m_PendingSeekPosition >= 0.0) {
-          AF_INFO("Performing deferred seek to {} seconds", m_PendingSeekPosition);
-          mpv_set_property_async(m_mpv, 0, "time-pos", MPV_FORMAT_DOUBLE, &m_PendingSeekPosition);
-          m_PendingSeekPosition = -1.0;
-        }
-      } else if (event->event_id == MPV_EVENT_PROPERTY_CHANGE) {
-        mpv_event_property* prop = (mpv_event_property*) event->data;
-        if (prop->data == nullptr)
-          continue;
-
-        std::string name = prop->name;
-        if (name == "time-pos" && prop->format == MPV_FORMAT_DOUBLE) {
-          m_CurrentTime = *(double*) prop->data;
-        } else if (name == "duration" && prop->format == MPV_FORMAT_DOUBLE) {
-          m_Duration = *(double*) prop->data;
-        } else if (name == "pause" && prop->format == MPV_FORMAT_FLAG) {
-          m_IsPlaying = !(*(int*) prop->data);
-        } else if (name == "width" && prop->format == MPV_FORMAT_INT64) {
-          m_VideoWidth = (int) *(int64_t*) prop->data;
-          AF_INFO("Video width changed: {}", m_VideoWidth);
-        } else if (name == "height" && prop->format == MPV_FORMAT_INT64) {
-          m_VideoHeight = (int) *(int64_t*) prop->data;
-          AF_INFO("Video height changed: {}", m_VideoHeight);
-        }
-      } else if (event->event_id == MPV_EVENT_LOG_MESSAGE) {
-        mpv_event_log_message* msg = (mpv_event_log_message*) event->data;
-        AF_DEBUG("MPV: [{}] {}", msg->prefix, msg->text);
-      } else if (event->event_id == MPV_EVENT_START_FILE) {
-        AF_INFO("MPV: Start file");
-      } else if (event->event_id == MPV_EVENT_END_FILE) {
-        AF_INFO("MPV: End file");
+    const Video::PlaybackState& state = m_Driver->GetState();
+    m_CurrentTime = state.timePos;
+    m_Duration = state.duration;
+    m_FrameRate = state.frameRate;
+    m_IsPlaying = !state.paused;
+    m_FileLoadedSuccessfully = state.fileLoaded;
+    m_VideoWidth = state.videoWidth;
+    m_VideoHeight = state.videoHeight;
+    m_Subtitle.text = state.subText;
+    m_Subtitle.start = state.subStart;
+    m_Subtitle.end = state.subEnd;
+    m_SubtitleTrackIndex = state.subTrackIndex;
+    m_SubtitleTrackFile = state.subTrackFile;
+
+    if ((m_VideoWidth <= 0 || m_VideoHeight <= 0) && m_VideoTexture) {
+      SDL_DestroyTexture(m_VideoTexture);
+      m_VideoTexture = nullptr;
+      m_TextureWidth = 0;
+      m_TextureHeight = 0;
+    }
+  }
+
+  void VideoSection::UpdateSubtitleIndex()
+  {
+    std::string track;
+    std::string trackFile = m_SubtitleTrackFile.empty() ? m_CurrentVideoPath : m_SubtitleTrackFile;
+    if (m_FileLoadedSuccessfully && !m_CurrentVideoPath.empty() && m_SubtitleTrackIndex >= 0) {
+      track = std::format("{}#{}", trackFile, m_SubtitleTrackIndex);
+    }
+
+    // The old index is wrong as soon as another track is selected, lines come from mpv until the new one is built
+    if (track != m_SubtitleIndexTrack) {
+      m_SubtitleIndex.reset();
+      m_SubtitleIndexTrack.clear();
+    }
+
+    if (m_PendingSubtitleIndex.valid()) {
+      if (m_PendingSubtitleIndex.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+      auto index = m_PendingSubtitleIndex.get();
+      if (m_PendingSubtitleIndexTrack == track) {
+        m_SubtitleIndex = std::move(index);
+        m_SubtitleIndexTrack = track;
       }
     }
+
+    if (track.empty() || track == m_SubtitleIndexTrack)
+      return;
+
+    // Reading a subtitle track embedded in a video means demuxing the whole file, keep it off the UI thread
+    m_PendingSubtitleIndexTrack = track;
+    m_PendingSubtitleIndex = std::async(std::launch::async, [trackFile, streamIndex = m_SubtitleTrackIndex]() {
+      return std::make_shared<const Video::SubtitleIndex>(Video::SubtitleIndex::Load(trackFile, streamIndex));
+    });
   }
 
   void VideoSection::UpdateVideoTexture()
   {
-    if (!m_mpv_render)
+    if (!m_Driver)
       return;
 
     if (m_VideoWidth <= 0 || m_VideoHeight <= 0)
       return;
 
-    // Check if we need to resize texture
-    bool textureNeedsUpdate = false;
-    if (!m_VideoTexture) {
-      textureNeedsUpdate = true;
-    } else {
-      float w = 0, h = 0;
-      SDL_GetTextureSize(m_VideoTexture, &w, &h);
-      if ((int) w != m_VideoWidth || (int) h != m_VideoHeight) {
-        textureNeedsUpdate = true;
+    // Tell the driver which size to render at. Small changes keep the current size (see ShouldChangeRenderSize)
+    int targetWidth = 0;
+    int targetHeight = 0;
+    ComputeTextureSize(targetWidth, targetHeight);
+
+    if (targetWidth != m_RenderWidth || targetHeight != m_RenderHeight) {
+      if (ShouldChangeRenderSize(targetWidth, targetHeight)) {
+        m_Driver->SetRenderSize(targetWidth, targetHeight);
+        m_RenderWidth = targetWidth;
+        m_RenderHeight = targetHeight;
+        m_PendingTextureWidth = 0;
+        m_PendingTextureHeight = 0;
       }
+    } else {
+      m_PendingTextureWidth = 0;
+      m_PendingTextureHeight = 0;
     }
 
-    if (textureNeedsUpdate) {
-      AF_INFO("Recreating video texture: {}x{}", m_VideoWidth, m_VideoHeight);
+    // Frames are rendered on the driver thread, the UI only uploads the newest finished one
+    if (!m_Driver->ConsumeFrame())
+      return;
+
+    const Video::VideoFrame& frame = m_Driver->GetFrame();
+    if (frame.pixels.empty())
+      return;
+
+    if (!m_VideoTexture || frame.width != m_TextureWidth || frame.height != m_TextureHeight) {
       if (m_VideoTexture)
         SDL_DestroyTexture(m_VideoTexture);
+
+      AF_INFO("Recreating video texture: {}x{} ({}), video is {}x{}",
+              frame.width,
+              frame.height,
+              m_PixelFormat.mpvFormat,
+              m_VideoWidth,
+              m_VideoHeight);
       m_VideoTexture = SDL_CreateTexture(
-          m_Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, m_VideoWidth, m_VideoHeight);
+          m_Renderer, m_PixelFormat.sdlFormat, SDL_TEXTUREACCESS_STREAMING, frame.width, frame.height);
 
       if (!m_VideoTexture) {
         AF_ERROR("Failed to create video texture: {}", SDL_GetError());
+        m_TextureWidth = 0;
+        m_TextureHeight = 0;
         return;
       }
-      m_FrameBuffer.resize(m_VideoWidth * m_VideoHeight * 4);
+      SDL_SetTextureScaleMode(m_VideoTexture, SDL_SCALEMODE_LINEAR);
+
+      m_TextureWidth = frame.width;
+      m_TextureHeight = frame.height;
     }
 
-    // Render frame
-    int stride = m_VideoWidth * 4;
+    // The frame already has the texture's memory layout, so this is a plain copy
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (!SDL_LockTexture(m_VideoTexture, nullptr, &pixels, &pitch)) {
+      AF_ERROR("Failed to lock video texture: {}", SDL_GetError());
+      return;
+    }
 
-    // We actually need to provide the buffer to SW render
-    // But mpv_render_context_render for SW expects an array of pointers to planes
-    // and strides.
+    size_t rowBytes = static_cast<size_t>(frame.width) * 4;
+    if (static_cast<size_t>(pitch) == frame.stride) {
+      std::memcpy(pixels, frame.pixels.data(), frame.stride * frame.height);
+    } else {
+      auto* dst = static_cast<uint8_t*>(pixels);
+      for (int y = 0; y < frame.height; ++y) {
+        std::memcpy(dst + static_cast<size_t>(y) * pitch, frame.pixels.data() + y * frame.stride, rowBytes);
+      }
+    }
+    SDL_UnlockTexture(m_VideoTexture);
+  }
 
-    uint8_t* data = m_FrameBuffer.data();
-    mpv_render_frame_info frame_info = {0};
-    frame_info.flags = 0;
+  void VideoSection::ComputeTextureSize(int& width, int& height) const
+  {
+    width = m_VideoWidth;
+    height = m_VideoHeight;
 
-    // For SW render, we use a different approach or just use the raw pointer
-    // The MPV API for SW render is a bit specific.
-    // We need to pass the buffer in params.
+    if (!m_ConfigManager || !m_ConfigManager->GetConfig().VideoRenderAtDisplayResolution)
+      return;
 
-    int size[2] = {m_VideoWidth, m_VideoHeight};
-    const char* format = "rgba";
+    if (m_PanelPixelWidth <= 0 || m_PanelPixelHeight <= 0)
+      return;
 
-    mpv_render_param sw_params[] = {{MPV_RENDER_PARAM_SW_SIZE, size},
-                                    {MPV_RENDER_PARAM_SW_FORMAT, (void*) format},
-                                    {MPV_RENDER_PARAM_SW_STRIDE, &stride},
-                                    {MPV_RENDER_PARAM_SW_POINTER, data},
-                                    {MPV_RENDER_PARAM_INVALID, nullptr}};
+    // Fit the video into the panel while keeping its aspect ratio, never upscaling past the native size
+    float scale =
+        std::min({(float) m_PanelPixelWidth / m_VideoWidth, (float) m_PanelPixelHeight / m_VideoHeight, 1.0f});
+    width = std::max(1, (int) std::lround(m_VideoWidth * scale));
+    height = std::max(1, (int) std::lround(m_VideoHeight * scale));
+  }
 
-    // Only update if necessary? mpv_render_context_update tells us.
-    // But for simplicity in this loop, we can try to render.
-    // mpv_render_context_update returns flags indicating if redraw is needed.
+  bool VideoSection::ShouldChangeRenderSize(int targetWidth, int targetHeight)
+  {
+    if (m_RenderWidth <= 0 || m_RenderHeight <= 0)
+      return true;
 
-    uint64_t flags = mpv_render_context_update(m_mpv_render);
-    if (flags & MPV_RENDER_UPDATE_FRAME) {
-      int res = mpv_render_context_render(m_mpv_render, sw_params);
-      if (res >= 0) {
-        SDL_UpdateTexture(m_VideoTexture, nullptr, m_FrameBuffer.data(), stride);
-      }
+    // An aspect ratio change means a different video, which has to be picked up right away
+    float renderAspect = (float) m_RenderWidth / m_RenderHeight;
+    float targetAspect = (float) targetWidth / targetHeight;
+    if (std::abs(renderAspect - targetAspect) > 0.02f * targetAspect)
+      return true;
+
+    // Within the hysteresis band the current size is close enough, the GPU scales the difference away
+    float ratio = (float) targetWidth / m_RenderWidth;
+    if (std::abs(ratio - 1.0f) < RESIZE_HYSTERESIS) {
+      m_PendingTextureWidth = 0;
+      m_PendingTextureHeight = 0;
+      return false;
     }
+
+    // Outside the band, wait for the size to settle so dragging a splitter recreates the texture only once
+    uint64_t now = SDL_GetTicks();
+    if (targetWidth != m_PendingTextureWidth || targetHeight != m_PendingTextureHeight) {
+      m_PendingTextureWidth = targetWidth;
+      m_PendingTextureHeight = targetHeight;
+      m_PendingTextureSince = now;
+      return false;
+    }
+
+    return now - m_PendingTextureSince >= RESIZE_SETTLE_MS;
   }
 
   void VideoSection::Render()
@@ -339,6 +421,25 @@ namespace Video2Card::UI
     ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.0f, 0.0f, 0.0f, 1.0f));
     ImGui::BeginChild("VideoArea", videoAreaSize, true);
 
+    // Remember the panel size in framebuffer pixels so the next frame can be rendered to fit it
+    ImVec2 framebufferScale = ImGui::GetIO().DisplayFramebufferScale;
+    m_PanelPixelWidth = (int) (ImGui::GetContentRegionAvail().x * framebufferScale.x);
+    m_PanelPixelHeight = (int) (ImGui::GetContentRegionAvail().y * framebufferScale.y);
+
+    if (m_ConfigManager && ImGui::BeginPopupContextWindow("VideoAreaContext")) {
+      if (ImGui::MenuItem(
+              "Render at panel resolution", nullptr, &m_ConfigManager->GetConfig().VideoRenderAtDisplayResolution))
+      {
+        m_ConfigManager->Save();
+      }
+      if (ImGui::MenuItem(
+              "Prepare current line for Extract", nullptr, &m_ConfigManager->GetConfig().PrefetchExtraction))
+      {
+        m_ConfigManager->Save();
+      }
+      ImGui::EndPopup();
+    }
+
     if (m_VideoTexture) {
       // Maintain aspect ratio
       float availWidth = ImGui::GetContentRegionAvail().x;
@@ -404,6 +505,12 @@ namespace Video2Card::UI
       if (ImGui::IsKeyPressed(ImGuiKey_LeftArrow)) {
         Seek(-5.0);
       }
+      if (ImGui::IsKeyPressed(ImGuiKey_DownArrow)) {
+        SeekToNextSubtitle();
+      }
+      if (ImGui::IsKeyPressed(ImGuiKey_UpArrow)) {
+        SeekToPreviousSubtitle();
+      }
       if (ImGui::IsKeyPressed(ImGuiKey_M)) {
         if (m_OnExtractCallback)
           m_OnExtractCallback();
@@ -509,6 +616,8 @@ namespace Video2Card::UI
     std::string secondsStr = std::to_string(seconds);
     const char* cmd[] = {"seek", secondsStr.c_str(), "relative", nullptr};
     mpv_command_async(m_mpv, 0, cmd);
+    if (m_OnSeekCallback)
+      m_OnSeekCallback();
   }
 
   void VideoSection::SeekAbsolute(double timestamp)
@@ -518,82 +627,84 @@ namespace Video2Card::UI
     std::string timestampStr = std::to_string(timestamp);
     const char* cmd[] = {"seek", timestampStr.c_str(), "absolute", nullptr};
     mpv_command_async(m_mpv, 0, cmd);
+    if (m_OnSeekCallback)
+      m_OnSeekCallback();
   }
 
-  std::vector<unsigned char> VideoSection::GetCurrentFrameImage()
+  void VideoSection::SeekToNextSubtitle()
   {
-    if (m_FrameBuffer.empty() || m_VideoWidth <= 0 || m_VideoHeight <= 0) {
-      return {};
-    }
-
-    // Calculate new dimensions (max 320x320)
-    int newWidth = m_VideoWidth;
-    int newHeight = m_VideoHeight;
+    if (!m_mpv)
+      return;
 
-    if (newWidth > 320 || newHeight > 320) {
-      float scale = std::min(320.0f / newWidth, 320.0f / newHeight);
-      newWidth = (int) (newWidth * scale);
-      newHeight = (int) (newHeight * scale);
+    if (m_SubtitleIndex && !m_SubtitleIndex->IsEmpty()) {
+      if (const Video::SubtitleCue* cue = m_SubtitleIndex->FindNext(m_CurrentTime))
+        SeekAbsolute(cue->start);
+      return;
     }
 
-    // Scale using libswscale
-    struct SwsContext* sws_ctx = sws_getContext(m_VideoWidth,
-                                                m_VideoHeight,
-                                                AV_PIX_FMT_RGBA,
-                                                newWidth,
-                                                newHeight,
-                                                AV_PIX_FMT_RGBA,
-                                                SWS_BILINEAR,
-                                                nullptr,
-                                                nullptr,
-                                                nullptr);
-
-    if (!sws_ctx) {
-      AF_ERROR("Failed to create sws context for image resizing");
-      return {};
-    }
+    // Without an index (bitmap subtitles, or still being built) mpv knows the lines it has read so far
+    const char* cmd[] = {"sub-seek", "1", nullptr};
+    mpv_command_async(m_mpv, 0, cmd);
+    if (m_OnSeekCallback)
+      m_OnSeekCallback();
+  }
 
-    std::vector<uint8_t> scaledBuffer(newWidth * newHeight * 4);
-    uint8_t* srcSlice[] = {m_FrameBuffer.data()};
-    int srcStride[] = {m_VideoWidth * 4};
-    uint8_t* dstSlice[] = {scaledBuffer.data()};
-    int dstStride[] = {newWidth * 4};
+  void VideoSection::SeekToPreviousSubtitle()
+  {
+    if (!m_mpv)
+      return;
 
-    sws_scale(sws_ctx, srcSlice, srcStride, 0, m_VideoHeight, dstSlice, dstStride);
-    sws_freeContext(sws_ctx);
+    if (m_SubtitleIndex && !m_SubtitleIndex->IsEmpty()) {
+      if (const Video::SubtitleCue* cue = m_SubtitleIndex->FindPrevious(m_CurrentTime))
+        SeekAbsolute(cue->start);
+      return;
+    }
 
-    // Encode to WebP
-    uint8_t* output;
-    size_t size = WebPEncodeRGBA(scaledBuffer.data(), newWidth, newHeight, newWidth * 4, 90.0f, &output);
+    const char* cmd[] = {"sub-seek", "-1", nullptr};
+    mpv_command_async(m_mpv, 0, cmd);
+    if (m_OnSeekCallback)
+      m_OnSeekCallback();
+  }
 
-    if (size > 0) {
-      std::vector<unsigned char> result(output, output + size);
-      WebPFree(output);
-      return result;
+  std::future<Utils::RawImage> VideoSection::RequestFrameImage(double timestamp, std::stop_token cancel)
+  {
+    if (!m_SnapshotService || m_CurrentVideoPath.empty()) {
+      std::promise<Utils::RawImage> empty;
+      empty.set_value({});
+      return empty.get_future();
     }
 
-    return {};
+    return m_SnapshotService->RequestSnapshot(timestamp, 320, 320, std::move(cancel));
   }
 
-  SubtitleData VideoSection::GetCurrentSubtitle()
+  SubtitleData VideoSection::ToSubtitleData(const Video::SubtitleCue* cue) const
   {
     SubtitleData data;
-    if (!m_mpv)
-      return data;
+    if (cue) {
+      double offsetSec = m_SubtitleOffsetMs / 1000.0;
+      data.text = cue->text;
+      data.start = cue->start + offsetSec;
+      data.end = cue->end + offsetSec;
+      data.timed = true;
+    }
+    return data;
+  }
 
-    char* text = nullptr;
-    mpv_get_property(m_mpv, "sub-text", MPV_FORMAT_STRING, &text);
-    if (text) {
-      data.text = text;
-      mpv_free(text);
+  SubtitleData VideoSection::GetCurrentSubtitle()
+  {
+    if (m_SubtitleIndex && !m_SubtitleIndex->IsEmpty()) {
+      return ToSubtitleData(m_SubtitleIndex->FindAt(m_CurrentTime));
     }
 
-    mpv_get_property(m_mpv, "sub-start", MPV_FORMAT_DOUBLE, &data.start);
-    mpv_get_property(m_mpv, "sub-end", MPV_FORMAT_DOUBLE, &data.end);
+    // Observed by the driver, so this never waits on mpv
+    SubtitleData data = m_Subtitle;
 
     if (data.start == 0.0 && data.end == 0.0 && !data.text.empty()) {
       data.start = m_CurrentTime;
       data.end = m_CurrentTime + 2.0;
+    } else if (!data.text.empty()) {
+      // Text and timing arrive as separate property changes, only trust them once they agree with the position
+      data.timed = data.end > data.start && m_CurrentTime >= data.start - 0.1 && m_CurrentTime <= data.end + 0.1;
     }
 
     double offsetSec = m_SubtitleOffsetMs / 1000.0;
@@ -603,294 +714,51 @@ namespace Video2Card::UI
     return data;
   }
 
-  double VideoSection::GetCurrentTimestamp()
+  SubtitleData VideoSection::GetNextSubtitle()
   {
-    return m_CurrentTime;
+    if (!m_SubtitleIndex)
+      return {};
+    return ToSubtitleData(m_SubtitleIndex->FindNext(m_CurrentTime));
   }
 
-  // Audio Extraction using FFmpeg
-  struct IOContext
+  std::vector<SubtitleData> VideoSection::GetAllSubtitles() const
   {
-    std::vector<uint8_t> buffer;
-    int pos = 0;
-  };
+    std::vector<SubtitleData> subtitles;
+    if (!m_SubtitleIndex)
+      return subtitles;
 
-  static int write_packet(void* opaque, const uint8_t* buf, int buf_size)
-  {
-    IOContext* ctx = (IOContext*) opaque;
-    ctx->buffer.insert(ctx->buffer.end(), buf, buf + buf_size);
-    ctx->pos += buf_size;
-    return buf_size;
+    subtitles.reserve(m_SubtitleIndex->GetSize());
+    for (const auto& cue : m_SubtitleIndex->GetCues()) {
+      subtitles.push_back(ToSubtitleData(&cue));
+    }
+    return subtitles;
   }
 
-  std::vector<unsigned char> VideoSection::GetAudioClip(double start, double end)
+  double VideoSection::GetCurrentTimestamp()
   {
-    if (m_CurrentVideoPath.empty())
-      return {};
-
-    AF_INFO("Extracting audio from {} to {}", start, end);
-
-    av_log_set_level(AV_LOG_QUIET);
-
-    AVFormatContext* inputFormatContext = nullptr;
-    if (avformat_open_input(&inputFormatContext, m_CurrentVideoPath.c_str(), nullptr, nullptr) < 0) {
-      AF_ERROR("Failed to open input file for audio extraction");
-      return {};
-    }
-
-    if (avformat_find_stream_info(inputFormatContext, nullptr) < 0) {
-      AF_ERROR("Failed to find stream info");
-      avformat_close_input(&inputFormatContext);
-      return {};
-    }
-
-    int audioStreamIndex = -1;
-    for (unsigned int i = 0; i < inputFormatContext->nb_streams; i++) {
-      if (inputFormatContext->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-        audioStreamIndex = i;
-        break;
-      }
-    }
-
-    if (audioStreamIndex == -1) {
-      AF_ERROR("No audio stream found");
-      avformat_close_input(&inputFormatContext);
-      return {};
-    }
-
-    // Transcode to OGG/Vorbis
-
-    // --- Setup Input Decoder ---
-    AVCodecParameters* inCodecPar = inputFormatContext->streams[audioStreamIndex]->codecpar;
-    const AVCodec* inCodec = avcodec_find_decoder(inCodecPar->codec_id);
-    AVCodecContext* inCodecCtx = avcodec_alloc_context3(inCodec);
-    avcodec_parameters_to_context(inCodecCtx, inCodecPar);
-    if (avcodec_open2(inCodecCtx, inCodec, nullptr) < 0) {
-      AF_ERROR("Failed to open input codec");
-      avcodec_free_context(&inCodecCtx);
-      avformat_close_input(&inputFormatContext);
-      return {};
-    }
-
-    // --- Setup Output (OGG/Vorbis) ---
-    IOContext ioCtx;
-    const int avio_buffer_size = 4096;
-    unsigned char* avio_buffer = (unsigned char*) av_malloc(avio_buffer_size);
-    AVIOContext* avioContext =
-        avio_alloc_context(avio_buffer, avio_buffer_size, 1, &ioCtx, nullptr, write_packet, nullptr);
-
-    AVFormatContext* outputFormatContext = nullptr;
-    avformat_alloc_output_context2(&outputFormatContext, nullptr, "ogg", nullptr);
-    outputFormatContext->pb = avioContext;
-
-    const AVCodec* outCodec = avcodec_find_encoder(AV_CODEC_ID_VORBIS);
-    AVStream* outStream = avformat_new_stream(outputFormatContext, outCodec);
-    AVCodecContext* outCodecCtx = avcodec_alloc_context3(outCodec);
-
-    // Configure output audio parameters
-    outCodecCtx->sample_rate = 44100;
-    av_channel_layout_default(&outCodecCtx->ch_layout, 2);
-    outCodecCtx->sample_fmt = AV_SAMPLE_FMT_FLTP;
-    outCodecCtx->time_base = (AVRational) {1, outCodecCtx->sample_rate};
-    outCodecCtx->bit_rate = 128000;
-
-    if (avcodec_open2(outCodecCtx, outCodec, nullptr) < 0) {
-      AF_ERROR("Failed to open output codec");
-      avcodec_free_context(&inCodecCtx);
-      avcodec_free_context(&outCodecCtx);
-      avformat_close_input(&inputFormatContext);
-      avformat_free_context(outputFormatContext);
-      av_free(avioContext->buffer);
-      av_free(avioContext);
-      return {};
-    }
-    avcodec_parameters_from_context(outStream->codecpar, outCodecCtx);
+    return m_CurrentTime;
+  }
 
-    if (avformat_write_header(outputFormatContext, nullptr) < 0) {
-      AF_ERROR("Failed to write header");
-      avcodec_free_context(&inCodecCtx);
-      avcodec_free_context(&outCodecCtx);
-      avformat_close_input(&inputFormatContext);
-      avformat_free_context(outputFormatContext);
-      av_free(avioContext->buffer);
-      av_free(avioContext);
-      return {};
+  std::future<Audio::AudioClip> VideoSection::RequestAudioClip(double start, double end, std::stop_token cancel)
+  {
+    if (!m_AudioSession || m_CurrentVideoPath.empty()) {
+      std::promise<Audio::AudioClip> empty;
+      empty.set_value({});
+      return empty.get_future();
     }
 
-    // --- Setup FIFO ---
-    AVAudioFifo* fifo = av_audio_fifo_alloc(outCodecCtx->sample_fmt, outCodecCtx->ch_layout.nb_channels, 1);
-
-    // --- Setup Resampler ---
-    SwrContext* swrCtx = nullptr;
-    // Defer initialization to first frame
-
-    // --- Processing Loop ---
-
-    // Seek
-    int64_t seekTarget = (int64_t) (start * AV_TIME_BASE);
-    av_seek_frame(inputFormatContext, -1, seekTarget, AVSEEK_FLAG_BACKWARD);
-
-    AVPacket* packet = av_packet_alloc();
-    AVFrame* frame = av_frame_alloc();
-    AVFrame* resampledFrame = av_frame_alloc(); // Frame to hold resampler output
-    AVFrame* fifoFrame = av_frame_alloc();      // Frame to hold fixed-size chunks for encoder
-
-    // Prepare fifoFrame (fixed size for encoder)
-    fifoFrame->nb_samples = outCodecCtx->frame_size;
-    fifoFrame->format = outCodecCtx->sample_fmt;
-    av_channel_layout_copy(&fifoFrame->ch_layout, &outCodecCtx->ch_layout);
-    fifoFrame->sample_rate = outCodecCtx->sample_rate;
-    av_frame_get_buffer(fifoFrame, 0);
-
-    // Prepare resampledFrame (variable size)
-    resampledFrame->format = outCodecCtx->sample_fmt;
-    av_channel_layout_copy(&resampledFrame->ch_layout, &outCodecCtx->ch_layout);
-    resampledFrame->sample_rate = outCodecCtx->sample_rate;
-
-    bool finished = false;
-    int framesProcessed = 0;
-    int64_t pts = 0; // Track PTS manually for output
-
-    while (av_read_frame(inputFormatContext, packet) >= 0 && !finished) {
-      if (packet->stream_index == audioStreamIndex) {
-        if (avcodec_send_packet(inCodecCtx, packet) == 0) {
-          while (avcodec_receive_frame(inCodecCtx, frame) == 0) {
-            double currentTimestamp = frame->pts * av_q2d(inputFormatContext->streams[audioStreamIndex]->time_base);
-
-            if (!swrCtx) {
-              swr_alloc_set_opts2(&swrCtx,
-                                  &outCodecCtx->ch_layout,
-                                  outCodecCtx->sample_fmt,
-                                  outCodecCtx->sample_rate,
-                                  &frame->ch_layout,
-                                  (enum AVSampleFormat) frame->format,
-                                  frame->sample_rate,
-                                  0,
-                                  nullptr);
-              swr_init(swrCtx);
-            }
-
-            if (currentTimestamp > end) {
-              AF_INFO("Reached end time: {} > {}", currentTimestamp, end);
-              finished = true;
-              break;
-            }
+    return m_AudioSession->RequestClip(start, end, GetAudioClipOptions(), std::move(cancel));
+  }
 
-            if (currentTimestamp + (double) frame->nb_samples / frame->sample_rate >= start) {
-              framesProcessed++;
-
-              // Calculate output samples
-              int out_samples = av_rescale_rnd(swr_get_delay(swrCtx, frame->sample_rate) + frame->nb_samples,
-                                               outCodecCtx->sample_rate,
-                                               frame->sample_rate,
-                                               AV_ROUND_UP);
-
-              if (resampledFrame->nb_samples < out_samples) {
-                av_frame_unref(resampledFrame);
-                resampledFrame->nb_samples = out_samples;
-                resampledFrame->format = outCodecCtx->sample_fmt;
-                av_channel_layout_copy(&resampledFrame->ch_layout, &outCodecCtx->ch_layout);
-                resampledFrame->sample_rate = outCodecCtx->sample_rate;
-                av_frame_get_buffer(resampledFrame, 0);
-              }
-
-              // Resample
-              int ret = swr_convert(
-                  swrCtx, resampledFrame->data, out_samples, (const uint8_t**) frame->data, frame->nb_samples);
-              if (ret > 0) {
-                // Add to FIFO
-                if (av_audio_fifo_realloc(fifo, av_audio_fifo_size(fifo) + ret) < 0) {
-                  AF_ERROR("Failed to realloc FIFO");
-                  break;
-                }
-                av_audio_fifo_write(fifo, (void**) resampledFrame->data, ret);
-
-                // Process FIFO
-                while (av_audio_fifo_size(fifo) >= outCodecCtx->frame_size) {
-                  // Read from FIFO
-                  if (av_audio_fifo_read(fifo, (void**) fifoFrame->data, outCodecCtx->frame_size) <
-                      outCodecCtx->frame_size)
-                  {
-                    break;
-                  }
-
-                  fifoFrame->pts = pts;
-                  pts += fifoFrame->nb_samples;
-
-                  if (avcodec_send_frame(outCodecCtx, fifoFrame) == 0) {
-                    AVPacket* outPacket = av_packet_alloc();
-                    while (avcodec_receive_packet(outCodecCtx, outPacket) == 0) {
-                      outPacket->stream_index = 0;
-                      av_packet_rescale_ts(outPacket, outCodecCtx->time_base, outStream->time_base);
-                      av_interleaved_write_frame(outputFormatContext, outPacket);
-                      AF_DEBUG("Wrote audio packet, size: {}", outPacket->size);
-                      av_packet_unref(outPacket);
-                    }
-                    av_packet_free(&outPacket);
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
-      av_packet_unref(packet);
-    }
-
-    AF_INFO("Processed {} audio frames from input", framesProcessed);
-
-    // Flush remaining samples in FIFO
-    int remaining = av_audio_fifo_size(fifo);
-    if (remaining > 0) {
-      AF_INFO("Flushing remaining {} samples from FIFO", remaining);
-      if (av_audio_fifo_read(fifo, (void**) fifoFrame->data, remaining) == remaining) {
-        fifoFrame->nb_samples = remaining;
-        fifoFrame->pts = pts;
-
-        if (avcodec_send_frame(outCodecCtx, fifoFrame) == 0) {
-          AVPacket* outPacket = av_packet_alloc();
-          while (avcodec_receive_packet(outCodecCtx, outPacket) == 0) {
-            outPacket->stream_index = 0;
-            av_packet_rescale_ts(outPacket, outCodecCtx->time_base, outStream->time_base);
-            av_interleaved_write_frame(outputFormatContext, outPacket);
-            av_packet_unref(outPacket);
-          }
-          av_packet_free(&outPacket);
-        }
-      }
+  Audio::AudioClipOptions VideoSection::GetAudioClipOptions() const
+  {
+    Audio::AudioClipOptions options;
+    if (m_ConfigManager) {
+      options.streamCopy = m_ConfigManager->GetConfig().AudioStreamCopy;
+      options.sampleAccurate = m_ConfigManager->GetConfig().AudioSampleAccurate;
+      options.encoderProfile = m_ConfigManager->GetConfig().AudioEncoderProfile;
     }
-
-    // Flush encoder
-    AF_INFO("Flushing audio encoder...");
-    avcodec_send_frame(outCodecCtx, nullptr);
-    AVPacket* outPacket = av_packet_alloc();
-    while (avcodec_receive_packet(outCodecCtx, outPacket) == 0) {
-      outPacket->stream_index = 0;
-      av_packet_rescale_ts(outPacket, outCodecCtx->time_base, outStream->time_base);
-      av_interleaved_write_frame(outputFormatContext, outPacket);
-      AF_DEBUG("Wrote flushed audio packet, size: {}", outPacket->size);
-      av_packet_unref(outPacket);
-    }
-    av_packet_free(&outPacket);
-
-    av_write_trailer(outputFormatContext);
-
-    // Cleanup
-    av_packet_free(&packet);
-    av_frame_free(&frame);
-    av_frame_free(&resampledFrame);
-    av_frame_free(&fifoFrame);
-    av_audio_fifo_free(fifo);
-    swr_free(&swrCtx);
-    avcodec_free_context(&inCodecCtx);
-    avcodec_free_context(&outCodecCtx);
-    avformat_close_input(&inputFormatContext);
-    avformat_free_context(outputFormatContext);
-    av_free(avioContext->buffer);
-    av_free(avioContext);
-
-    AF_INFO("Audio extraction finished, size: {}", ioCtx.buffer.size());
-    return ioCtx.buffer;
+    return options;
   }
 
 } // namespace Video2Card::UI
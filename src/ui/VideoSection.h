@@ -1,16 +1,21 @@
 #pragma once
 
+#include <SDL3/SDL_pixels.h>
+
 #include <imgui.h>
 
 #include <functional>
+#include <future>
 #include <memory>
 #include <mpv/client.h>
-#include <mpv/render.h>
 #include <mutex>
+#include <stop_token>
 #include <string>
 #include <vector>
 
+#include "audio/AudioClip.h"
 #include "ui/UIComponent.h"
+#include "utils/RawImage.h"
 #include "utils/VideoState.h"
 
 struct SDL_Texture;
@@ -26,6 +31,19 @@ namespace Video2Card::Language
   class ILanguage;
 }
 
+namespace Video2Card::Video
+{
+  class MpvDriver;
+  class SnapshotService;
+  class SubtitleIndex;
+  struct SubtitleCue;
+} // namespace Video2Card::Video
+
+namespace Video2Card::Audio
+{
+  class AudioExtractionSession;
+}
+
 namespace Video2Card::UI
 {
 
@@ -34,6 +52,14 @@ namespace Video2Card::UI
     std::string text;
     double start = 0.0;
     double end = 0.0;
+    bool timed = false; // Timing comes from the subtitle track rather than the current position
+  };
+
+  // SDL texture format paired with the mpv SW render format that has the same memory layout
+  struct VideoPixelFormat
+  {
+    SDL_PixelFormat sdlFormat;
+    const char* mpvFormat;
   };
 
   class VideoSection : public UIComponent
@@ -50,6 +76,11 @@ public:
     void Update() override;
 
     void SetOnExtractCallback(std::function<void()> callback) { m_OnExtractCallback = callback; }
+    // Called after every seek requested from the UI
+    void SetOnSeekCallback(std::function<void()> callback) { m_OnSeekCallback = callback; }
+
+    // Called from the mpv driver thread when a new frame or playback state is ready
+    void SetOnFrameReadyCallback(std::function<void()> callback);
 
     void LoadVideoFromFile(const std::string& path);
     void ClearVideo();
@@ -58,12 +89,26 @@ public:
     void TogglePlayback();
     void Seek(double seconds); // Relative seek
     void SeekAbsolute(double timestamp);
+    void SeekToNextSubtitle();
+    void SeekToPreviousSubtitle();
 
     // Extraction
-    std::vector<unsigned char> GetCurrentFrameImage();
+    // Decodes the frame shown at the timestamp on a worker, returns it as uncompressed RGBA.
+    // A request with a stop token is a prefetch, it yields to the others and is skipped once stopped.
+    std::future<Utils::RawImage> RequestFrameImage(double timestamp, std::stop_token cancel = {});
     SubtitleData GetCurrentSubtitle();
-    std::vector<unsigned char> GetAudioClip(double start, double end);
+    // Line after the current one, empty text until the subtitle track has been indexed or after the last line
+    SubtitleData GetNextSubtitle();
+    // Every line of the subtitle track, empty until the track has been indexed
+    std::vector<SubtitleData> GetAllSubtitles() const;
+    // Extracts the audio between two timestamps on a worker, copied or re-encoded depending on the config
+    std::future<Audio::AudioClip> RequestAudioClip(double start, double end, std::stop_token cancel = {});
+    Audio::AudioClipOptions GetAudioClipOptions() const;
     double GetCurrentTimestamp();
+    const std::string& GetCurrentVideoPath() const { return m_CurrentVideoPath; }
+
+    bool IsPlaying() const { return m_IsPlaying && m_FileLoadedSuccessfully; }
+    double GetFrameRate() const { return m_FrameRate; }
 
     int GetSubtitleOffsetMs() const { return m_SubtitleOffsetMs; }
     void SetSubtitleOffsetMs(int offsetMs) { m_SubtitleOffsetMs = offsetMs; }
@@ -72,8 +117,12 @@ private:
 
     void InitializeMPV();
     void DestroyMPV();
-    void HandleMPVEvents();
+    void ApplyPlaybackState();
+    void UpdateSubtitleIndex();
+    SubtitleData ToSubtitleData(const Video::SubtitleCue* cue) const;
     void UpdateVideoTexture();
+    void ComputeTextureSize(int& width, int& height) const;
+    bool ShouldChangeRenderSize(int targetWidth, int targetHeight);
     void DrawControls();
 
     SDL_Renderer* m_Renderer;
@@ -81,32 +130,62 @@ private:
     std::vector<std::unique_ptr<Language::ILanguage>>* m_Languages;
     Language::ILanguage** m_ActiveLanguage;
 
-    mpv_handle* m_mpv = nullptr;
-    mpv_render_context* m_mpv_render = nullptr;
+    std::unique_ptr<Video::MpvDriver> m_Driver;
+    mpv_handle* m_mpv = nullptr; // Owned by m_Driver, used for commands and property access
+    std::unique_ptr<Video::SnapshotService> m_SnapshotService;
+    std::unique_ptr<Audio::AudioExtractionSession> m_AudioSession;
 
     SDL_Texture* m_VideoTexture = nullptr;
+    VideoPixelFormat m_PixelFormat = {SDL_PIXELFORMAT_RGBA32, "rgba"};
     int m_VideoWidth = 0;
     int m_VideoHeight = 0;
 
+    // The texture can be smaller than the video when rendering at the panel's display resolution
+    int m_TextureWidth = 0;
+    int m_TextureHeight = 0;
+    int m_RenderWidth = 0; // Size last requested from the driver
+    int m_RenderHeight = 0;
+
+    // Video area size in framebuffer pixels, measured during Render()
+    int m_PanelPixelWidth = 0;
+    int m_PanelPixelHeight = 0;
+
+    // Resize hysteresis: small size changes keep the current texture, larger ones must settle first
+    int m_PendingTextureWidth = 0;
+    int m_PendingTextureHeight = 0;
+    uint64_t m_PendingTextureSince = 0;
+    static constexpr float RESIZE_HYSTERESIS = 0.15f;
+    static constexpr uint64_t RESIZE_SETTLE_MS = 150;
+
     std::string m_CurrentVideoPath;
     bool m_IsPlaying = false;
     double m_Duration = 0.0;
+    double m_FrameRate = 0.0;
     double m_CurrentTime = 0.0;
     double m_Volume = 100.0;
 
     std::function<void()> m_OnExtractCallback;
-
-    // Buffer for software rendering from MPV
-    std::vector<uint8_t> m_FrameBuffer;
+    std::function<void()> m_OnSeekCallback;
 
     bool m_ShouldClearVideo = false;
     double m_LastSaveTime = 0.0;
     static constexpr double SAVE_INTERVAL = 1.0;
 
-    double m_PendingSeekPosition = -1.0;
     bool m_FileLoadedSuccessfully = false;
 
     int m_SubtitleOffsetMs = 0;
+    SubtitleData m_Subtitle; // As published by the driver, without the offset
+
+    // Selected subtitle track as published by the driver, see PlaybackState
+    int m_SubtitleTrackIndex = -1;
+    std::string m_SubtitleTrackFile;
+
+    // Index of the selected text subtitle track, built in the background whenever another track is selected.
+    // Tracks are identified as "file#stream".
+    std::shared_ptr<const Video::SubtitleIndex> m_SubtitleIndex;
+    std::string m_SubtitleIndexTrack;
+    std::future<std::shared_ptr<const Video::SubtitleIndex>> m_PendingSubtitleIndex;
+    std::string m_PendingSubtitleIndexTrack;
   };
 
 } // namespace Video2Card::UI
@@ -164,7 +164,16 @@ namespace Video2Card
           m_ImageTexture = nullptr;
         }
 
-        if (!m_BinaryData.empty()) {
+        if (!m_RawImage.IsEmpty()) {
+          // Already decoded, upload the pixels as they are
+          m_ImageTexture = SDL_CreateTexture(
+              renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, m_RawImage.width, m_RawImage.height);
+          if (m_ImageTexture) {
+            SDL_UpdateTexture(m_ImageTexture, nullptr, m_RawImage.pixels.data(), m_RawImage.stride);
+            m_ImageWidth = m_RawImage.width;
+            m_ImageHeight = m_RawImage.height;
+          }
+        } else if (!m_BinaryData.empty()) {
           int width{}, height{}, channels{};
           unsigned char* data = stbi_load_from_memory(
               m_BinaryData.data(), static_cast<int>(m_BinaryData.size()), &width, &height, &channels, 4);
@@ -239,6 +248,17 @@ namespace Video2Card
     void CardField::SetBinaryData(const std::vector<unsigned char>& data, const std::string& filename)
     {
       m_BinaryData = data;
+      m_RawImage = {};
+      m_Value = filename;
+      if (m_Type == CardFieldType::Image) {
+        m_TextureNeedsUpdate = true;
+      }
+    }
+
+    void CardField::SetRawImage(const Utils::RawImage& image, const std::string& filename)
+    {
+      m_RawImage = image;
+      m_BinaryData.clear();
       m_Value = filename;
       if (m_Type == CardFieldType::Image) {
         m_TextureNeedsUpdate = true;
@@ -256,6 +276,7 @@ namespace Video2Card
     {
       m_Value.clear();
       m_BinaryData.clear();
+      m_RawImage = {};
 
       if (m_ImageTexture) {
         SDL_DestroyTexture(m_ImageTexture);
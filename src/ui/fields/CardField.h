@@ -8,6 +8,7 @@
 
 #include "audio/AudioPlayer.h"
 #include "core/FieldTypes.h"
+#include "utils/RawImage.h"
 
 struct SDL_Renderer;
 struct SDL_Texture;
@@ -37,6 +38,7 @@ namespace Video2Card
       const std::string& GetName() const { return m_Name; }
       const std::string& GetValue() const { return m_Value; }
       const std::vector<unsigned char>& GetBinaryData() const { return m_BinaryData; }
+      const Utils::RawImage& GetRawImage() const { return m_RawImage; }
       CardFieldType GetType() const { return m_Type; }
 
       bool IsToolEnabled() const { return m_IsToolEnabled; }
@@ -45,6 +47,7 @@ namespace Video2Card
       // Setters
       void SetValue(const std::string& value);
       void SetBinaryData(const std::vector<unsigned char>& data, const std::string& filename);
+      void SetRawImage(const Utils::RawImage& image, const std::string& filename);
       void SetType(CardFieldType type);
 
       // Auto-fill configuration
@@ -70,6 +73,7 @@ namespace Video2Card
       // Content
       std::string m_Value;                     // Text content or Filename
       std::vector<unsigned char> m_BinaryData; // Audio or Image data
+      Utils::RawImage m_RawImage;              // Uncompressed image, encoded when the card is added
 
       // Image Preview
       SDL_Texture* m_ImageTexture = nullptr;
@@ -1,26 +1,70 @@
 #include "FileUtils.h"
 
-#include <SDL3/SDL.h>
-
 #include <cstdlib>
-#include <sys/stat.h>
+#include <filesystem>
+#include <system_error>
 
-#ifdef _WIN32
-#include <direct.h>
-#endif
+#include "core/Logger.h"
 
 namespace Video2Card::Utils
 {
+  namespace
+  {
+    constexpr const char* ORGANIZATION = "com.ankivideo2card";
+    constexpr const char* APPLICATION = "AnkiVideo2Card";
+
+    /**
+     * Per-user data directory of the platform, the one SDL_GetPrefPath() builds on
+     */
+    std::filesystem::path GetUserDataDirectory()
+    {
+#ifdef _WIN32
+      const wchar_t* appData = _wgetenv(L"APPDATA");
+      if (appData && *appData)
+        return std::filesystem::path(appData);
+#elif defined(__APPLE__)
+      const char* home = std::getenv("HOME");
+      if (home && *home)
+        return std::filesystem::path(home) / "Library" / "Application Support";
+#else
+      const char* dataHome = std::getenv("XDG_DATA_HOME");
+      if (dataHome && *dataHome)
+        return std::filesystem::path(dataHome);
+      const char* home = std::getenv("HOME");
+      if (home && *home)
+        return std::filesystem::path(home) / ".local" / "share";
+#endif
+      return {};
+    }
+
+    /**
+     * Create a directory and its parents
+     * @return The directory as UTF-8 with a trailing separator, empty if it could not be created
+     */
+    std::string EnsureDirectory(const std::filesystem::path& path)
+    {
+      if (path.empty())
+        return "";
+
+      std::error_code error;
+      std::filesystem::create_directories(path, error);
+      if (error) {
+        AF_ERROR("Failed to create directory {}: {}", path.string(), error.message());
+        return "";
+      }
+
+      std::u8string utf8 = (path / "").u8string();
+      return std::string(utf8.begin(), utf8.end());
+    }
+  } // namespace
+
   std::string FileUtils::GetPrefPath()
   {
-    char* prefPath = SDL_GetPrefPath("com.ankivideo2card", "AnkiVideo2Card");
-    if (!prefPath) {
+    std::filesystem::path base = GetUserDataDirectory();
+    if (base.empty())
       return "";
-    }
 
-    std::string result(prefPath);
-    SDL_free(prefPath);
-    return result;
+    return EnsureDirectory(base / ORGANIZATION / APPLICATION);
   }
 
   std::string FileUtils::GetConfigPath()
@@ -33,30 +77,19 @@ namespace Video2Card::Utils
 #ifdef __APPLE__
     // macOS: ~/Library/Caches/AnkiVideo2Card/
     const char* home = std::getenv("HOME");
-    if (home) {
-      std::string cachePath = std::string(home) + "/Library/Caches/AnkiVideo2Card/";
-      // Try to create directory (may fail silently if it exists)
-      mkdir(cachePath.c_str(), 0755);
-      return cachePath;
-    }
+    if (home && *home)
+      return EnsureDirectory(std::filesystem::path(home) / "Library" / "Caches" / APPLICATION);
 #elif defined(_WIN32)
-    // Windows: Use APPDATA/AnkiVideo2Card/Cache/
-    char* prefPath = SDL_GetPrefPath("com.ankivideo2card", "AnkiVideo2Card");
-    if (prefPath) {
-      std::string cachePath = std::string(prefPath) + "Cache/";
-      _mkdir(cachePath.c_str());
-      SDL_free(prefPath);
-      return cachePath;
-    }
+    // Windows: Cache/ in the preference directory
+    std::string prefPath = GetPrefPath();
+    if (!prefPath.empty())
+      return EnsureDirectory(std::filesystem::path(std::u8string(prefPath.begin(), prefPath.end())) / "Cache");
 #else
     // Linux: ~/.cache/AnkiVideo2Card/
     const char* home = std::getenv("HOME");
-    if (home) {
-      std::string cachePath = std::string(home) + "/.cache/AnkiVideo2Card/";
-      mkdir(cachePath.c_str(), 0755);
-      return cachePath;
-    }
+    if (home && *home)
+      return EnsureDirectory(std::filesystem::path(home) / ".cache" / APPLICATION);
 #endif
     return "";
   }
-} // namespace Video2Card::Utils
\ No newline at end of file
+} // namespace Video2Card::Utils
@@ -10,10 +10,11 @@ public:
 
     /**
      * Gets the platform-specific directory for storing application preferences/config files.
-     * Uses SDL_GetPrefPath internally.
-     * - macOS: ~/Library/Application Support/AnkiVideo2Card/
-     * - Windows: %APPDATA%/AnkiVideo2Card/
-     * - Linux: ~/.local/share/AnkiVideo2Card/
+     * Same layout as SDL_GetPrefPath, without depending on SDL so the headless tools find the same config.
+     * - macOS: ~/Library/Application Support/com.ankivideo2card/AnkiVideo2Card/
+     * - Windows: %APPDATA%/com.ankivideo2card/AnkiVideo2Card/
+     * - Linux: $XDG_DATA_HOME (or ~/.local/share)/com.ankivideo2card/AnkiVideo2Card/
+     * The directory is created if it does not exist.
      * 
      * @return The preference path as a string with trailing separator
      */
@@ -28,9 +29,8 @@ public:
 
     /**
      * Gets the platform-specific directory for storing cache/temporary files.
-     * Uses SDL_GetPrefPath internally with a "cache" subdirectory.
      * - macOS: ~/Library/Caches/AnkiVideo2Card/
-     * - Windows: %APPDATA%/AnkiVideo2Card/Cache/
+     * - Windows: %APPDATA%/com.ankivideo2card/AnkiVideo2Card/Cache/
      * - Linux: ~/.cache/AnkiVideo2Card/
      * 
      * @return The cache path as a string with trailing separator
@@ -1,27 +1,33 @@
 #include "utils/ImageProcessor.h"
 
-#include <SDL3/SDL.h>
-
 #include <algorithm>
-#include <cstring>
-#include <webp/encode.h>
-
-#include "stb_image.h"
-#include "stb_image_write.h"
+#include <chrono>
 
-#define STB_IMAGE_RESIZE_IMPLEMENTATION
 #include "core/Logger.h"
-#include "core/sdl/SDLWrappers.h"
-#include "stb_image_resize2.h"
+#include "utils/ImageScaler.h"
+
+// The core library carries the implementation, the GUI links it from here
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
 
 namespace Video2Card::Utils
 {
 
-  SDL_Surface* ImageProcessor::LoadImageFromBuffer(const std::vector<unsigned char>& imageBuffer)
+  namespace
+  {
+    ImageScaler& GetScaler()
+    {
+      // Card images get encoded from the UI thread and from background tasks
+      thread_local ImageScaler scaler;
+      return scaler;
+    }
+  } // namespace
+
+  RawImage ImageProcessor::LoadImageFromBuffer(const std::vector<unsigned char>& imageBuffer)
   {
     if (imageBuffer.empty()) {
       AF_ERROR("Image buffer is empty");
-      return nullptr;
+      return {};
     }
 
     int width{}, height{}, channels{};
@@ -29,27 +35,16 @@ namespace Video2Card::Utils
 
     if (!data) {
       AF_ERROR("Failed to load image from buffer: {}", stbi_failure_reason());
-      return nullptr;
-    }
-
-    // Create a duplicate surface that we own, since MakeSurfaceFrom doesn't own the pixel data
-    auto tempSurface = SDL::MakeSurfaceFrom(width, height, SDL_PIXELFORMAT_RGBA32, data, width * 4);
-    if (!tempSurface) {
-      AF_ERROR("Failed to create SDL surface: {}", SDL_GetError());
-      stbi_image_free(data);
-      return nullptr;
+      return {};
     }
 
-    // Duplicate the surface so we own the pixel data
-    SDL_Surface* surface = SDL_DuplicateSurface(tempSurface.get());
+    RawImage image;
+    image.width = width;
+    image.height = height;
+    image.stride = width * 4;
+    image.pixels.assign(data, data + image.SizeInBytes());
     stbi_image_free(data);
-
-    if (!surface) {
-      AF_ERROR("Failed to duplicate surface: {}", SDL_GetError());
-      return nullptr;
-    }
-
-    return surface;
+    return image;
   }
 
   void ImageProcessor::CalculateScaledDimensions(
@@ -73,108 +68,73 @@ namespace Video2Card::Utils
     outHeight = std::max(1, outHeight);
   }
 
-  std::vector<unsigned char> ImageProcessor::SurfaceToWebP(SDL_Surface* surface, int qualityPercent)
+  std::vector<unsigned char> ImageProcessor::EncodePixels(
+      const unsigned char* pixels, int width, int height, int stride, const WebPEncoderProfile& profile)
   {
-    if (!surface) {
-      AF_ERROR("Surface is null");
-      return {};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<unsigned char> result = WebPEncoder::Encode(pixels, width, height, stride, profile);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    if (!result.empty()) {
+      AF_INFO("Encoded WebP: {}x{}, size: {} bytes, profile: {}, {:.1f} ms",
+              width,
+              height,
+              result.size(),
+              profile.id,
+              elapsed.count());
     }
-
-    std::vector<unsigned char> result;
-
-    // Use WebP encoder - lossless RGBA encoding
-    uint8_t* output = nullptr;
-    size_t output_size = WebPEncodeLosslessRGBA(
-        static_cast<const uint8_t*>(surface->pixels), surface->w, surface->h, surface->pitch, &output);
-
-    if (output_size == 0) {
-      AF_ERROR("WebP encoding failed");
-      if (output)
-        free(output);
-      return {};
-    }
-
-    result.assign(output, output + output_size);
-    free(output);
-
-    AF_INFO("Encoded WebP: {}x{}, size: {} bytes, quality: {}", surface->w, surface->h, output_size, qualityPercent);
     return result;
   }
 
   std::vector<unsigned char> ImageProcessor::ScaleAndCompressToWebP(const std::vector<unsigned char>& imageBuffer,
                                                                     int maxWidth,
                                                                     int maxHeight,
-                                                                    int qualityPercent)
+                                                                    const WebPEncoderProfile& profile)
   {
-    if (imageBuffer.empty()) {
-      AF_ERROR("Image buffer is empty");
+    RawImage image = LoadImageFromBuffer(imageBuffer);
+    if (image.IsEmpty()) {
       return {};
     }
 
-    SDL_Surface* surface = LoadImageFromBuffer(imageBuffer);
-    if (!surface) {
-      return {};
-    }
-
-    // Check if scaling is needed
-    if (surface->w <= maxWidth && surface->h <= maxHeight) {
-      // No scaling needed, just compress
-      auto result = SurfaceToWebP(surface, qualityPercent);
-      SDL_DestroySurface(surface);
-      return result;
-    }
-
-    // Calculate new dimensions maintaining aspect ratio
-    int newWidth{}, newHeight{};
-    CalculateScaledDimensions(surface->w, surface->h, maxWidth, maxHeight, newWidth, newHeight);
+    return EncodeToWebP(image, maxWidth, maxHeight, profile);
+  }
 
-    // Create scaled surface
-    auto scaledSurface = SDL::MakeSurface(newWidth, newHeight, surface->format);
-    if (!scaledSurface) {
-      AF_ERROR("Failed to create scaled surface");
-      SDL_DestroySurface(surface);
+  std::vector<unsigned char> ImageProcessor::CompressToWebP(const std::vector<unsigned char>& imageBuffer,
+                                                            const WebPEncoderProfile& profile)
+  {
+    RawImage image = LoadImageFromBuffer(imageBuffer);
+    if (image.IsEmpty()) {
       return {};
     }
 
-    // Resize using stbir
-    const unsigned char* srcPixels = static_cast<const unsigned char*>(surface->pixels);
-    unsigned char* dstPixels = static_cast<unsigned char*>(scaledSurface->pixels);
-
-    stbir_resize_uint8_srgb(srcPixels,
-                            surface->w,
-                            surface->h,
-                            surface->pitch,
-                            dstPixels,
-                            newWidth,
-                            newHeight,
-                            scaledSurface->pitch,
-                            STBIR_RGBA); // RGBA pixel layout
-
-    // Encode to WebP
-    auto result = SurfaceToWebP(scaledSurface.get(), qualityPercent);
-
-    AF_INFO("Scaled and compressed to WebP: {}x{} -> {}x{}", surface->w, surface->h, newWidth, newHeight);
-
-    SDL_DestroySurface(surface);
-    return result;
+    return EncodePixels(image.pixels.data(), image.width, image.height, image.stride, profile);
   }
 
-  std::vector<unsigned char> ImageProcessor::CompressToWebP(const std::vector<unsigned char>& imageBuffer,
-                                                            int qualityPercent)
+  std::vector<unsigned char>
+  ImageProcessor::EncodeToWebP(const RawImage& image, int maxWidth, int maxHeight, const WebPEncoderProfile& profile)
   {
-    if (imageBuffer.empty()) {
-      AF_ERROR("Image buffer is empty");
+    if (image.IsEmpty()) {
+      AF_ERROR("Image is empty");
       return {};
     }
 
-    SDL_Surface* surface = LoadImageFromBuffer(imageBuffer);
-    if (!surface) {
+    // Check if scaling is needed
+    if (image.width <= maxWidth && image.height <= maxHeight) {
+      return EncodePixels(image.pixels.data(), image.width, image.height, image.stride, profile);
+    }
+
+    // Calculate new dimensions maintaining aspect ratio
+    int newWidth{}, newHeight{};
+    CalculateScaledDimensions(image.width, image.height, maxWidth, maxHeight, newWidth, newHeight);
+
+    RawImage scaled = GetScaler().ScaleRGBA(image, newWidth, newHeight);
+    if (scaled.IsEmpty()) {
+      AF_ERROR("Failed to scale image");
       return {};
     }
 
-    auto result = SurfaceToWebP(surface, qualityPercent);
-    SDL_DestroySurface(surface);
-    return result;
+    AF_INFO("Scaled image for WebP: {}x{} -> {}x{}", image.width, image.height, newWidth, newHeight);
+    return EncodePixels(scaled.pixels.data(), scaled.width, scaled.height, scaled.stride, profile);
   }
 
 } // namespace Video2Card::Utils
@@ -4,7 +4,8 @@
 #include <string>
 #include <vector>
 
-struct SDL_Surface;
+#include "utils/RawImage.h"
+#include "utils/WebPEncoder.h"
 
 namespace Video2Card::Utils
 {
@@ -19,35 +20,51 @@ public:
      * @param imageBuffer Input image buffer
      * @param maxWidth Maximum width
      * @param maxHeight Maximum height
-     * @param qualityPercent Quality for WebP compression (1-100)
+     * @param profile WebP encoder settings
      * @return Compressed image buffer in WebP format
      */
-    static std::vector<unsigned char> ScaleAndCompressToWebP(const std::vector<unsigned char>& imageBuffer,
-                                                             int maxWidth,
-                                                             int maxHeight,
-                                                             int qualityPercent = 75);
+    static std::vector<unsigned char>
+    ScaleAndCompressToWebP(const std::vector<unsigned char>& imageBuffer,
+                           int maxWidth,
+                           int maxHeight,
+                           const WebPEncoderProfile& profile = WebPEncoder::GetDefaultProfile());
 
     /**
      * Compress an image to WebP format
      * @param imageBuffer Input image buffer
-     * @param qualityPercent Quality for WebP compression (1-100)
+     * @param profile WebP encoder settings
      * @return Compressed image buffer in WebP format
      */
-    static std::vector<unsigned char> CompressToWebP(const std::vector<unsigned char>& imageBuffer,
-                                                     int qualityPercent = 75);
+    static std::vector<unsigned char>
+    CompressToWebP(const std::vector<unsigned char>& imageBuffer,
+                   const WebPEncoderProfile& profile = WebPEncoder::GetDefaultProfile());
+
+    /**
+     * Encode an uncompressed image to WebP, scaling it down first if it doesn't fit
+     * @param image RGBA image
+     * @param maxWidth Maximum width
+     * @param maxHeight Maximum height
+     * @param profile WebP encoder settings
+     * @return Compressed image buffer in WebP format
+     */
+    static std::vector<unsigned char>
+    EncodeToWebP(const RawImage& image,
+                 int maxWidth,
+                 int maxHeight,
+                 const WebPEncoderProfile& profile = WebPEncoder::GetDefaultProfile());
 
 private:
 
     /**
-     * Load image from buffer into SDL_Surface
-     * Returns raw pointer - caller must call SDL_DestroySurface when done
+     * Decode an image file (PNG, JPEG, ...) from a buffer into RGBA pixels
      */
-    static SDL_Surface* LoadImageFromBuffer(const std::vector<unsigned char>& imageBuffer);
+    static RawImage LoadImageFromBuffer(const std::vector<unsigned char>& imageBuffer);
 
     /**
-     * Convert SDL_Surface to WebP format
+     * Encode RGBA pixels to WebP
      */
-    static std::vector<unsigned char> SurfaceToWebP(SDL_Surface* surface, int qualityPercent);
+    static std::vector<unsigned char>
+    EncodePixels(const unsigned char* pixels, int width, int height, int stride, const WebPEncoderProfile& profile);
 
     /**
      * Calculate scaled dimensions maintaining aspect ratio
@@ -0,0 +1,300 @@
+#include "utils/ImageScaler.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+#include <libswscale/swscale.h>
+}
+
+#include <algorithm>
+
+#include "core/Logger.h"
+
+// SSE2 is part of x86-64, AVX2 is compiled per function and picked at runtime
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define IMAGE_SCALER_SSE2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define IMAGE_SCALER_AVX2 1
+#define IMAGE_SCALER_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define IMAGE_SCALER_AVX2 1
+#define IMAGE_SCALER_TARGET_AVX2
+#endif
+#endif
+
+namespace Video2Card::Utils
+{
+
+  namespace
+  {
+    // Adds count bytes of a source row to 32-bit accumulators. This vertical pass touches every source byte
+    // and is where the time goes, the horizontal pass only runs once per output row.
+    using AccumulateRowFn = void (*)(const uint8_t* row, uint32_t* accumulators, size_t count);
+
+    struct AreaKernel
+    {
+      std::string_view name;
+      AccumulateRowFn accumulateRow;
+    };
+
+    void AccumulateRowScalar(const uint8_t* row, uint32_t* accumulators, size_t count)
+    {
+      for (size_t i = 0; i < count; ++i) {
+        accumulators[i] += row[i];
+      }
+    }
+
+#ifdef IMAGE_SCALER_SSE2
+    void AccumulateRowSSE2(const uint8_t* row, uint32_t* accumulators, size_t count)
+    {
+      const __m128i zero = _mm_setzero_si128();
+      size_t i = 0;
+
+      for (; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+
+        __m128i* acc = reinterpret_cast<__m128i*>(accumulators + i);
+        _mm_storeu_si128(acc + 0, _mm_add_epi32(_mm_loadu_si128(acc + 0), _mm_unpacklo_epi16(low, zero)));
+        _mm_storeu_si128(acc + 1, _mm_add_epi32(_mm_loadu_si128(acc + 1), _mm_unpackhi_epi16(low, zero)));
+        _mm_storeu_si128(acc + 2, _mm_add_epi32(_mm_loadu_si128(acc + 2), _mm_unpacklo_epi16(high, zero)));
+        _mm_storeu_si128(acc + 3, _mm_add_epi32(_mm_loadu_si128(acc + 3), _mm_unpackhi_epi16(high, zero)));
+      }
+
+      AccumulateRowScalar(row + i, accumulators + i, count - i);
+    }
+#endif
+
+#ifdef IMAGE_SCALER_AVX2
+    IMAGE_SCALER_TARGET_AVX2 void AccumulateRowAVX2(const uint8_t* row, uint32_t* accumulators, size_t count)
+    {
+      size_t i = 0;
+
+      for (; i + 32 <= count; i += 32) {
+        for (size_t j = 0; j < 32; j += 8) {
+          __m256i widened = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i + j)));
+          __m256i* acc = reinterpret_cast<__m256i*>(accumulators + i + j);
+          _mm256_storeu_si256(acc, _mm256_add_epi32(_mm256_loadu_si256(acc), widened));
+        }
+      }
+
+      AccumulateRowScalar(row + i, accumulators + i, count - i);
+    }
+#endif
+
+    const AreaKernel& GetAreaKernel()
+    {
+      static const AreaKernel kernel = []() -> AreaKernel {
+#ifdef IMAGE_SCALER_AVX2
+#if defined(__GNUC__) || defined(__clang__)
+        if (__builtin_cpu_supports("avx2"))
+          return {"avx2", AccumulateRowAVX2};
+#else
+        return {"avx2", AccumulateRowAVX2};
+#endif
+#endif
+#ifdef IMAGE_SCALER_SSE2
+        return {"sse2", AccumulateRowSSE2};
+#else
+        return {"scalar", AccumulateRowScalar};
+#endif
+      }();
+      return kernel;
+    }
+  } // namespace
+
+  ImageScaler::~ImageScaler()
+  {
+    for (auto& entry : m_Cache) {
+      sws_freeContext(entry.context);
+    }
+  }
+
+  SwsContext* ImageScaler::GetContext(
+      int srcWidth, int srcHeight, int srcFormat, int dstWidth, int dstHeight, int dstFormat, int flags)
+  {
+    ++m_UseCounter;
+
+    for (auto& entry : m_Cache) {
+      if (entry.srcWidth == srcWidth && entry.srcHeight == srcHeight && entry.srcFormat == srcFormat &&
+          entry.dstWidth == dstWidth && entry.dstHeight == dstHeight && entry.dstFormat == dstFormat &&
+          entry.flags == flags)
+      {
+        entry.lastUsed = m_UseCounter;
+        return entry.context;
+      }
+    }
+
+    SwsContext* context = sws_getContext(srcWidth,
+                                         srcHeight,
+                                         (AVPixelFormat) srcFormat,
+                                         dstWidth,
+                                         dstHeight,
+                                         (AVPixelFormat) dstFormat,
+                                         flags,
+                                         nullptr,
+                                         nullptr,
+                                         nullptr);
+    if (!context) {
+      AF_ERROR("Failed to create sws context {}x{} -> {}x{}", srcWidth, srcHeight, dstWidth, dstHeight);
+      return nullptr;
+    }
+
+    // Evict the least recently used context once the cache is full
+    if (m_Cache.size() >= CACHE_SIZE) {
+      auto oldest = std::min_element(m_Cache.begin(), m_Cache.end(), [](const auto& a, const auto& b) {
+        return a.lastUsed < b.lastUsed;
+      });
+      sws_freeContext(oldest->context);
+      m_Cache.erase(oldest);
+    }
+
+    m_Cache.push_back({srcWidth, srcHeight, srcFormat, dstWidth, dstHeight, dstFormat, flags, context, m_UseCounter});
+    return context;
+  }
+
+  RawImage ImageScaler::ScaleRGBA(const RawImage& source, int width, int height)
+  {
+    if (source.IsEmpty() || width <= 0 || height <= 0)
+      return {};
+
+    RawImage result;
+    result.width = width;
+    result.height = height;
+    result.stride = width * 4;
+    result.pixels.resize(result.SizeInBytes());
+
+    if (PrefersAreaDownscale(source.width, source.height, width, height)) {
+      AreaDownscaleRGBA(source, result);
+      return result;
+    }
+
+    SwsContext* context =
+        GetContext(source.width, source.height, AV_PIX_FMT_RGBA, width, height, AV_PIX_FMT_RGBA, SWS_BICUBIC);
+    if (!context)
+      return {};
+
+    const uint8_t* srcSlice[] = {source.pixels.data()};
+    int srcStride[] = {source.stride};
+    uint8_t* dstSlice[] = {result.pixels.data()};
+    int dstStride[] = {result.stride};
+    sws_scale(context, srcSlice, srcStride, 0, source.height, dstSlice, dstStride);
+    return result;
+  }
+
+  RawImage ImageScaler::ConvertFrame(const AVFrame* frame, double sampleAspectRatio, int maxWidth, int maxHeight)
+  {
+    if (!frame || frame->width <= 0 || frame->height <= 0)
+      return {};
+
+    double displayWidth = frame->width * (sampleAspectRatio > 0.0 ? sampleAspectRatio : 1.0);
+    double scale = std::min({maxWidth / displayWidth, (double) maxHeight / frame->height, 1.0});
+    int newWidth = std::max(1, (int) (displayWidth * scale));
+    int newHeight = std::max(1, (int) (frame->height * scale));
+
+    // Large downscales convert at full size and area-average the result, which keeps the detail swscale's
+    // filters lose at these factors. Everything else is converted and scaled in one go.
+    bool areaDownscale = PrefersAreaDownscale(frame->width, frame->height, newWidth, newHeight);
+    int convertWidth = areaDownscale ? frame->width : newWidth;
+    int convertHeight = areaDownscale ? frame->height : newHeight;
+
+    SwsContext* context = GetContext(
+        frame->width, frame->height, frame->format, convertWidth, convertHeight, AV_PIX_FMT_RGBA, SWS_BILINEAR);
+    if (!context)
+      return {};
+
+    // Match the matrix mpv picks: BT.709 for HD content unless the stream says otherwise
+    bool isHD =
+        frame->colorspace == AVCOL_SPC_BT709 || (frame->colorspace == AVCOL_SPC_UNSPECIFIED && frame->height >= 720);
+    bool fullRange = frame->color_range == AVCOL_RANGE_JPEG;
+    sws_setColorspaceDetails(context,
+                             sws_getCoefficients(isHD ? SWS_CS_ITU709 : SWS_CS_DEFAULT),
+                             fullRange ? 1 : 0,
+                             sws_getCoefficients(SWS_CS_DEFAULT),
+                             1,
+                             0,
+                             1 << 16,
+                             1 << 16);
+
+    RawImage image;
+    image.width = newWidth;
+    image.height = newHeight;
+    image.stride = newWidth * 4;
+    image.pixels.resize(image.SizeInBytes());
+
+    RawImage& converted = areaDownscale ? m_FullFrame : image;
+    converted.width = convertWidth;
+    converted.height = convertHeight;
+    converted.stride = convertWidth * 4;
+    converted.pixels.resize(converted.SizeInBytes());
+
+    uint8_t* dstSlice[] = {converted.pixels.data()};
+    int dstStride[] = {converted.stride};
+    sws_scale(context, frame->data, frame->linesize, 0, frame->height, dstSlice, dstStride);
+
+    if (areaDownscale) {
+      AreaDownscaleRGBA(m_FullFrame, image);
+    }
+    return image;
+  }
+
+  bool ImageScaler::PrefersAreaDownscale(int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+  {
+    return dstWidth > 0 && dstHeight > 0 && srcWidth >= dstWidth * 2 && srcHeight >= dstHeight * 2;
+  }
+
+  void ImageScaler::AreaDownscaleRGBA(const RawImage& source, RawImage& destination)
+  {
+    const AreaKernel& kernel = GetAreaKernel();
+    const int dstWidth = destination.width;
+    const int dstHeight = destination.height;
+    if (dstWidth <= 0 || dstHeight <= 0 || dstWidth > source.width || dstHeight > source.height)
+      return;
+
+    // Each output pixel averages the source block between these boundaries. With a non-integer factor the
+    // blocks differ by at most one row or column, which is not visible at thumbnail sizes.
+    std::vector<int> columnStart(dstWidth + 1);
+    for (int x = 0; x <= dstWidth; ++x) {
+      columnStart[x] = static_cast<int>(static_cast<int64_t>(x) * source.width / dstWidth);
+    }
+
+    const size_t rowBytes = static_cast<size_t>(source.width) * 4;
+    std::vector<uint32_t> accumulators(rowBytes);
+
+    for (int y = 0; y < dstHeight; ++y) {
+      int rowBegin = static_cast<int>(static_cast<int64_t>(y) * source.height / dstHeight);
+      int rowEnd = static_cast<int>(static_cast<int64_t>(y + 1) * source.height / dstHeight);
+
+      std::fill(accumulators.begin(), accumulators.end(), 0);
+      for (int row = rowBegin; row < rowEnd; ++row) {
+        kernel.accumulateRow(&source.pixels[static_cast<size_t>(row) * source.stride], accumulators.data(), rowBytes);
+      }
+
+      uint8_t* out = &destination.pixels[static_cast<size_t>(y) * destination.stride];
+      const int rows = rowEnd - rowBegin;
+      for (int x = 0; x < dstWidth; ++x) {
+        uint32_t sum[4] = {0, 0, 0, 0};
+        for (int column = columnStart[x]; column < columnStart[x + 1]; ++column) {
+          const uint32_t* pixel = &accumulators[static_cast<size_t>(column) * 4];
+          sum[0] += pixel[0];
+          sum[1] += pixel[1];
+          sum[2] += pixel[2];
+          sum[3] += pixel[3];
+        }
+
+        const uint32_t count = static_cast<uint32_t>(rows * (columnStart[x + 1] - columnStart[x]));
+        for (int c = 0; c < 4; ++c) {
+          out[x * 4 + c] = static_cast<uint8_t>((sum[c] + count / 2) / count);
+        }
+      }
+    }
+  }
+
+  std::string_view ImageScaler::GetKernelName()
+  {
+    return GetAreaKernel().name;
+  }
+
+} // namespace Video2Card::Utils
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "utils/RawImage.h"
+
+struct AVFrame;
+struct SwsContext;
+
+namespace Video2Card::Utils
+{
+
+  /**
+   * Image scaling shared by the snapshot decoder and the card image path
+   * Keeps a small cache of swscale contexts keyed by geometry and pixel format, so scaling a series of frames
+   * of the same size doesn't set up filters each time, and has an area-averaging kernel for large RGBA
+   * downscales (1080p to a 320px thumbnail and such), where it is both faster and sharper than swscale.
+   *
+   * Not thread-safe, each thread that scales images needs its own instance.
+   */
+  class ImageScaler
+  {
+public:
+
+    ImageScaler() = default;
+    ~ImageScaler();
+
+    ImageScaler(const ImageScaler&) = delete;
+    ImageScaler& operator=(const ImageScaler&) = delete;
+
+    /**
+     * Get a swscale context for the conversion, creating it on first use
+     * The context stays owned by the scaler and may be freed by any later call.
+     * @param srcFormat Source AVPixelFormat
+     * @param dstFormat Destination AVPixelFormat
+     * @param flags SWS_* scaling flags
+     * @return Context, nullptr if the conversion is not supported
+     */
+    SwsContext*
+    GetContext(int srcWidth, int srcHeight, int srcFormat, int dstWidth, int dstHeight, int dstFormat, int flags);
+
+    /**
+     * Scale an RGBA image to exactly width x height
+     * Downscales by a factor of two or more use the area-averaging kernel, everything else goes through swscale.
+     * @return Scaled image, empty on failure
+     */
+    RawImage ScaleRGBA(const RawImage& source, int width, int height);
+
+    /**
+     * Convert a decoded video frame to RGBA, scaled to fit within maxWidth x maxHeight
+     * Uses the BT.709 matrix for HD video unless the frame says otherwise, the same as mpv does.
+     * @param sampleAspectRatio Pixel aspect ratio of the frame, anamorphic video is stretched to its display shape
+     * @return Scaled image, empty on failure
+     */
+    RawImage ConvertFrame(const AVFrame* frame, double sampleAspectRatio, int maxWidth, int maxHeight);
+
+    /**
+     * Area-average an RGBA image down into destination
+     * destination must have its width, height and stride set and be no larger than source in either dimension.
+     */
+    static void AreaDownscaleRGBA(const RawImage& source, RawImage& destination);
+
+    /**
+     * True if a downscale from source to destination size should use AreaDownscaleRGBA
+     */
+    static bool PrefersAreaDownscale(int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+
+    /**
+     * Name of the SIMD kernel picked for this CPU ("avx2", "sse2" or "scalar")
+     */
+    static std::string_view GetKernelName();
+
+private:
+
+    struct CacheEntry
+    {
+      int srcWidth;
+      int srcHeight;
+      int srcFormat;
+      int dstWidth;
+      int dstHeight;
+      int dstFormat;
+      int flags;
+      SwsContext* context;
+      uint64_t lastUsed;
+    };
+
+    static constexpr size_t CACHE_SIZE = 4;
+
+    std::vector<CacheEntry> m_Cache;
+    uint64_t m_UseCounter = 0;
+    RawImage m_FullFrame; // Full size frame for ConvertFrame(), reused for area downscales
+  };
+
+} // namespace Video2Card::Utils
@@ -0,0 +1,163 @@
+#include "utils/MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "core/Logger.h"
+
+namespace Video2Card::Utils
+{
+
+  MappedFile::~MappedFile()
+  {
+    Close();
+  }
+
+  MappedFile::MappedFile(MappedFile&& other) noexcept
+  {
+    *this = std::move(other);
+  }
+
+  MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+  {
+    if (this != &other) {
+      Close();
+      m_Data = std::exchange(other.m_Data, nullptr);
+      m_Size = std::exchange(other.m_Size, 0);
+      m_IsOpen = std::exchange(other.m_IsOpen, false);
+#ifdef _WIN32
+      m_File = std::exchange(other.m_File, nullptr);
+      m_Mapping = std::exchange(other.m_Mapping, nullptr);
+#endif
+    }
+    return *this;
+  }
+
+#ifdef _WIN32
+
+  bool MappedFile::Open(const std::string& path)
+  {
+    Close();
+
+    int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, widePath.data(), length);
+
+    HANDLE file = CreateFileW(widePath.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      AF_WARN("Failed to open file for mapping: {}", path);
+      return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+      CloseHandle(file);
+      return false;
+    }
+
+    m_File = file;
+    m_Size = static_cast<size_t>(size.QuadPart);
+    m_IsOpen = true;
+
+    // Windows refuses to map empty files
+    if (m_Size == 0)
+      return true;
+
+    m_Mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    m_Data = m_Mapping ? MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!m_Data) {
+      AF_WARN("Failed to map file: {}", path);
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void MappedFile::Close()
+  {
+    if (m_Data) {
+      UnmapViewOfFile(m_Data);
+    }
+    if (m_Mapping) {
+      CloseHandle(m_Mapping);
+    }
+    if (m_File) {
+      CloseHandle(m_File);
+    }
+    m_Data = nullptr;
+    m_Mapping = nullptr;
+    m_File = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+  }
+
+#else
+
+  bool MappedFile::Open(const std::string& path)
+  {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      AF_WARN("Failed to open file for mapping: {}", path);
+      return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+      close(fd);
+      return false;
+    }
+
+    m_Size = static_cast<size_t>(info.st_size);
+    m_IsOpen = true;
+
+    // mmap rejects a length of zero
+    if (m_Size > 0) {
+      void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        AF_WARN("Failed to map file: {}", path);
+        close(fd);
+        m_Size = 0;
+        m_IsOpen = false;
+        return false;
+      }
+      // Read front to back exactly once
+      madvise(data, m_Size, MADV_SEQUENTIAL);
+      m_Data = data;
+    }
+
+    // The mapping keeps its own reference to the file
+    close(fd);
+    return true;
+  }
+
+  void MappedFile::Close()
+  {
+    if (m_Data) {
+      munmap(const_cast<void*>(m_Data), m_Size);
+    }
+    m_Data = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+  }
+
+#endif
+
+} // namespace Video2Card::Utils
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Video2Card::Utils
+{
+
+  /**
+   * Read-only memory mapping of a whole file
+   * Pages are loaded by the OS as they are touched, so parsing a file straight from the mapping skips the copy
+   * into a buffer of our own. Views handed out stay valid until the file is closed or the object is destroyed.
+   */
+  class MappedFile
+  {
+public:
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Map a file, closing the one mapped before
+     * Empty files open successfully and give an empty view.
+     * @return true on success
+     */
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_IsOpen; }
+    std::string_view GetView() const { return {static_cast<const char*>(m_Data), m_Size}; }
+    size_t GetSize() const { return m_Size; }
+
+private:
+
+    const void* m_Data = nullptr;
+    size_t m_Size = 0;
+    bool m_IsOpen = false;
+#ifdef _WIN32
+    void* m_File = nullptr;
+    void* m_Mapping = nullptr;
+#endif
+  };
+
+} // namespace Video2Card::Utils
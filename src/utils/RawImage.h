@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Video2Card::Utils
+{
+
+  /**
+   * Uncompressed 8-bit RGBA image
+   * Snapshots travel through the pipeline in this form and are only encoded once, when the card is uploaded.
+   */
+  struct RawImage
+  {
+    std::vector<unsigned char> pixels;
+    int width = 0;
+    int height = 0;
+    int stride = 0; // Bytes per row, at least width * 4
+
+    bool IsEmpty() const { return pixels.empty() || width <= 0 || height <= 0; }
+    size_t SizeInBytes() const { return static_cast<size_t>(stride) * height; }
+  };
+
+} // namespace Video2Card::Utils
@@ -0,0 +1,287 @@
+#include "utils/TextEncoding.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <iconv.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TEXT_ENCODING_SSE2 1
+#endif
+
+namespace Video2Card::Utils
+{
+
+  // UTF-16 detection only looks at the start of the file, a few kilobytes of text are plenty
+  static constexpr size_t UTF16_SAMPLE_SIZE = 4096;
+
+  namespace
+  {
+    // Returns the length of the ASCII run at the start of data
+    size_t SkipAscii(const unsigned char* data, size_t size)
+    {
+      size_t i = 0;
+#ifdef TEXT_ENCODING_SSE2
+      for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(block);
+        if (mask != 0)
+          return i + std::countr_zero(mask);
+      }
+#endif
+      while (i < size && data[i] < 0x80) {
+        ++i;
+      }
+      return i;
+    }
+
+    bool IsValidShiftJis(std::string_view data)
+    {
+      const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+      size_t size = data.size();
+      size_t i = 0;
+      while (i < size) {
+        i += SkipAscii(bytes + i, size - i);
+        if (i >= size)
+          break;
+
+        unsigned char c = bytes[i];
+        if (c >= 0xA1 && c <= 0xDF) {
+          // Half-width katakana
+          ++i;
+        } else if ((c >= 0x81 && c <= 0x9F) || (c >= 0xE0 && c <= 0xFC)) {
+          if (i + 1 >= size)
+            return false;
+          unsigned char trail = bytes[i + 1];
+          if (trail < 0x40 || trail == 0x7F || trail > 0xFC)
+            return false;
+          i += 2;
+        } else {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    void AppendUtf8(std::string& output, uint32_t codepoint)
+    {
+      if (codepoint < 0x80) {
+        output += (char) codepoint;
+      } else if (codepoint < 0x800) {
+        output += (char) (0xC0 | (codepoint >> 6));
+        output += (char) (0x80 | (codepoint & 0x3F));
+      } else if (codepoint < 0x10000) {
+        output += (char) (0xE0 | (codepoint >> 12));
+        output += (char) (0x80 | ((codepoint >> 6) & 0x3F));
+        output += (char) (0x80 | (codepoint & 0x3F));
+      } else {
+        output += (char) (0xF0 | (codepoint >> 18));
+        output += (char) (0x80 | ((codepoint >> 12) & 0x3F));
+        output += (char) (0x80 | ((codepoint >> 6) & 0x3F));
+        output += (char) (0x80 | (codepoint & 0x3F));
+      }
+    }
+
+    void Utf16ToUtf8(std::string_view data, bool bigEndian, std::string& output)
+    {
+      const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+      size_t units = data.size() / 2;
+      output.clear();
+      output.reserve(units * 3 / 2);
+
+      auto unitAt = [&](size_t i) -> uint32_t {
+        return bigEndian ? (bytes[2 * i] << 8) | bytes[2 * i + 1] : bytes[2 * i] | (bytes[2 * i + 1] << 8);
+      };
+
+      for (size_t i = 0; i < units; ++i) {
+        uint32_t unit = unitAt(i);
+        if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < units) {
+          uint32_t low = unitAt(i + 1);
+          if (low >= 0xDC00 && low <= 0xDFFF) {
+            AppendUtf8(output, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+            ++i;
+            continue;
+          }
+        }
+        // Unpaired surrogates become the replacement character
+        AppendUtf8(output, (unit >= 0xD800 && unit <= 0xDFFF) ? 0xFFFD : unit);
+      }
+    }
+
+    // The 0x80-0x9F range of Windows-1252, where it differs from Latin-1
+    constexpr uint16_t CP1252_HIGH[32] = {
+        0x20AC, 0xFFFD, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160,
+        0x2039, 0x0152, 0xFFFD, 0x017D, 0xFFFD, 0xFFFD, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022,
+        0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0xFFFD, 0x017E, 0x0178,
+    };
+
+    void Latin1ToUtf8(std::string_view data, std::string& output)
+    {
+      output.clear();
+      output.reserve(data.size() + data.size() / 8);
+      for (unsigned char c : data) {
+        AppendUtf8(output, (c >= 0x80 && c < 0xA0) ? CP1252_HIGH[c - 0x80] : c);
+      }
+    }
+
+    bool ShiftJisToUtf8(std::string_view data, std::string& output)
+    {
+      output.clear();
+      if (data.empty())
+        return true;
+
+#ifdef _WIN32
+      int wideLength = MultiByteToWideChar(932, 0, data.data(), (int) data.size(), nullptr, 0);
+      if (wideLength <= 0)
+        return false;
+      std::wstring wide(wideLength, L'\0');
+      MultiByteToWideChar(932, 0, data.data(), (int) data.size(), wide.data(), wideLength);
+
+      int length = WideCharToMultiByte(CP_UTF8, 0, wide.data(), wideLength, nullptr, 0, nullptr, nullptr);
+      if (length <= 0)
+        return false;
+      output.resize(length);
+      WideCharToMultiByte(CP_UTF8, 0, wide.data(), wideLength, output.data(), length, nullptr, nullptr);
+      return true;
+#else
+      iconv_t converter = iconv_open("UTF-8", "CP932");
+      if (converter == (iconv_t) -1)
+        return false;
+
+      // Every Shift-JIS character is at most 3 bytes of UTF-8 for at least 1 byte of input
+      output.resize(data.size() * 3);
+      char* input = const_cast<char*>(data.data());
+      size_t inputLeft = data.size();
+      char* out = output.data();
+      size_t outputLeft = output.size();
+
+      size_t result = iconv(converter, &input, &inputLeft, &out, &outputLeft);
+      iconv_close(converter);
+      if (result == (size_t) -1)
+        return false;
+
+      output.resize(output.size() - outputLeft);
+      return true;
+#endif
+    }
+  } // namespace
+
+  bool TextEncodingUtils::IsValidUtf8(std::string_view data)
+  {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    size_t size = data.size();
+    size_t i = 0;
+
+    while (i < size) {
+      // Subtitle files are mostly markup and timestamps, skip ASCII a block at a time
+      i += SkipAscii(bytes + i, size - i);
+      if (i >= size)
+        break;
+
+      unsigned char c = bytes[i];
+      size_t length = 0;
+      unsigned char low = 0x80;
+      unsigned char high = 0xBF;
+      if (c >= 0xC2 && c <= 0xDF) {
+        length = 2;
+      } else if (c >= 0xE0 && c <= 0xEF) {
+        length = 3;
+        // No overlong encodings, no surrogates
+        low = c == 0xE0 ? 0xA0 : 0x80;
+        high = c == 0xED ? 0x9F : 0xBF;
+      } else if (c >= 0xF0 && c <= 0xF4) {
+        length = 4;
+        low = c == 0xF0 ? 0x90 : 0x80;
+        high = c == 0xF4 ? 0x8F : 0xBF;
+      } else {
+        return false;
+      }
+
+      if (i + length > size || bytes[i + 1] < low || bytes[i + 1] > high)
+        return false;
+      for (size_t j = 2; j < length; ++j) {
+        if ((bytes[i + j] & 0xC0) != 0x80)
+          return false;
+      }
+      i += length;
+    }
+    return true;
+  }
+
+  DetectedEncoding TextEncodingUtils::Detect(std::string_view data)
+  {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    if (data.size() >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+      return {TextEncoding::Utf8, 3};
+    if (data.size() >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE)
+      return {TextEncoding::Utf16LE, 2};
+    if (data.size() >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF)
+      return {TextEncoding::Utf16BE, 2};
+
+    // Timestamps and markup are ASCII, which UTF-16 stores with a zero in every other byte
+    size_t sample = std::min(data.size(), UTF16_SAMPLE_SIZE) & ~(size_t) 1;
+    size_t evenZeros = 0;
+    size_t oddZeros = 0;
+    for (size_t i = 0; i < sample; i += 2) {
+      evenZeros += bytes[i] == 0;
+      oddZeros += bytes[i + 1] == 0;
+    }
+    if (sample > 0 && oddZeros > sample / 8 && oddZeros > evenZeros * 4)
+      return {TextEncoding::Utf16LE, 0};
+    if (sample > 0 && evenZeros > sample / 8 && evenZeros > oddZeros * 4)
+      return {TextEncoding::Utf16BE, 0};
+
+    if (IsValidUtf8(data))
+      return {TextEncoding::Utf8, 0};
+    if (IsValidShiftJis(data))
+      return {TextEncoding::ShiftJis, 0};
+    return {TextEncoding::Latin1, 0};
+  }
+
+  bool TextEncodingUtils::ToUtf8(std::string_view data, TextEncoding encoding, std::string& output)
+  {
+    switch (encoding) {
+      case TextEncoding::Utf8:
+        output.assign(data);
+        return true;
+      case TextEncoding::Utf16LE:
+        Utf16ToUtf8(data, false, output);
+        return true;
+      case TextEncoding::Utf16BE:
+        Utf16ToUtf8(data, true, output);
+        return true;
+      case TextEncoding::ShiftJis:
+        return ShiftJisToUtf8(data, output);
+      case TextEncoding::Latin1:
+        Latin1ToUtf8(data, output);
+        return true;
+    }
+    return false;
+  }
+
+  std::string_view TextEncodingUtils::GetName(TextEncoding encoding)
+  {
+    switch (encoding) {
+      case TextEncoding::Utf8:
+        return "UTF-8";
+      case TextEncoding::Utf16LE:
+        return "UTF-16LE";
+      case TextEncoding::Utf16BE:
+        return "UTF-16BE";
+      case TextEncoding::ShiftJis:
+        return "Shift-JIS";
+      case TextEncoding::Latin1:
+        return "Windows-1252";
+    }
+    return "unknown";
+  }
+
+} // namespace Video2Card::Utils
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Video2Card::Utils
+{
+
+  enum class TextEncoding
+  {
+    Utf8,
+    Utf16LE,
+    Utf16BE,
+    ShiftJis, // Microsoft's CP932 flavour, which is what Japanese subtitle files use in practice
+    Latin1    // Anything that is neither of the above, read as Windows-1252
+  };
+
+  struct DetectedEncoding
+  {
+    TextEncoding encoding = TextEncoding::Utf8;
+    size_t bomLength = 0; // Bytes to skip before the text starts
+  };
+
+  class TextEncodingUtils
+  {
+public:
+
+    /**
+     * Guess the encoding of a text file
+     * A byte order mark wins. Without one, UTF-16 is recognized by its zero bytes, then the data is checked
+     * for valid UTF-8 and valid Shift-JIS, in that order, and Latin-1 is what is left.
+     */
+    static DetectedEncoding Detect(std::string_view data);
+
+    /**
+     * Convert text to UTF-8
+     * @param data Text without its byte order mark
+     * @param encoding Encoding of data, UTF-8 is copied as it is
+     * @param output Receives the converted text
+     * @return false if the text could not be converted
+     */
+    static bool ToUtf8(std::string_view data, TextEncoding encoding, std::string& output);
+
+    /**
+     * Check that data is well-formed UTF-8
+     */
+    static bool IsValidUtf8(std::string_view data);
+
+    static std::string_view GetName(TextEncoding encoding);
+  };
+
+} // namespace Video2Card::Utils
@@ -0,0 +1,102 @@
+#include "utils/WebPEncoder.h"
+
+#include <array>
+#include <webp/encode.h>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Utils
+{
+
+  namespace
+  {
+    // Card images are small (320px), so even the slower methods only take a few milliseconds. The lossy
+    // profiles differ mostly in how much of that is spent on making the file smaller.
+    constexpr std::array<WebPEncoderProfile, 4> PROFILES = {{
+        {"fast-lossy", "Fast (lossy)", false, 70.0f, 0, 0, 1, true},
+        {"balanced", "Balanced (lossy)", false, 80.0f, 4, 0, 1, true},
+        {"compact", "Compact (lossy, ~24 KB)", false, 80.0f, 6, 24 * 1024, 4, true},
+        {"archival-lossless", "Archival (lossless)", true, 75.0f, 6, 0, 1, true},
+    }};
+
+    constexpr size_t DEFAULT_PROFILE = 1;
+
+    int WriteToVector(const uint8_t* data, size_t size, const WebPPicture* picture)
+    {
+      auto* output = static_cast<std::vector<unsigned char>*>(picture->custom_ptr);
+      output->insert(output->end(), data, data + size);
+      return 1;
+    }
+  } // namespace
+
+  std::span<const WebPEncoderProfile> WebPEncoder::GetProfiles()
+  {
+    return PROFILES;
+  }
+
+  const WebPEncoderProfile& WebPEncoder::GetProfile(std::string_view id)
+  {
+    for (const auto& profile : PROFILES) {
+      if (profile.id == id)
+        return profile;
+    }
+    return GetDefaultProfile();
+  }
+
+  const WebPEncoderProfile& WebPEncoder::GetDefaultProfile()
+  {
+    return PROFILES[DEFAULT_PROFILE];
+  }
+
+  std::vector<unsigned char> WebPEncoder::Encode(
+      const unsigned char* pixels, int width, int height, int stride, const WebPEncoderProfile& profile)
+  {
+    WebPConfig config;
+    if (!WebPConfigPreset(&config, WEBP_PRESET_PICTURE, profile.quality)) {
+      AF_ERROR("Failed to initialize WebP config");
+      return {};
+    }
+
+    config.lossless = profile.lossless ? 1 : 0;
+    config.method = profile.method;
+    config.target_size = profile.targetSize;
+    config.pass = profile.passes;
+    config.thread_level = profile.multithreaded ? 1 : 0;
+
+    if (!WebPValidateConfig(&config)) {
+      AF_ERROR("Invalid WebP config for profile '{}'", profile.id);
+      return {};
+    }
+
+    WebPPicture picture;
+    if (!WebPPictureInit(&picture)) {
+      AF_ERROR("Failed to initialize WebP picture");
+      return {};
+    }
+
+    // Lossless encodes straight from ARGB, lossy converts to YUV during import
+    picture.use_argb = profile.lossless ? 1 : 0;
+    picture.width = width;
+    picture.height = height;
+    if (!WebPPictureImportRGBA(&picture, pixels, stride)) {
+      AF_ERROR("Failed to import {}x{} image for WebP encoding", width, height);
+      WebPPictureFree(&picture);
+      return {};
+    }
+
+    std::vector<unsigned char> output;
+    output.reserve(static_cast<size_t>(width) * height / 4);
+    picture.writer = WriteToVector;
+    picture.custom_ptr = &output;
+
+    bool ok = WebPEncode(&config, &picture);
+    if (!ok) {
+      AF_ERROR("WebP encoding failed with error {}", (int) picture.error_code);
+      output.clear();
+    }
+
+    WebPPictureFree(&picture);
+    return output;
+  }
+
+} // namespace Video2Card::Utils
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Video2Card::Utils
+{
+
+  /**
+   * Named encoder settings for card images
+   */
+  struct WebPEncoderProfile
+  {
+    std::string_view id;   // Stored in the config, e.g. "balanced"
+    std::string_view name; // Shown in the UI
+    bool lossless = false;
+    float quality = 75.0f; // Lossy: visual quality. Lossless: compression effort
+    int method = 4;        // 0 (fastest) to 6 (smallest)
+    int targetSize = 0;    // Target size in bytes, 0 to encode at the given quality
+    int passes = 1;        // Passes used to converge on targetSize
+    bool multithreaded = true;
+  };
+
+  class WebPEncoder
+  {
+public:
+
+    /**
+     * All profiles, in the order they are offered in the UI
+     */
+    static std::span<const WebPEncoderProfile> GetProfiles();
+
+    /**
+     * Look up a profile by id, falling back to the default profile for unknown ids
+     */
+    static const WebPEncoderProfile& GetProfile(std::string_view id);
+    static const WebPEncoderProfile& GetDefaultProfile();
+
+    /**
+     * Encode RGBA pixels with the advanced libwebp API
+     * @param pixels RGBA pixels
+     * @param width Image width
+     * @param height Image height
+     * @param stride Bytes per row
+     * @param profile Encoder settings
+     * @return WebP image, empty on failure
+     */
+    static std::vector<unsigned char>
+    Encode(const unsigned char* pixels, int width, int height, int stride, const WebPEncoderProfile& profile);
+  };
+
+} // namespace Video2Card::Utils
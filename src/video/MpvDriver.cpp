@@ -0,0 +1,318 @@
+#include "video/MpvDriver.h"
+
+#include "core/Logger.h"
+
+namespace Video2Card::Video
+{
+
+  static size_t AlignedStride(int width)
+  {
+    // mpv's software renderer is fastest with 64-byte aligned rows
+    return (static_cast<size_t>(width) * 4 + 63) & ~static_cast<size_t>(63);
+  }
+
+  MpvDriver::MpvDriver() = default;
+
+  MpvDriver::~MpvDriver()
+  {
+    Shutdown();
+  }
+
+  bool MpvDriver::Start(const std::string& pixelFormat)
+  {
+    m_PixelFormat = pixelFormat;
+
+    m_mpv = mpv_create();
+    if (!m_mpv) {
+      AF_ERROR("Failed to create mpv context");
+      return false;
+    }
+
+    mpv_set_option_string(m_mpv, "config", "no");
+    mpv_set_option_string(m_mpv, "terminal", "yes");
+    mpv_set_option_string(m_mpv, "msg-level", "all=warn,fatal");
+    mpv_set_option_string(m_mpv, "vd-lavc-threads", "4");
+    mpv_set_option_string(m_mpv, "vo", "libmpv");
+    mpv_set_option_string(m_mpv, "sub-font-color", "white");
+
+    if (mpv_initialize(m_mpv) < 0) {
+      AF_ERROR("Failed to initialize mpv");
+      mpv_terminate_destroy(m_mpv);
+      m_mpv = nullptr;
+      return false;
+    }
+
+    mpv_render_param params[] = {{MPV_RENDER_PARAM_API_TYPE, const_cast<char*>(MPV_RENDER_API_TYPE_SW)},
+                                 {MPV_RENDER_PARAM_INVALID, nullptr}};
+
+    if (mpv_render_context_create(&m_mpvRender, m_mpv, params) < 0) {
+      AF_ERROR("Failed to create mpv render context");
+      m_mpvRender = nullptr;
+    }
+
+    mpv_observe_property(m_mpv, 0, "time-pos", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(m_mpv, 0, "duration", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(m_mpv, 0, "container-fps", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(m_mpv, 0, "pause", MPV_FORMAT_FLAG);
+    mpv_observe_property(m_mpv, 0, "width", MPV_FORMAT_INT64);
+    mpv_observe_property(m_mpv, 0, "height", MPV_FORMAT_INT64);
+    mpv_observe_property(m_mpv, 0, "sub-text", MPV_FORMAT_STRING);
+    mpv_observe_property(m_mpv, 0, "sub-start", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(m_mpv, 0, "sub-end", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(m_mpv, 0, "current-tracks/sub/ff-index", MPV_FORMAT_INT64);
+    mpv_observe_property(m_mpv, 0, "current-tracks/sub/external-filename", MPV_FORMAT_STRING);
+
+    // Both callbacks may fire from arbitrary mpv threads and must not call back into mpv, they only wake us up.
+    // They are set before the thread starts and the first pass is forced, so nothing mpv did until now is missed.
+    m_StopRequested = false;
+    m_WakePending = true;
+    m_RenderUpdatePending = true;
+    mpv_set_wakeup_callback(m_mpv, &MpvDriver::OnMpvWakeup, this);
+    if (m_mpvRender) {
+      mpv_render_context_set_update_callback(m_mpvRender, &MpvDriver::OnRenderUpdate, this);
+    }
+
+    m_Thread = std::thread(&MpvDriver::ThreadMain, this);
+
+    return true;
+  }
+
+  void MpvDriver::Shutdown()
+  {
+    if (m_Thread.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_StopRequested = true;
+      }
+      m_WakeCondition.notify_one();
+      m_Thread.join();
+    }
+
+    if (m_mpvRender) {
+      mpv_render_context_set_update_callback(m_mpvRender, nullptr, nullptr);
+      mpv_render_context_free(m_mpvRender);
+      m_mpvRender = nullptr;
+    }
+    if (m_mpv) {
+      mpv_set_wakeup_callback(m_mpv, nullptr, nullptr);
+      mpv_terminate_destroy(m_mpv);
+      m_mpv = nullptr;
+    }
+  }
+
+  void MpvDriver::SetOnPublishCallback(std::function<void()> callback)
+  {
+    std::lock_guard<std::mutex> lock(m_CallbackMutex);
+    m_OnPublishCallback = std::move(callback);
+  }
+
+  void MpvDriver::LoadFile(const std::string& path, double startPosition)
+  {
+    if (!m_mpv)
+      return;
+
+    m_PendingSeekPosition.store(startPosition);
+
+    const char* cmd[] = {"loadfile", path.c_str(), nullptr};
+    int res = mpv_command_async(m_mpv, 0, cmd);
+    if (res < 0) {
+      AF_ERROR("Failed to send loadfile command: {}", mpv_error_string(res));
+    }
+
+    int pause = 0;
+    mpv_set_property_async(m_mpv, 0, "pause", MPV_FORMAT_FLAG, &pause);
+  }
+
+  void MpvDriver::SetRenderSize(int width, int height)
+  {
+    uint64_t packed = (static_cast<uint64_t>(static_cast<uint32_t>(width)) << 32) | static_cast<uint32_t>(height);
+    if (m_RequestedSize.exchange(packed) != packed) {
+      Wake();
+    }
+  }
+
+  void MpvDriver::OnMpvWakeup(void* context)
+  {
+    static_cast<MpvDriver*>(context)->Wake();
+  }
+
+  void MpvDriver::OnRenderUpdate(void* context)
+  {
+    auto* driver = static_cast<MpvDriver*>(context);
+    driver->m_RenderUpdatePending.store(true);
+    driver->Wake();
+  }
+
+  void MpvDriver::Wake()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_WakeMutex);
+      m_WakePending = true;
+    }
+    m_WakeCondition.notify_one();
+  }
+
+  void MpvDriver::ThreadMain()
+  {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        m_WakeCondition.wait(lock, [this] { return m_WakePending || m_StopRequested; });
+        if (m_StopRequested)
+          break;
+        m_WakePending = false;
+      }
+
+      HandleEvents();
+
+      if (!m_mpvRender)
+        continue;
+
+      bool newFrame = false;
+      if (m_RenderUpdatePending.exchange(false)) {
+        uint64_t flags = mpv_render_context_update(m_mpvRender);
+        newFrame = (flags & MPV_RENDER_UPDATE_FRAME) != 0;
+      }
+
+      // A size change re-renders the current frame so the UI never has to wait for the next one
+      uint64_t requested = m_RequestedSize.load();
+      int requestedWidth = static_cast<int>(requested >> 32);
+      int requestedHeight = static_cast<int>(requested & 0xffffffff);
+      int width = requestedWidth > 0 ? requestedWidth : m_State.videoWidth;
+      int height = requestedHeight > 0 ? requestedHeight : m_State.videoHeight;
+      bool sizeChanged = m_HasFrame && (width != m_RenderedWidth || height != m_RenderedHeight);
+
+      if (newFrame || sizeChanged) {
+        RenderFrame();
+      }
+    }
+  }
+
+  void MpvDriver::HandleEvents()
+  {
+    bool stateChanged = false;
+
+    while (true) {
+      mpv_event* event = mpv_wait_event(m_mpv, 0);
+      if (event->event_id == MPV_EVENT_NONE)
+        break;
+
+      if (event->event_id == MPV_EVENT_FILE_LOADED) {
+        AF_DEBUG("File loaded event received");
+        m_State.fileLoaded = true;
+        stateChanged = true;
+
+        double seekPosition = m_PendingSeekPosition.exchange(-1.0);
+        if (seekPosition >= 0.0) {
+          AF_INFO("Performing deferred seek to {} seconds", seekPosition);
+          // Only async calls here: synchronous ones can deadlock against the render context
+          mpv_set_property_async(m_mpv, 0, "time-pos", MPV_FORMAT_DOUBLE, &seekPosition);
+        }
+      } else if (event->event_id == MPV_EVENT_PROPERTY_CHANGE) {
+        mpv_event_property* prop = (mpv_event_property*) event->data;
+        std::string name = prop->name;
+        bool hasValue = prop->data != nullptr && prop->format != MPV_FORMAT_NONE;
+
+        if (name == "time-pos") {
+          m_State.timePos = hasValue ? *(double*) prop->data : 0.0;
+        } else if (name == "duration") {
+          m_State.duration = hasValue ? *(double*) prop->data : 0.0;
+        } else if (name == "container-fps") {
+          m_State.frameRate = hasValue ? *(double*) prop->data : 0.0;
+        } else if (name == "pause") {
+          m_State.paused = hasValue ? *(int*) prop->data != 0 : true;
+        } else if (name == "width") {
+          m_State.videoWidth = hasValue ? (int) *(int64_t*) prop->data : 0;
+          AF_INFO("Video width changed: {}", m_State.videoWidth);
+        } else if (name == "height") {
+          m_State.videoHeight = hasValue ? (int) *(int64_t*) prop->data : 0;
+          AF_INFO("Video height changed: {}", m_State.videoHeight);
+        } else if (name == "sub-text") {
+          const char* text = hasValue ? *(char**) prop->data : nullptr;
+          m_State.subText = text ? text : "";
+        } else if (name == "sub-start") {
+          m_State.subStart = hasValue ? *(double*) prop->data : 0.0;
+        } else if (name == "sub-end") {
+          m_State.subEnd = hasValue ? *(double*) prop->data : 0.0;
+        } else if (name == "current-tracks/sub/ff-index") {
+          m_State.subTrackIndex = hasValue ? (int) *(int64_t*) prop->data : -1;
+        } else if (name == "current-tracks/sub/external-filename") {
+          const char* file = hasValue ? *(char**) prop->data : nullptr;
+          m_State.subTrackFile = file ? file : "";
+        }
+        stateChanged = true;
+      } else if (event->event_id == MPV_EVENT_LOG_MESSAGE) {
+        mpv_event_log_message* msg = (mpv_event_log_message*) event->data;
+        AF_DEBUG("MPV: [{}] {}", msg->prefix, msg->text);
+      } else if (event->event_id == MPV_EVENT_START_FILE) {
+        AF_INFO("MPV: Start file");
+        m_State.fileLoaded = false;
+        stateChanged = true;
+      } else if (event->event_id == MPV_EVENT_END_FILE) {
+        AF_INFO("MPV: End file");
+        m_State.fileLoaded = false;
+        m_HasFrame = false;
+        stateChanged = true;
+      }
+    }
+
+    if (stateChanged) {
+      PublishState();
+    }
+  }
+
+  void MpvDriver::PublishState()
+  {
+    m_States.WriteBuffer() = m_State;
+    m_States.Publish();
+    NotifyPublished();
+  }
+
+  void MpvDriver::NotifyPublished()
+  {
+    std::lock_guard<std::mutex> lock(m_CallbackMutex);
+    if (m_OnPublishCallback) {
+      m_OnPublishCallback();
+    }
+  }
+
+  void MpvDriver::RenderFrame()
+  {
+    if (m_State.videoWidth <= 0 || m_State.videoHeight <= 0)
+      return;
+
+    uint64_t requested = m_RequestedSize.load();
+    int width = static_cast<int>(requested >> 32);
+    int height = static_cast<int>(requested & 0xffffffff);
+    if (width <= 0 || height <= 0) {
+      width = m_State.videoWidth;
+      height = m_State.videoHeight;
+    }
+
+    VideoFrame& frame = m_Frames.WriteBuffer();
+    frame.width = width;
+    frame.height = height;
+    frame.stride = AlignedStride(width);
+    frame.pixels.resize(frame.stride * height);
+
+    int size[2] = {width, height};
+    mpv_render_param params[] = {{MPV_RENDER_PARAM_SW_SIZE, size},
+                                 {MPV_RENDER_PARAM_SW_FORMAT, (void*) m_PixelFormat.c_str()},
+                                 {MPV_RENDER_PARAM_SW_STRIDE, &frame.stride},
+                                 {MPV_RENDER_PARAM_SW_POINTER, frame.pixels.data()},
+                                 {MPV_RENDER_PARAM_INVALID, nullptr}};
+
+    int res = mpv_render_context_render(m_mpvRender, params);
+    if (res < 0) {
+      AF_WARN("mpv failed to render frame: {}", mpv_error_string(res));
+      return;
+    }
+
+    m_Frames.Publish();
+    m_RenderedWidth = width;
+    m_RenderedHeight = height;
+    m_HasFrame = true;
+    NotifyPublished();
+  }
+
+} // namespace Video2Card::Video
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mpv/client.h>
+#include <mpv/render.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "video/TripleBuffer.h"
+
+namespace Video2Card::Video
+{
+
+  struct PlaybackState
+  {
+    double timePos = 0.0;
+    double duration = 0.0;
+    double frameRate = 0.0; // Container frame rate, 0 if unknown
+    bool paused = true;
+    bool fileLoaded = false;
+    int videoWidth = 0;
+    int videoHeight = 0;
+
+    // Subtitle line currently shown, empty when there is none
+    std::string subText;
+    double subStart = 0.0;
+    double subEnd = 0.0;
+
+    // Selected subtitle track: its stream index in the file it comes from, and that file when it is a sidecar
+    int subTrackIndex = -1;
+    std::string subTrackFile;
+  };
+
+  struct VideoFrame
+  {
+    std::vector<uint8_t> pixels;
+    int width = 0;
+    int height = 0;
+    size_t stride = 0;
+  };
+
+  /**
+   * Owns the mpv instance and runs its event loop and software renderer on a dedicated thread
+   * mpv wakes the thread through its wakeup and render update callbacks; nothing polls. Rendered frames and
+   * property changes are published through lock-free triple buffers, so the UI only ever picks up the newest
+   * finished frame and a slow UI frame never stalls decoding (or the other way around).
+   *
+   * The mpv_handle itself stays usable from other threads for commands and property access, as long as only
+   * the driver thread waits for events.
+   */
+  class MpvDriver
+  {
+public:
+
+    MpvDriver();
+    ~MpvDriver();
+
+    MpvDriver(const MpvDriver&) = delete;
+    MpvDriver& operator=(const MpvDriver&) = delete;
+
+    /**
+     * Create the mpv instance and render context and start the driver thread
+     * @param pixelFormat mpv software render format for published frames (e.g. "bgr0")
+     * @return true on success
+     */
+    bool Start(const std::string& pixelFormat);
+
+    /**
+     * Stop the driver thread and destroy the mpv instance
+     */
+    void Shutdown();
+
+    mpv_handle* GetHandle() const { return m_mpv; }
+
+    /**
+     * Called from the driver thread whenever a new frame or playback state has been published
+     * Must be cheap and thread-safe; meant for waking up the UI loop.
+     */
+    void SetOnPublishCallback(std::function<void()> callback);
+
+    /**
+     * Load a file, seeking to startPosition (seconds) once it has been opened
+     */
+    void LoadFile(const std::string& path, double startPosition);
+
+    /**
+     * Size frames are rendered at; 0x0 renders at the video's native size
+     */
+    void SetRenderSize(int width, int height);
+
+    /**
+     * UI side: pick up the newest rendered frame
+     * @return true if a new frame is available through GetFrame()
+     */
+    bool ConsumeFrame() { return m_Frames.Consume(); }
+    const VideoFrame& GetFrame() const { return m_Frames.ReadBuffer(); }
+
+    /**
+     * UI side: pick up the newest playback state
+     * @return true if the state changed since the last call
+     */
+    bool ConsumeState() { return m_States.Consume(); }
+    const PlaybackState& GetState() const { return m_States.ReadBuffer(); }
+
+private:
+
+    static void OnMpvWakeup(void* context);
+    static void OnRenderUpdate(void* context);
+
+    void Wake();
+    void ThreadMain();
+    void HandleEvents();
+    void RenderFrame();
+    void PublishState();
+    void NotifyPublished();
+
+    mpv_handle* m_mpv = nullptr;
+    mpv_render_context* m_mpvRender = nullptr;
+    std::string m_PixelFormat;
+
+    std::thread m_Thread;
+    std::mutex m_WakeMutex;
+    std::condition_variable m_WakeCondition;
+    bool m_WakePending = false;
+    bool m_StopRequested = false;
+    std::atomic<bool> m_RenderUpdatePending{false};
+
+    // Requested render size packed as (width << 32 | height) so it updates atomically
+    std::atomic<uint64_t> m_RequestedSize{0};
+    std::atomic<double> m_PendingSeekPosition{-1.0};
+
+    // Driver thread state
+    PlaybackState m_State;
+    int m_RenderedWidth = 0;
+    int m_RenderedHeight = 0;
+    bool m_HasFrame = false;
+
+    TripleBuffer<VideoFrame> m_Frames;
+    TripleBuffer<PlaybackState> m_States;
+
+    std::mutex m_CallbackMutex;
+    std::function<void()> m_OnPublishCallback;
+  };
+
+} // namespace Video2Card::Video
@@ -0,0 +1,246 @@
+#include "video/SnapshotService.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+}
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/Logger.h"
+
+namespace Video2Card::Video
+{
+
+  SnapshotService::SnapshotService()
+  {
+    m_Worker = std::thread(&SnapshotService::WorkerMain, this);
+  }
+
+  SnapshotService::~SnapshotService()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      m_StopRequested = true;
+    }
+    m_QueueCondition.notify_one();
+    if (m_Worker.joinable()) {
+      m_Worker.join();
+    }
+    CloseDecoder();
+  }
+
+  void SnapshotService::Open(const std::string& path)
+  {
+    std::lock_guard<std::mutex> lock(m_QueueMutex);
+    m_RequestedPath = path;
+  }
+
+  void SnapshotService::Close()
+  {
+    Open("");
+  }
+
+  std::future<Utils::RawImage>
+  SnapshotService::RequestSnapshot(double timestamp, int maxWidth, int maxHeight, std::stop_token cancel)
+  {
+    auto promise = std::make_shared<std::promise<Utils::RawImage>>();
+    std::future<Utils::RawImage> result = promise->get_future();
+
+    bool prefetch = cancel.stop_possible();
+    Post(
+        [this, promise, timestamp, maxWidth, maxHeight, cancel = std::move(cancel)]() {
+          Utils::RawImage image;
+          // A prefetch for a line the user seeked away from is not worth the decode
+          if (!cancel.stop_requested() && EnsureOpen() && DecodeFrameAt(timestamp)) {
+            image = ConvertFrame(maxWidth, maxHeight);
+          }
+          promise->set_value(std::move(image));
+        },
+        prefetch);
+
+    return result;
+  }
+
+  void SnapshotService::Post(std::function<void()> job, bool prefetch)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      (prefetch ? m_Prefetches : m_Jobs).push_back(std::move(job));
+    }
+    m_QueueCondition.notify_one();
+  }
+
+  void SnapshotService::WorkerMain()
+  {
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(m_QueueMutex);
+        m_QueueCondition.wait(lock,
+                              [this] { return m_StopRequested || !m_Jobs.empty() || !m_Prefetches.empty(); });
+        // Outstanding jobs still run so that no promise is left unfulfilled
+        if (!m_Jobs.empty()) {
+          job = std::move(m_Jobs.front());
+          m_Jobs.pop_front();
+        } else if (!m_Prefetches.empty()) {
+          // The newest line is the one the user is looking at, older ones can wait
+          job = std::move(m_Prefetches.back());
+          m_Prefetches.pop_back();
+        } else {
+          break;
+        }
+      }
+      job();
+    }
+  }
+
+  bool SnapshotService::EnsureOpen()
+  {
+    std::string path;
+    {
+      std::lock_guard<std::mutex> lock(m_QueueMutex);
+      path = m_RequestedPath;
+    }
+
+    if (path == m_OpenPath && m_CodecContext)
+      return true;
+
+    CloseDecoder();
+    if (path.empty())
+      return false;
+
+    if (avformat_open_input(&m_FormatContext, path.c_str(), nullptr, nullptr) < 0) {
+      AF_ERROR("Failed to open input file for snapshots: {}", path);
+      return false;
+    }
+
+    if (avformat_find_stream_info(m_FormatContext, nullptr) < 0) {
+      AF_ERROR("Failed to find stream info for snapshots");
+      CloseDecoder();
+      return false;
+    }
+
+    const AVCodec* codec = nullptr;
+    m_StreamIndex = av_find_best_stream(m_FormatContext, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+    if (m_StreamIndex < 0 || !codec) {
+      AF_ERROR("No video stream found for snapshots");
+      CloseDecoder();
+      return false;
+    }
+
+    // Only the video stream is needed, let the demuxer skip everything else
+    for (unsigned int i = 0; i < m_FormatContext->nb_streams; i++) {
+      if ((int) i != m_StreamIndex) {
+        m_FormatContext->streams[i]->discard = AVDISCARD_ALL;
+      }
+    }
+
+    m_CodecContext = avcodec_alloc_context3(codec);
+    avcodec_parameters_to_context(m_CodecContext, m_FormatContext->streams[m_StreamIndex]->codecpar);
+    m_CodecContext->thread_count = 0;
+    if (avcodec_open2(m_CodecContext, codec, nullptr) < 0) {
+      AF_ERROR("Failed to open video decoder for snapshots");
+      CloseDecoder();
+      return false;
+    }
+
+    m_Packet = av_packet_alloc();
+    m_Frame = av_frame_alloc();
+    m_Candidate = av_frame_alloc();
+    m_OpenPath = path;
+    return true;
+  }
+
+  void SnapshotService::CloseDecoder()
+  {
+    av_packet_free(&m_Packet);
+    av_frame_free(&m_Frame);
+    av_frame_free(&m_Candidate);
+    avcodec_free_context(&m_CodecContext);
+    avformat_close_input(&m_FormatContext);
+    m_StreamIndex = -1;
+    m_OpenPath.clear();
+  }
+
+  bool SnapshotService::DecodeFrameAt(double timestamp)
+  {
+    AVStream* stream = m_FormatContext->streams[m_StreamIndex];
+
+    // mpv's time-pos starts at 0 even for files with a non-zero start time
+    double startTime = 0.0;
+    if (m_FormatContext->start_time != AV_NOPTS_VALUE) {
+      startTime = m_FormatContext->start_time / (double) AV_TIME_BASE;
+    }
+    int64_t target =
+        av_rescale_q(std::llround((timestamp + startTime) * AV_TIME_BASE), AV_TIME_BASE_Q, stream->time_base);
+
+    if (av_seek_frame(m_FormatContext, m_StreamIndex, target, AVSEEK_FLAG_BACKWARD) < 0) {
+      AF_WARN("Snapshot seek to {} failed, decoding from the start", timestamp);
+      av_seek_frame(m_FormatContext, m_StreamIndex, 0, AVSEEK_FLAG_BACKWARD);
+    }
+    avcodec_flush_buffers(m_CodecContext);
+    av_frame_unref(m_Candidate);
+
+    // The frame on screen at the target time is the last one with pts <= target. Decode forward from the
+    // preceding keyframe, keeping the latest candidate, until a frame past the target shows up.
+    bool haveCandidate = false;
+    bool done = false;
+
+    auto acceptFrame = [&]() {
+      int64_t pts = m_Frame->best_effort_timestamp != AV_NOPTS_VALUE ? m_Frame->best_effort_timestamp : m_Frame->pts;
+      if (haveCandidate && pts != AV_NOPTS_VALUE && pts > target) {
+        av_frame_unref(m_Frame);
+        return true;
+      }
+
+      av_frame_unref(m_Candidate);
+      av_frame_move_ref(m_Candidate, m_Frame);
+      haveCandidate = true;
+      return pts != AV_NOPTS_VALUE && pts >= target;
+    };
+
+    while (!done) {
+      int readResult = av_read_frame(m_FormatContext, m_Packet);
+      if (readResult < 0) {
+        // End of file: drain whatever the decoder still holds
+        avcodec_send_packet(m_CodecContext, nullptr);
+      } else if (m_Packet->stream_index != m_StreamIndex) {
+        av_packet_unref(m_Packet);
+        continue;
+      } else {
+        avcodec_send_packet(m_CodecContext, m_Packet);
+        av_packet_unref(m_Packet);
+      }
+
+      while (!done && avcodec_receive_frame(m_CodecContext, m_Frame) == 0) {
+        done = acceptFrame();
+      }
+
+      if (readResult < 0)
+        break;
+    }
+
+    if (!haveCandidate) {
+      AF_ERROR("Failed to decode a frame at {}", timestamp);
+    }
+    return haveCandidate;
+  }
+
+  Utils::RawImage SnapshotService::ConvertFrame(int maxWidth, int maxHeight)
+  {
+    // Account for anamorphic video so the image has the same shape as on screen
+    AVStream* stream = m_FormatContext->streams[m_StreamIndex];
+    AVRational sar = av_guess_sample_aspect_ratio(m_FormatContext, stream, m_Candidate);
+    double aspect = (sar.num > 0 && sar.den > 0) ? av_q2d(sar) : 1.0;
+
+    Utils::RawImage image = m_Scaler.ConvertFrame(m_Candidate, aspect, maxWidth, maxHeight);
+    if (image.IsEmpty()) {
+      AF_ERROR("Failed to convert snapshot frame");
+    }
+    return image;
+  }
+
+} // namespace Video2Card::Video
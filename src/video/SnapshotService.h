@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/ImageScaler.h"
+#include "utils/RawImage.h"
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVPacket;
+struct AVFrame;
+
+namespace Video2Card::Video
+{
+
+  /**
+   * Decodes still images from a video file on a worker thread
+   * Uses its own demuxer and decoder instead of the playback pipeline, so the result is the exact frame shown at
+   * the requested timestamp, no matter what the player is currently displaying (or if it is still seeking).
+   * Frames are taken from the decoded video stream and therefore don't include rendered subtitles.
+   */
+  class SnapshotService
+  {
+public:
+
+    SnapshotService();
+    ~SnapshotService();
+
+    SnapshotService(const SnapshotService&) = delete;
+    SnapshotService& operator=(const SnapshotService&) = delete;
+
+    /**
+     * Set the file snapshots are taken from. The file is opened lazily on the worker
+     */
+    void Open(const std::string& path);
+    void Close();
+
+    /**
+     * Decode the frame displayed at a timestamp and scale it to fit
+     * The image is left uncompressed, encoding happens once when the card is uploaded.
+     * @param timestamp Playback time in seconds (same timeline as mpv's time-pos)
+     * @param maxWidth Maximum width of the image
+     * @param maxHeight Maximum height of the image
+     * @param cancel Marks a prefetch: it waits for the direct requests and is skipped once a stop is requested
+     * @return Future with the RGBA image, empty on failure or when skipped
+     */
+    std::future<Utils::RawImage>
+    RequestSnapshot(double timestamp, int maxWidth = 320, int maxHeight = 320, std::stop_token cancel = {});
+
+private:
+
+    void WorkerMain();
+    void Post(std::function<void()> job, bool prefetch);
+
+    bool EnsureOpen();
+    void CloseDecoder();
+    bool DecodeFrameAt(double timestamp);
+    Utils::RawImage ConvertFrame(int maxWidth, int maxHeight);
+
+    std::thread m_Worker;
+    std::mutex m_QueueMutex;
+    std::condition_variable m_QueueCondition;
+    std::deque<std::function<void()>> m_Jobs;
+    std::deque<std::function<void()>> m_Prefetches; // Run once m_Jobs is empty, newest first
+    bool m_StopRequested = false;
+
+    std::string m_RequestedPath; // Guarded by m_QueueMutex
+
+    // Worker thread state
+    std::string m_OpenPath;
+    AVFormatContext* m_FormatContext = nullptr;
+    AVCodecContext* m_CodecContext = nullptr;
+    AVPacket* m_Packet = nullptr;
+    AVFrame* m_Frame = nullptr;
+    AVFrame* m_Candidate = nullptr;
+    Utils::ImageScaler m_Scaler;
+    int m_StreamIndex = -1;
+  };
+
+} // namespace Video2Card::Video
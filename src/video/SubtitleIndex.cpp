@@ -0,0 +1,233 @@
+#include "video/SubtitleIndex.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/avutil.h>
+}
+
+#include <algorithm>
+
+#include "core/Logger.h"
+#include "video/SubtitleParser.h"
+
+namespace Video2Card::Video
+{
+
+  // Lines starting this close together count as starting at the same time, so a seek that lands a hair before
+  // a line's start doesn't make "next line" return that same line again
+  static constexpr double START_TOLERANCE = 0.01;
+
+  namespace
+  {
+    // Decoders hand out every text format as an ASS event:
+    // ReadOrder,Layer,Style,Name,MarginL,MarginR,MarginV,Effect,Text
+    std::string ExtractAssText(std::string_view event)
+    {
+      for (int field = 0; field < 8; ++field) {
+        size_t comma = event.find(',');
+        if (comma == std::string_view::npos)
+          return {};
+        event.remove_prefix(comma + 1);
+      }
+      return SubtitleParser::CleanText(event, SubtitleFormat::Ass);
+    }
+
+    std::string GetText(const AVSubtitle& subtitle)
+    {
+      std::string text;
+      for (unsigned int i = 0; i < subtitle.num_rects; ++i) {
+        const AVSubtitleRect* rect = subtitle.rects[i];
+        std::string part;
+        if (rect->type == SUBTITLE_ASS && rect->ass) {
+          part = ExtractAssText(rect->ass);
+        } else if (rect->type == SUBTITLE_TEXT && rect->text) {
+          part = rect->text;
+        }
+
+        if (part.empty())
+          continue;
+        if (!text.empty())
+          text += '\n';
+        text += part;
+      }
+      return text;
+    }
+  } // namespace
+
+  SubtitleIndex::SubtitleIndex(std::vector<SubtitleCue> cues)
+      : m_Cues(std::move(cues))
+  {
+    std::stable_sort(m_Cues.begin(), m_Cues.end(), [](const SubtitleCue& a, const SubtitleCue& b) {
+      return a.start < b.start || (a.start == b.start && a.end < b.end);
+    });
+
+    m_MaxEnd.reserve(m_Cues.size());
+    double maxEnd = 0.0;
+    for (const auto& cue : m_Cues) {
+      maxEnd = std::max(maxEnd, cue.end);
+      m_MaxEnd.push_back(maxEnd);
+    }
+  }
+
+  SubtitleIndex SubtitleIndex::Load(const std::string& path, int streamIndex)
+  {
+    // Sidecar files in a format of our own are parsed straight from a mapping, much faster than a demuxer
+    if (SubtitleFile::IsSupported(path)) {
+      SubtitleFile file;
+      if (file.Open(path)) {
+        std::vector<SubtitleCue> cues;
+        cues.reserve(file.GetCues().size());
+        for (const auto& parsed : file.GetCues()) {
+          std::string text = file.GetText(parsed);
+          if (!text.empty()) {
+            cues.push_back({parsed.start, parsed.end, std::move(text)});
+          }
+        }
+        AF_INFO("Indexed {} subtitle lines from {}", cues.size(), path);
+        return SubtitleIndex(std::move(cues));
+      }
+    }
+
+    AVFormatContext* formatContext = nullptr;
+    if (avformat_open_input(&formatContext, path.c_str(), nullptr, nullptr) < 0) {
+      AF_WARN("Failed to open subtitle source: {}", path);
+      return {};
+    }
+
+    if (avformat_find_stream_info(formatContext, nullptr) < 0 || streamIndex >= (int) formatContext->nb_streams ||
+        (streamIndex >= 0 && formatContext->streams[streamIndex]->codecpar->codec_type != AVMEDIA_TYPE_SUBTITLE)) {
+      AF_WARN("No subtitle stream {} in {}", streamIndex, path);
+      avformat_close_input(&formatContext);
+      return {};
+    }
+
+    if (streamIndex < 0) {
+      streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_SUBTITLE, -1, -1, nullptr, 0);
+      if (streamIndex < 0) {
+        avformat_close_input(&formatContext);
+        return {};
+      }
+    }
+
+    AVStream* stream = formatContext->streams[streamIndex];
+    const AVCodecDescriptor* descriptor = avcodec_descriptor_get(stream->codecpar->codec_id);
+    const AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!descriptor || !(descriptor->props & AV_CODEC_PROP_TEXT_SUB) || !codec) {
+      AF_INFO("Subtitle stream {} in {} is not text, no subtitle index", streamIndex, path);
+      avformat_close_input(&formatContext);
+      return {};
+    }
+
+    // The ASS header travels in the codec extradata and is needed to make sense of the events
+    AVCodecContext* codecContext = avcodec_alloc_context3(codec);
+    if (!codecContext || avcodec_parameters_to_context(codecContext, stream->codecpar) < 0 ||
+        avcodec_open2(codecContext, codec, nullptr) < 0) {
+      AF_ERROR("Failed to open subtitle decoder for {}", path);
+      avcodec_free_context(&codecContext);
+      avformat_close_input(&formatContext);
+      return {};
+    }
+
+    // Only the subtitle stream is needed, let the demuxer skip everything else
+    for (unsigned int i = 0; i < formatContext->nb_streams; i++) {
+      if ((int) i != streamIndex) {
+        formatContext->streams[i]->discard = AVDISCARD_ALL;
+      }
+    }
+
+    // mpv's time-pos starts at 0 even for files with a non-zero start time (TS recordings), so the cues of an
+    // embedded track are rebased the same way. A subtitle file on its own is not rebased by mpv.
+    double startTime = 0.0;
+    bool embedded = false;
+    for (unsigned int i = 0; i < formatContext->nb_streams; i++) {
+      AVMediaType type = formatContext->streams[i]->codecpar->codec_type;
+      embedded = embedded || type == AVMEDIA_TYPE_VIDEO || type == AVMEDIA_TYPE_AUDIO;
+    }
+    if (embedded && formatContext->start_time != AV_NOPTS_VALUE) {
+      startTime = formatContext->start_time / (double) AV_TIME_BASE;
+    }
+
+    const double timeBase = av_q2d(stream->time_base);
+    std::vector<SubtitleCue> cues;
+    AVPacket* packet = av_packet_alloc();
+
+    while (av_read_frame(formatContext, packet) >= 0) {
+      if (packet->stream_index != streamIndex || packet->pts == AV_NOPTS_VALUE) {
+        av_packet_unref(packet);
+        continue;
+      }
+
+      AVSubtitle subtitle = {};
+      int gotSubtitle = 0;
+      if (avcodec_decode_subtitle2(codecContext, &subtitle, &gotSubtitle, packet) >= 0 && gotSubtitle) {
+        SubtitleCue cue;
+        cue.start = packet->pts * timeBase + subtitle.start_display_time / 1000.0;
+        // Containers store the duration with the packet, the decoder's end time is the fallback
+        cue.end = packet->duration > 0 ? (packet->pts + packet->duration) * timeBase
+                                       : packet->pts * timeBase + subtitle.end_display_time / 1000.0;
+        cue.start -= startTime;
+        cue.end -= startTime;
+        cue.text = GetText(subtitle);
+
+        if (cue.end > cue.start && !cue.text.empty()) {
+          cues.push_back(std::move(cue));
+        }
+        avsubtitle_free(&subtitle);
+      }
+      av_packet_unref(packet);
+    }
+
+    av_packet_free(&packet);
+    avcodec_free_context(&codecContext);
+    avformat_close_input(&formatContext);
+
+    AF_INFO("Indexed {} subtitle lines from stream {} of {}", cues.size(), streamIndex, path);
+    return SubtitleIndex(std::move(cues));
+  }
+
+  std::string ToSingleLine(std::string text)
+  {
+    for (auto& c : text) {
+      if (c == '\n' || c == '\r')
+        c = ' ';
+    }
+    return text;
+  }
+
+  const SubtitleCue* SubtitleIndex::FindAt(double time) const
+  {
+    // Cues starting after the time can't be shown yet
+    auto last = std::upper_bound(
+        m_Cues.begin(), m_Cues.end(), time, [](double t, const SubtitleCue& cue) { return t < cue.start; });
+    size_t count = last - m_Cues.begin();
+
+    // Every cue before the first one whose running maximum end passes the time has ended already
+    size_t first = std::upper_bound(m_MaxEnd.begin(), m_MaxEnd.begin() + count, time) - m_MaxEnd.begin();
+
+    for (size_t i = count; i > first; --i) {
+      if (m_Cues[i - 1].end > time)
+        return &m_Cues[i - 1];
+    }
+    return nullptr;
+  }
+
+  const SubtitleCue* SubtitleIndex::FindNext(double time) const
+  {
+    // The line shown at the time started before it, so this is the next line whether one is shown or not
+    double anchor = time + START_TOLERANCE;
+    auto next = std::upper_bound(
+        m_Cues.begin(), m_Cues.end(), anchor, [](double t, const SubtitleCue& cue) { return t < cue.start; });
+    return next != m_Cues.end() ? &*next : nullptr;
+  }
+
+  const SubtitleCue* SubtitleIndex::FindPrevious(double time) const
+  {
+    const SubtitleCue* current = FindAt(time);
+    double anchor = (current ? current->start : time) - START_TOLERANCE;
+    auto previous = std::lower_bound(
+        m_Cues.begin(), m_Cues.end(), anchor, [](const SubtitleCue& cue, double t) { return cue.start < t; });
+    return previous != m_Cues.begin() ? &*(previous - 1) : nullptr;
+  }
+
+} // namespace Video2Card::Video
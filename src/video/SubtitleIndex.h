@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Video2Card::Video
+{
+
+  struct SubtitleCue
+  {
+    double start = 0.0; // Seconds, on mpv's timeline
+    double end = 0.0;
+    std::string text; // Plain text, formatting tags removed and line breaks kept
+  };
+
+  /**
+   * Join the rows of a subtitle line, the card gets it as one line
+   * @param text Cue text, possibly spanning several rows
+   * @return The text with its line breaks replaced by spaces
+   */
+  std::string ToSingleLine(std::string text);
+
+  /**
+   * Every line of a text subtitle track, sorted by start time
+   * Built once per track and never modified afterwards, so it can be shared between threads. Cues may overlap
+   * (signs and songs in ASS files): next to the sorted cues the index keeps the running maximum of their end
+   * times, which is non-decreasing and tells with a second binary search where the cues still running at a
+   * given time begin. Every lookup is O(log n) plus the number of overlapping cues.
+   *
+   * Times are on mpv's timeline: tracks embedded in a file with a non-zero start time are rebased to start at 0
+   * like time-pos. The user's subtitle offset is applied by the caller when a cue is used.
+   */
+  class SubtitleIndex
+  {
+public:
+
+    SubtitleIndex() = default;
+    explicit SubtitleIndex(std::vector<SubtitleCue> cues);
+
+    /**
+     * Read a text subtitle stream
+     * SRT, ASS and WebVTT sidecar files go through SubtitleParser, anything else (subtitle tracks embedded in
+     * a video, less common sidecar formats) through libavformat. Bitmap subtitles have no text and give an
+     * empty index.
+     * @param path Video or subtitle file
+     * @param streamIndex Stream to read, or -1 for the best subtitle stream in the file
+     * @return The index, empty on failure
+     */
+    static SubtitleIndex Load(const std::string& path, int streamIndex = -1);
+
+    bool IsEmpty() const { return m_Cues.empty(); }
+    size_t GetSize() const { return m_Cues.size(); }
+    const std::vector<SubtitleCue>& GetCues() const { return m_Cues; }
+
+    /**
+     * The line shown at a time; the one that started last if several overlap
+     * @return The cue, or nullptr between lines
+     */
+    const SubtitleCue* FindAt(double time) const;
+
+    /**
+     * The first line starting after a time
+     */
+    const SubtitleCue* FindNext(double time) const;
+
+    /**
+     * The last line starting before the one shown at a time (or before the time itself between lines)
+     */
+    const SubtitleCue* FindPrevious(double time) const;
+
+private:
+
+    std::vector<SubtitleCue> m_Cues;
+    std::vector<double> m_MaxEnd; // m_MaxEnd[i] is the latest end time among m_Cues[0..i]
+  };
+
+} // namespace Video2Card::Video
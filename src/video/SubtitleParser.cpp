@@ -0,0 +1,456 @@
+#include "video/SubtitleParser.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#include "core/Logger.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SUBTITLE_PARSER_SSE2 1
+#endif
+
+namespace Video2Card::Video
+{
+
+  // Field positions of a Dialogue line when the file has no Format line:
+  // Layer,Start,End,Style,Name,MarginL,MarginR,MarginV,Effect,Text
+  static constexpr size_t ASS_DEFAULT_START_FIELD = 1;
+  static constexpr size_t ASS_DEFAULT_END_FIELD = 2;
+  static constexpr size_t ASS_DEFAULT_TEXT_FIELD = 9;
+
+  namespace
+  {
+    /**
+     * Splits a buffer into lines without copying
+     * With SSE2 the line breaks of a whole 64-byte block are found at once and kept as a bit mask, so short
+     * subtitle lines cost a bit scan instead of a new search each.
+     */
+    class LineReader
+    {
+  public:
+
+      explicit LineReader(std::string_view data)
+          : m_Data(data.data())
+          , m_Size(data.size())
+      {
+      }
+
+      // The next line without its line break, \n or \r\n
+      bool Next(std::string_view& line)
+      {
+        if (m_Position >= m_Size)
+          return false;
+
+        size_t newline = FindNewline();
+        size_t end = newline;
+        if (end > m_Position && m_Data[end - 1] == '\r')
+          --end;
+
+        line = std::string_view(m_Data + m_Position, end - m_Position);
+        m_Position = newline + 1;
+        return true;
+      }
+
+  private:
+
+      size_t FindNewline()
+      {
+#ifdef SUBTITLE_PARSER_SSE2
+        const __m128i newline = _mm_set1_epi8('\n');
+        while (true) {
+          if (m_Mask != 0) {
+            size_t found = m_MaskBase + std::countr_zero(m_Mask);
+            m_Mask &= m_Mask - 1;
+            return found;
+          }
+          if (m_NextBlock + 64 > m_Size)
+            break;
+
+          const auto* block = reinterpret_cast<const __m128i*>(m_Data + m_NextBlock);
+          uint64_t mask0 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(block), newline));
+          uint64_t mask1 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(block + 1), newline));
+          uint64_t mask2 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(block + 2), newline));
+          uint64_t mask3 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(block + 3), newline));
+          m_Mask = mask0 | (mask1 << 16) | (mask2 << 32) | (mask3 << 48);
+          m_MaskBase = m_NextBlock;
+          m_NextBlock += 64;
+        }
+        // Less than a block left
+        size_t from = std::max(m_NextBlock, m_Position);
+#else
+        size_t from = m_Position;
+#endif
+        const void* found = std::memchr(m_Data + from, '\n', m_Size - from);
+        return found ? static_cast<const char*>(found) - m_Data : m_Size;
+      }
+
+      const char* m_Data;
+      size_t m_Size;
+      size_t m_Position = 0;
+#ifdef SUBTITLE_PARSER_SSE2
+      uint64_t m_Mask = 0; // Line breaks not handed out yet in the block at m_MaskBase
+      size_t m_MaskBase = 0;
+      size_t m_NextBlock = 0;
+#endif
+    };
+
+    bool IsBlank(std::string_view line)
+    {
+      return std::all_of(line.begin(), line.end(), [](char c) { return c == ' ' || c == '\t'; });
+    }
+
+    std::string_view Trim(std::string_view text)
+    {
+      while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+      }
+      while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+      }
+      return text;
+    }
+
+    bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+    {
+      return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower((unsigned char) x) == std::tolower((unsigned char) y);
+             });
+    }
+
+    /**
+     * Parse [[h:]m:]s[.,fraction] and advance text past it
+     * Covers SRT (00:01:02,500), WebVTT (01:02.500, hours optional) and ASS (0:01:02.50). Leading blanks are
+     * skipped, whatever follows the timestamp is left alone.
+     */
+    bool ParseTimestamp(std::string_view& text, double& seconds)
+    {
+      size_t i = 0;
+      while (i < text.size() && (text[i] == ' ' || text[i] == '\t')) {
+        ++i;
+      }
+
+      double value = 0.0;
+      int groups = 0;
+      while (true) {
+        size_t digitsStart = i;
+        uint64_t number = 0;
+        while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+          number = number * 10 + (text[i] - '0');
+          ++i;
+        }
+        if (i == digitsStart)
+          return false;
+
+        value = value * 60.0 + (double) number;
+        ++groups;
+        if (groups < 3 && i < text.size() && text[i] == ':') {
+          ++i;
+          continue;
+        }
+        break;
+      }
+      if (groups < 2)
+        return false;
+
+      if (i < text.size() && (text[i] == '.' || text[i] == ',')) {
+        ++i;
+        uint64_t fraction = 0;
+        double scale = 1.0;
+        while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+          fraction = fraction * 10 + (text[i] - '0');
+          scale *= 10.0;
+          ++i;
+        }
+        value += fraction / scale;
+      }
+
+      text.remove_prefix(i);
+      seconds = value;
+      return true;
+    }
+
+    // SRT and WebVTT share their block structure: a timing line with "-->", then text up to a blank line.
+    // Cue numbers, the WEBVTT header, NOTE and STYLE blocks never have an arrow and are skipped with it.
+    std::vector<ParsedCue> ParseTimedBlocks(std::string_view data)
+    {
+      std::vector<ParsedCue> cues;
+      // Good enough to avoid most reallocations, a cue takes a bit under 100 bytes in a typical SRT file
+      cues.reserve(data.size() / 96);
+
+      LineReader reader(data);
+      std::string_view line;
+      while (reader.Next(line)) {
+        size_t arrow = line.find("-->");
+        if (arrow == std::string_view::npos)
+          continue;
+
+        ParsedCue cue;
+        std::string_view startText = line.substr(0, arrow);
+        // WebVTT cue settings after the end time are ignored
+        std::string_view endText = line.substr(arrow + 3);
+        if (!ParseTimestamp(startText, cue.start) || !ParseTimestamp(endText, cue.end))
+          continue;
+
+        const char* textBegin = nullptr;
+        const char* textEnd = nullptr;
+        while (reader.Next(line) && !IsBlank(line)) {
+          if (!textBegin)
+            textBegin = line.data();
+          textEnd = line.data() + line.size();
+        }
+
+        if (textBegin && cue.end > cue.start) {
+          cue.text = std::string_view(textBegin, textEnd - textBegin);
+          cues.push_back(cue);
+        }
+      }
+      return cues;
+    }
+
+    std::vector<ParsedCue> ParseAss(std::string_view data)
+    {
+      std::vector<ParsedCue> cues;
+      cues.reserve(data.size() / 128);
+
+      size_t startField = ASS_DEFAULT_START_FIELD;
+      size_t endField = ASS_DEFAULT_END_FIELD;
+      size_t textField = ASS_DEFAULT_TEXT_FIELD;
+      bool inEvents = false;
+
+      LineReader reader(data);
+      std::string_view line;
+      while (reader.Next(line)) {
+        if (line.empty())
+          continue;
+
+        if (line.front() == '[') {
+          inEvents = EqualsIgnoreCase(Trim(line), "[Events]");
+          continue;
+        }
+        if (!inEvents)
+          continue;
+
+        if (line.starts_with("Format:")) {
+          // Text is always the last field, it is the only one that may contain commas
+          std::string_view fields = line.substr(7);
+          for (size_t field = 0;; ++field) {
+            size_t comma = fields.find(',');
+            std::string_view name = Trim(fields.substr(0, comma));
+            if (EqualsIgnoreCase(name, "Start"))
+              startField = field;
+            else if (EqualsIgnoreCase(name, "End"))
+              endField = field;
+
+            if (comma == std::string_view::npos) {
+              textField = field;
+              break;
+            }
+            fields.remove_prefix(comma + 1);
+          }
+          continue;
+        }
+
+        if (!line.starts_with("Dialogue:"))
+          continue;
+
+        ParsedCue cue;
+        std::string_view fields = line.substr(9);
+        bool valid = true;
+        for (size_t field = 0; field < textField && valid; ++field) {
+          size_t comma = fields.find(',');
+          if (comma == std::string_view::npos) {
+            valid = false;
+            break;
+          }
+
+          std::string_view value = fields.substr(0, comma);
+          if (field == startField)
+            valid = ParseTimestamp(value, cue.start);
+          else if (field == endField)
+            valid = ParseTimestamp(value, cue.end);
+          fields.remove_prefix(comma + 1);
+        }
+
+        if (valid && cue.end > cue.start && !fields.empty()) {
+          cue.text = fields;
+          cues.push_back(cue);
+        }
+      }
+      return cues;
+    }
+
+    struct Entity
+    {
+      std::string_view name;
+      std::string_view text;
+    };
+
+    // The character references WebVTT allows in cue text, besides numeric ones which nobody uses
+    constexpr Entity VTT_ENTITIES[] = {
+        {"&amp;", "&"},
+        {"&lt;", "<"},
+        {"&gt;", ">"},
+        {"&nbsp;", " "},
+        {"&lrm;", ""},
+        {"&rlm;", ""},
+    };
+  } // namespace
+
+  SubtitleFormat SubtitleParser::DetectFormat(std::string_view path, std::string_view data)
+  {
+    size_t dot = path.find_last_of('.');
+    std::string_view extension = dot != std::string_view::npos ? path.substr(dot + 1) : std::string_view();
+    if (EqualsIgnoreCase(extension, "srt"))
+      return SubtitleFormat::SubRip;
+    if (EqualsIgnoreCase(extension, "ass") || EqualsIgnoreCase(extension, "ssa"))
+      return SubtitleFormat::Ass;
+    if (EqualsIgnoreCase(extension, "vtt"))
+      return SubtitleFormat::WebVtt;
+
+    if (data.starts_with("WEBVTT"))
+      return SubtitleFormat::WebVtt;
+    if (data.find("[Script Info]") != std::string_view::npos || data.find("[Events]") != std::string_view::npos)
+      return SubtitleFormat::Ass;
+    if (data.find("-->") != std::string_view::npos)
+      return SubtitleFormat::SubRip;
+    return SubtitleFormat::Unknown;
+  }
+
+  std::vector<ParsedCue> SubtitleParser::Parse(std::string_view data, SubtitleFormat format)
+  {
+    switch (format) {
+      case SubtitleFormat::SubRip:
+      case SubtitleFormat::WebVtt:
+        return ParseTimedBlocks(data);
+      case SubtitleFormat::Ass:
+        return ParseAss(data);
+      case SubtitleFormat::Unknown:
+        break;
+    }
+    return {};
+  }
+
+  std::string SubtitleParser::CleanText(std::string_view text, SubtitleFormat format)
+  {
+    const bool ass = format == SubtitleFormat::Ass;
+    std::string result;
+    result.reserve(text.size());
+
+    for (size_t i = 0; i < text.size(); ++i) {
+      // Plain text is copied a run at a time, only markup needs a closer look
+      size_t special = text.find_first_of("\r{<\\&", i);
+      if (special == std::string_view::npos) {
+        result.append(text.substr(i));
+        break;
+      }
+      result.append(text.substr(i, special - i));
+      i = special;
+
+      char c = text[i];
+      char next = i + 1 < text.size() ? text[i + 1] : '\0';
+
+      if (c == '\r')
+        continue;
+
+      if (c == '{' && (ass || next == '\\')) {
+        // ASS override tags such as {\i1} or {\pos(10,20)}, which turn up in SRT files as well
+        size_t close = text.find('}', i);
+        if (close != std::string_view::npos) {
+          i = close;
+          continue;
+        }
+      } else if (c == '<' && !ass && (std::isalnum((unsigned char) next) || next == '/')) {
+        // <i>, </font>, and WebVTT's <c.yellow>, <v Speaker> and <00:01:02.000>
+        size_t close = text.find('>', i);
+        if (close != std::string_view::npos) {
+          i = close;
+          continue;
+        }
+      } else if (c == '\\' && ass && (next == 'N' || next == 'n' || next == 'h')) {
+        result += next == 'h' ? ' ' : '\n';
+        ++i;
+        continue;
+      } else if (c == '&' && format == SubtitleFormat::WebVtt) {
+        auto entity = std::find_if(std::begin(VTT_ENTITIES), std::end(VTT_ENTITIES), [&](const Entity& e) {
+          return text.substr(i).starts_with(e.name);
+        });
+        if (entity != std::end(VTT_ENTITIES)) {
+          result += entity->text;
+          i += entity->name.size() - 1;
+          continue;
+        }
+      }
+
+      result += c;
+    }
+
+    result.erase(result.find_last_not_of(" \t\n") + 1);
+    result.erase(0, result.find_first_not_of(" \t\n"));
+    return result;
+  }
+
+  std::string_view SubtitleParser::GetName(SubtitleFormat format)
+  {
+    switch (format) {
+      case SubtitleFormat::SubRip:
+        return "SubRip";
+      case SubtitleFormat::Ass:
+        return "ASS";
+      case SubtitleFormat::WebVtt:
+        return "WebVTT";
+      case SubtitleFormat::Unknown:
+        break;
+    }
+    return "unknown";
+  }
+
+  bool SubtitleFile::IsSupported(std::string_view path)
+  {
+    return SubtitleParser::DetectFormat(path, {}) != SubtitleFormat::Unknown;
+  }
+
+  bool SubtitleFile::Open(const std::string& path)
+  {
+    m_Cues.clear();
+    m_Converted.clear();
+    m_Format = SubtitleFormat::Unknown;
+    m_Encoding = Utils::TextEncoding::Utf8;
+
+    if (!m_File.Open(path))
+      return false;
+
+    std::string_view data = m_File.GetView();
+    Utils::DetectedEncoding detected = Utils::TextEncodingUtils::Detect(data);
+    data.remove_prefix(detected.bomLength);
+    m_Encoding = detected.encoding;
+
+    if (m_Encoding != Utils::TextEncoding::Utf8) {
+      if (!Utils::TextEncodingUtils::ToUtf8(data, m_Encoding, m_Converted)) {
+        AF_WARN("Failed to convert {} from {}", path, Utils::TextEncodingUtils::GetName(m_Encoding));
+        return false;
+      }
+      data = m_Converted;
+      // The mapping is not needed anymore, the cues point into the converted text
+      m_File.Close();
+    }
+
+    m_Format = SubtitleParser::DetectFormat(path, data);
+    if (m_Format == SubtitleFormat::Unknown) {
+      AF_WARN("Unknown subtitle format: {}", path);
+      return false;
+    }
+
+    m_Cues = SubtitleParser::Parse(data, m_Format);
+    AF_DEBUG("Parsed {} cues from {} ({}, {})",
+             m_Cues.size(),
+             path,
+             SubtitleParser::GetName(m_Format),
+             Utils::TextEncodingUtils::GetName(m_Encoding));
+    return true;
+  }
+
+} // namespace Video2Card::Video
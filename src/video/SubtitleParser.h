@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/MappedFile.h"
+#include "utils/TextEncoding.h"
+
+namespace Video2Card::Video
+{
+
+  enum class SubtitleFormat
+  {
+    Unknown,
+    SubRip,
+    Ass, // Also SSA, the Dialogue lines are the same
+    WebVtt
+  };
+
+  /**
+   * A subtitle line as it appears in the file
+   */
+  struct ParsedCue
+  {
+    double start = 0.0; // Seconds
+    double end = 0.0;
+    // Slice of the parsed buffer with markup and the file's own line breaks (CRLF, or \N in ASS) still in it,
+    // see SubtitleParser::CleanText()
+    std::string_view text;
+  };
+
+  /**
+   * Parser for sidecar subtitle files
+   * Works on UTF-8 text in memory and never copies it: cues point into the buffer they were parsed from, and
+   * only the lines that are actually used need cleaning up into a string. Line breaks are found 64 bytes at a
+   * time with SSE2 where available.
+   */
+  class SubtitleParser
+  {
+public:
+
+    /**
+     * Tell the format from the file extension, or from the content if the extension is unknown
+     * @param path File name, only the extension is used
+     * @param data UTF-8 text without byte order mark
+     */
+    static SubtitleFormat DetectFormat(std::string_view path, std::string_view data);
+
+    /**
+     * Parse every cue in a buffer, in file order
+     * @param data UTF-8 text without byte order mark. Must outlive the returned cues.
+     */
+    static std::vector<ParsedCue> Parse(std::string_view data, SubtitleFormat format);
+
+    /**
+     * Plain text of a cue: tags removed, line breaks as \n, surrounding blank space trimmed
+     */
+    static std::string CleanText(std::string_view text, SubtitleFormat format);
+
+    static std::string_view GetName(SubtitleFormat format);
+  };
+
+  /**
+   * A subtitle file mapped into memory and parsed
+   * Files in UTF-16, Shift-JIS or Windows-1252 are converted to UTF-8 once, the cues then point into the
+   * converted copy instead of the mapping. Cues stay valid for the lifetime of the object, which is why it
+   * can't be copied or moved.
+   */
+  class SubtitleFile
+  {
+public:
+
+    SubtitleFile() = default;
+
+    SubtitleFile(const SubtitleFile&) = delete;
+    SubtitleFile& operator=(const SubtitleFile&) = delete;
+
+    /**
+     * Whether the file extension is one of the formats the parser reads
+     */
+    static bool IsSupported(std::string_view path);
+
+    /**
+     * Map and parse a file, replacing what was loaded before
+     * @return true if the file was read and its format recognized, even if it has no cues
+     */
+    bool Open(const std::string& path);
+
+    SubtitleFormat GetFormat() const { return m_Format; }
+    Utils::TextEncoding GetEncoding() const { return m_Encoding; }
+    const std::vector<ParsedCue>& GetCues() const { return m_Cues; }
+    std::string GetText(const ParsedCue& cue) const { return SubtitleParser::CleanText(cue.text, m_Format); }
+
+private:
+
+    Utils::MappedFile m_File;
+    std::string m_Converted;
+    SubtitleFormat m_Format = SubtitleFormat::Unknown;
+    Utils::TextEncoding m_Encoding = Utils::TextEncoding::Utf8;
+    std::vector<ParsedCue> m_Cues;
+  };
+
+} // namespace Video2Card::Video
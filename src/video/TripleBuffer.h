@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Video2Card::Video
+{
+
+  /**
+   * Lock-free single producer / single consumer triple buffer
+   * The producer always owns one slot to write into and the consumer one slot to read from. The third slot sits
+   * in the middle and is swapped atomically, so neither side ever waits for the other. The consumer always gets
+   * the newest published value; values published in between are dropped, not queued.
+   */
+  template <typename T>
+  class TripleBuffer
+  {
+public:
+
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * Producer side: slot to fill before calling Publish()
+     */
+    T& WriteBuffer() { return m_Buffers[m_WriteIndex]; }
+
+    /**
+     * Producer side: hand the write slot to the consumer and take the middle slot in exchange
+     */
+    void Publish()
+    {
+      uint8_t previous = m_Middle.exchange(m_WriteIndex | DIRTY_BIT, std::memory_order_acq_rel);
+      m_WriteIndex = previous & INDEX_MASK;
+    }
+
+    /**
+     * Consumer side: swap in the newest published slot
+     * @return true if a new value was published since the last call
+     */
+    bool Consume()
+    {
+      if (!(m_Middle.load(std::memory_order_relaxed) & DIRTY_BIT))
+        return false;
+
+      uint8_t previous = m_Middle.exchange(m_ReadIndex, std::memory_order_acq_rel);
+      m_ReadIndex = previous & INDEX_MASK;
+      return true;
+    }
+
+    /**
+     * Consumer side: slot returned by the last successful Consume()
+     */
+    const T& ReadBuffer() const { return m_Buffers[m_ReadIndex]; }
+
+private:
+
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t DIRTY_BIT = 0x4;
+
+    T m_Buffers[3]{};
+
+    alignas(64) uint8_t m_WriteIndex = 0;
+    alignas(64) std::atomic<uint8_t> m_Middle{1};
+    alignas(64) uint8_t m_ReadIndex = 2;
+  };
+
+} // namespace Video2Card::Video